@@ -246,6 +246,8 @@ void boot() {
     startHighPriorityThread();
     startLowPriorityThread();
 
+    psu::temperature::startThread();
+
     mp::initMessageQueue();
     mp::startThread();
 
@@ -32,6 +32,8 @@
 
 #include <eez/libs/sd_fat/sd_fat.h>
 
+#include <eez/modules/mcu/text_cache.h>
+
 #include <scpi/scpi.h>
 
 namespace eez {
@@ -298,6 +300,9 @@ bool loadExternalAssets(const char *filePath, int *err) {
 
     uint8_t *decompressedAssets = EXTERNAL_ASSETS_BUFFER;
 
+    // fonts from previously loaded external assets are about to be overwritten
+    mcu::display::text_cache::clear();
+
     int result = LZ4_decompress_safe((const char *)fileData + 4, (char *)decompressedAssets, compressedSize, (int)decompressedSize);
     if (result != (int)decompressedSize) {
         if (err) {
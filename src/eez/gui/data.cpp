@@ -305,6 +305,15 @@ void POINTER_value_to_text(const Value &value, char *text, int count) {
     text[0] = 0;
 }
 
+// pointer to Image, options is changed when pixels are changed
+bool compare_IMAGE_value(const Value &a, const Value &b) {
+    return a.getVoidPointer() == b.getVoidPointer() && a.getOptions() == b.getOptions();
+}
+
+void IMAGE_value_to_text(const Value &value, char *text, int count) {
+    text[0] = 0;
+}
+
 bool compare_TIME_SECONDS_value(const Value &a, const Value &b) {
     return a.getUInt32() == b.getUInt32();
 }
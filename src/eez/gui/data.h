@@ -153,6 +153,11 @@ struct Value {
     {
     }
 
+    Value(void *value, ValueType type, uint16_t options)
+        : type_(type), options_(options), unit_(UNIT_UNKNOWN), pVoid_(value)
+    {
+    }
+
     Value(AppContext *appContext) 
         : type_(VALUE_TYPE_POINTER), pVoid_(appContext) 
     {
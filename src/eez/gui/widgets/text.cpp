@@ -79,7 +79,11 @@ DrawFunctionType TEXT_draw = [](const WidgetCursor &widgetCursor) {
                 widgetCursor.currentState->flags.blinking,
                 ignoreLuminosity, &overrideColor, &overrideBackgroundColor, nullptr, nullptr);
         } else if (widget->data) {
-            if (widgetCursor.currentState->data.isString()) {
+            if (widgetCursor.currentState->data.getType() == VALUE_TYPE_IMAGE) {
+                drawRectangle(widgetCursor.x, widgetCursor.y, (int)widget->w, (int)widget->h, style, widgetCursor.currentState->flags.active, true, true);
+                auto image = (Image *)widgetCursor.currentState->data.getVoidPointer();
+                drawBitmap(image, widgetCursor.x, widgetCursor.y, (int)widget->w, (int)widget->h, style, widgetCursor.currentState->flags.active);
+            } else if (widgetCursor.currentState->data.isString()) {
                 if (widgetCursor.currentState->data.getOptions() & STRING_OPTIONS_FILE_ELLIPSIS) {
                     const char *fullText = widgetCursor.currentState->data.getString();
                     int fullTextLength = strlen(fullText);
@@ -107,6 +107,35 @@ struct YTGraphDrawHelper {
         return widget->h - 1 - y;
     }
 
+    // min/max of the values in the sample period, if provided by the value function
+    void drawEnvelope(int valueIndex) {
+        if (position >= numPositions) {
+            return;
+        }
+
+        float fMax = NAN;
+        float fMin = ytDataGetValue(position, valueIndex, &fMax);
+
+        if (isNaN(fMin) || isNaN(fMax)) {
+            return;
+        }
+
+        int yMin = (int)round((widget->h - 1) * (fMin - min[valueIndex]) / (max[valueIndex] - min[valueIndex]));
+        int yMax = (int)round((widget->h - 1) * (fMax - min[valueIndex]) / (max[valueIndex] - min[valueIndex]));
+
+        if (yMin < 0) {
+            yMin = 0;
+        }
+        if (yMax >= widget->h) {
+            yMax = widget->h - 1;
+        }
+
+        if (yMax - yMin > 1) {
+            display::setColor16(dataColor16[valueIndex]);
+            display::drawVLine(x, widgetCursor.y + widget->h - 1 - yMax, yMax - yMin);
+        }
+    }
+
     void drawValue(int valueIndex) {
         if (y[valueIndex] == INT_MIN) {
             return;
@@ -126,6 +155,9 @@ struct YTGraphDrawHelper {
     }
 
     void drawStep() {
+        drawEnvelope(0);
+        drawEnvelope(1);
+
         if (y[0] != INT_MIN && y[1] != INT_MIN && abs(yPrev[0] - y[0]) <= 1 && abs(yPrev[1] - y[1]) <= 1 && y[0] == y[1]) {
             display::setColor16(position % 2 ? dataColor16[1] : dataColor16[0]);
             display::drawPixel(x, widgetCursor.y + y[0]);
@@ -0,0 +1,158 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+
+#include <eez/memory.h>
+#include <eez/util.h>
+#define LZ4_STATIC_LINKING_ONLY
+#include <eez/libs/lz4/lz4.h>
+#include <eez/libs/image/delta.h>
+
+static const int FRAME_WIDTH = 480;
+static const int FRAME_HEIGHT = 272;
+
+static const int TILE_WIDTH = 32;
+static const int TILE_HEIGHT = 32;
+
+static const int NUM_TILE_COLUMNS = (FRAME_WIDTH + TILE_WIDTH - 1) / TILE_WIDTH;
+static const int NUM_TILE_ROWS = (FRAME_HEIGHT + TILE_HEIGHT - 1) / TILE_HEIGHT;
+
+struct FrameHeader {
+    uint32_t sequence;
+    uint32_t baseSequence;
+    uint16_t frameWidth;
+    uint16_t frameHeight;
+    uint8_t tileWidth;
+    uint8_t tileHeight;
+    uint16_t numTiles;
+};
+
+struct TileHeader {
+    uint16_t tileIndex;
+    uint16_t dataSize;
+};
+
+static const uint32_t FRAME_SIZE = FRAME_WIDTH * FRAME_HEIGHT * 2;
+static const uint32_t TILE_SIZE = TILE_WIDTH * TILE_HEIGHT * 2;
+// rounded up to keep LZ4 state aligned
+static const uint32_t TILE_HASHES_SIZE = (NUM_TILE_COLUMNS * NUM_TILE_ROWS * 4 + 7) / 8 * 8;
+
+// Hash of each tile as it was last sent is kept instead of the whole reference frame.
+static uint32_t * const g_tileHashes = (uint32_t *)SCREEN_STREAM_MEMORY;
+static uint16_t * const g_tilePixels = (uint16_t *)(SCREEN_STREAM_MEMORY + TILE_HASHES_SIZE);
+static void * const g_lz4State = SCREEN_STREAM_MEMORY + TILE_HASHES_SIZE + TILE_SIZE;
+
+static_assert(TILE_HASHES_SIZE + TILE_SIZE + LZ4_STREAMSIZE <= SCREEN_STREAM_MEMORY_SIZE, "SCREEN_STREAM_MEMORY_SIZE too small");
+
+// tiles which can't be compressed are stored as is, so all tiles always fit
+static_assert(
+    sizeof(FrameHeader) + NUM_TILE_COLUMNS * NUM_TILE_ROWS * sizeof(TileHeader) + FRAME_SIZE <= VRAM_SCREENSHOOT_JPEG_OUT_BUFFER_SIZE,
+    "VRAM_SCREENSHOOT_JPEG_OUT_BUFFER_SIZE too small"
+);
+
+// 0 means nothing is sent yet, so tile hashes are not valid
+static uint32_t g_sequence;
+
+// FNV-1a, software only because CRC peripheral is used from other threads
+static uint32_t getTileHash(const uint16_t *pixels, int numPixels) {
+    uint32_t hash = 2166136261u;
+    for (int i = 0; i < numPixels; i++) {
+        hash = (hash ^ pixels[i]) * 16777619u;
+    }
+    return hash;
+}
+
+int deltaEncode(const uint16_t *framePixels, bool keyframe, unsigned char **imageData, size_t *imageDataSize) {
+    if (g_sequence == 0) {
+        keyframe = true;
+    }
+
+    FrameHeader frameHeader;
+    frameHeader.baseSequence = keyframe ? 0 : g_sequence;
+    frameHeader.frameWidth = FRAME_WIDTH;
+    frameHeader.frameHeight = FRAME_HEIGHT;
+    frameHeader.tileWidth = TILE_WIDTH;
+    frameHeader.tileHeight = TILE_HEIGHT;
+    frameHeader.numTiles = 0;
+
+    uint8_t *out = VRAM_SCREENSHOOT_JPEG_OUT_BUFFER + sizeof(FrameHeader);
+
+    // full reset once per frame, fast reset for each tile
+    LZ4_resetStream((LZ4_stream_t *)g_lz4State);
+
+    for (int row = 0; row < NUM_TILE_ROWS; row++) {
+        int y = row * TILE_HEIGHT;
+        int height = MIN(TILE_HEIGHT, FRAME_HEIGHT - y);
+
+        for (int column = 0; column < NUM_TILE_COLUMNS; column++) {
+            int x = column * TILE_WIDTH;
+            int width = MIN(TILE_WIDTH, FRAME_WIDTH - x);
+
+            // gather tile pixels
+            for (int i = 0; i < height; i++) {
+                int offset = (y + i) * FRAME_WIDTH + x;
+                memcpy(g_tilePixels + i * width, framePixels + offset, width * 2);
+            }
+
+            int tileIndex = row * NUM_TILE_COLUMNS + column;
+
+            uint32_t tileHash = getTileHash(g_tilePixels, width * height);
+            if (!keyframe && tileHash == g_tileHashes[tileIndex]) {
+                continue;
+            }
+            g_tileHashes[tileIndex] = tileHash;
+
+            int tileSize = width * height * 2;
+
+            TileHeader tileHeader;
+            tileHeader.tileIndex = (uint16_t)tileIndex;
+
+            uint8_t *data = out + sizeof(TileHeader);
+
+            int compressedSize = LZ4_compress_fast_extState_fastReset(g_lz4State, (const char *)g_tilePixels, (char *)data, tileSize, tileSize - 1, 1);
+            if (compressedSize > 0) {
+                tileHeader.dataSize = (uint16_t)compressedSize;
+                out = data + compressedSize;
+            } else {
+                // state is undefined after failed compression
+                LZ4_resetStream((LZ4_stream_t *)g_lz4State);
+
+                tileHeader.dataSize = 0;
+                memcpy(data, g_tilePixels, tileSize);
+                out = data + tileSize;
+            }
+
+            memcpy(data - sizeof(TileHeader), &tileHeader, sizeof(TileHeader));
+
+            frameHeader.numTiles++;
+        }
+    }
+
+    if (++g_sequence == 0) {
+        g_sequence = 1;
+    }
+    frameHeader.sequence = g_sequence;
+
+    memcpy(VRAM_SCREENSHOOT_JPEG_OUT_BUFFER, &frameHeader, sizeof(FrameHeader));
+
+    *imageData = VRAM_SCREENSHOOT_JPEG_OUT_BUFFER;
+    *imageDataSize = out - VRAM_SCREENSHOOT_JPEG_OUT_BUFFER;
+
+    return 0;
+}
@@ -0,0 +1,43 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stddef.h>
+#include <stdint.h>
+
+// Encodes 480x272 RGB565 frame as the list of tiles changed since the previously
+// encoded frame. All values are little-endian:
+//
+//   uint32_t sequence       // sequence number of this frame, never 0
+//   uint32_t baseSequence   // frame this delta applies to, 0 for keyframe
+//   uint16_t frameWidth
+//   uint16_t frameHeight
+//   uint8_t  tileWidth
+//   uint8_t  tileHeight
+//   uint16_t numTiles
+//
+// followed by numTiles of:
+//
+//   uint16_t tileIndex      // row * ceil(frameWidth / tileWidth) + column
+//   uint16_t dataSize       // LZ4 block size, 0 if pixels are stored uncompressed
+//   uint8_t  data[]         // RGB565 pixels of the tile, clipped at the frame edge
+//
+// Client should request keyframe if baseSequence doesn't match the sequence
+// of the last frame it received. Keyframe is also sent if there is no previous frame.
+int deltaEncode(const uint16_t *framePixels, bool keyframe, unsigned char **imageData, size_t *imageDataSize);
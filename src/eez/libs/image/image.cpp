@@ -22,9 +22,74 @@
 #include <eez/libs/image/bitmap.h>
 #include <eez/libs/image/jpeg.h>
 
-bool imageDecode(const char *filePath, Image *image) {
+bool imageDecode(const char *filePath, Image *image, int scale) {
+    bool result;
     if (eez::endsWithNoCase(filePath, ".bmp")) {
-        return bitmapDecode(filePath, image);
+        result = bitmapDecode(filePath, image);
+    } else {
+        result = jpegDecode(filePath, image);
     }
-    return jpegDecode(filePath, image);
+
+    if (result && scale > 1) {
+        imageScaleDown(image, scale);
+    }
+
+    return result;
+}
+
+static inline void getPixel(const Image *image, const uint8_t *p, uint32_t &r, uint32_t &g, uint32_t &b) {
+    if (image->bpp == 16) {
+        uint16_t color = *(const uint16_t *)p;
+        r = (color >> 8) & 0xF8;
+        g = (color >> 3) & 0xFC;
+        b = (color << 3) & 0xF8;
+    } else {
+        // 24 bpp is R, G, B and 32 bpp is B, G, R, A
+        r = image->bpp == 24 ? p[0] : p[2];
+        g = p[1];
+        b = image->bpp == 24 ? p[2] : p[0];
+    }
+}
+
+void imageScaleDown(Image *image, int scale) {
+    uint32_t bytesPerPixel = image->bpp / 8;
+    uint32_t srcLineBytes = (image->width + image->lineOffset) * bytesPerPixel;
+
+    uint32_t width = image->width / scale;
+    uint32_t height = image->height / scale;
+    uint32_t n = scale * scale;
+
+    // destination pixel is never after any of its source pixels, so this can be done in place
+    uint16_t *dst = (uint16_t *)image->pixels;
+
+    for (uint32_t y = 0; y < height; y++) {
+        const uint8_t *srcLine = image->pixels + y * scale * srcLineBytes;
+
+        for (uint32_t x = 0; x < width; x++) {
+            uint32_t rSum = 0;
+            uint32_t gSum = 0;
+            uint32_t bSum = 0;
+
+            for (int i = 0; i < scale; i++) {
+                const uint8_t *src = srcLine + i * srcLineBytes + x * scale * bytesPerPixel;
+                for (int j = 0; j < scale; j++, src += bytesPerPixel) {
+                    uint32_t r, g, b;
+                    getPixel(image, src, r, g, b);
+                    rSum += r;
+                    gSum += g;
+                    bSum += b;
+                }
+            }
+
+            uint32_t r = rSum / n;
+            uint32_t g = gSum / n;
+            uint32_t b = bSum / n;
+            *dst++ = (uint16_t)(((r & 0xF8) << 8) | ((g & 0xFC) << 3) | (b >> 3));
+        }
+    }
+
+    image->width = width;
+    image->height = height;
+    image->bpp = 16;
+    image->lineOffset = 0;
 }
\ No newline at end of file
@@ -28,4 +28,11 @@ struct Image {
     uint8_t *pixels;
 };
 
-bool imageDecode(const char *filePath, Image *image);
\ No newline at end of file
+// Decoded image is in FILE_VIEW_BUFFER.
+// If scale is 2, 4 or 8, image is scaled down to 1/scale size and converted to RGB565.
+bool imageDecode(const char *filePath, Image *image, int scale = 1);
+
+// Scales image down to 1/scale size (each pixel is average of scale x scale block),
+// result is RGB565 image stored in place, at the start of the same pixels buffer.
+// With scale 1 image is only converted to RGB565.
+void imageScaleDown(Image *image, int scale);
\ No newline at end of file
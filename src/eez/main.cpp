@@ -48,6 +48,7 @@
 #include <eez/modules/mcu/encoder.h>
 
 #include <eez/modules/psu/psu.h>
+#include <eez/modules/psu/io_pins.h>
 #include <eez/modules/psu/serial_psu.h>
 #include <eez/modules/psu/sd_card.h>
 
@@ -226,6 +227,16 @@ extern "C" void HAL_GPIO_EXTI_Callback(uint16_t GPIO_Pin) {
     else if (GPIO_Pin == ENC_A_Pin || GPIO_Pin == ENC_B_Pin) {
         eez::mcu::encoder::onPinInterrupt();
     }
+
+#ifdef MASTER_MCU_REVISION_R3B3_OR_NEWER
+    else if (GPIO_Pin == UART_RX_DIN1_Pin) {
+        eez::psu::io_pins::onInputPinInterrupt(0);
+    }
+#endif
+
+    else if (GPIO_Pin == DIN2_Pin) {
+        eez::psu::io_pins::onInputPinInterrupt(1);
+    }
 }
 #endif
 
@@ -234,12 +245,25 @@ void consoleInputTask(const void *) {
     using namespace eez;
     sendMessageToLowPriorityThread(SERIAL_LINE_STATE_CHANGED, 1);
 
+    // input is passed line by line (or in full buffers) instead of char by char
+    uint8_t buffer[256];
+    uint32_t length = 0;
+
     while (1) {
         int ch = getchar();
         if (ch == EOF) {
             break;
         }
-        Serial.put(ch);
+
+        buffer[length++] = (uint8_t)ch;
+        if (ch == '\n' || length == sizeof(buffer)) {
+            Serial.put(buffer, length);
+            length = 0;
+        }
+    }
+
+    if (length > 0) {
+        Serial.put(buffer, length);
     }
 }
 #endif
@@ -250,8 +274,8 @@ void consoleInputTask(const void *) {
 #include <eez/modules/psu/psu.h>
 #include <eez/modules/psu/serial_psu.h>
 
-void eez_serial_put(int ch) {
-    Serial.put(ch);
+void eez_serial_put(const uint8_t *buffer, uint32_t length) {
+    Serial.put(buffer, length);
 }
 
 extern void eez_system_tick();
@@ -286,12 +310,21 @@ void mainLoop() {
         } else {
             eez_system_tick();
 
+            uint8_t buffer[256];
+            uint32_t length = 0;
             while (1) {
                 int ch = getchar();
                 if (ch == 0 || ch == EOF) {
                     break;
                 }
-                eez_serial_put(ch);
+                buffer[length++] = (uint8_t)ch;
+                if (length == sizeof(buffer)) {
+                    eez_serial_put(buffer, length);
+                    length = 0;
+                }
+            }
+            if (length > 0) {
+                eez_serial_put(buffer, length);
             }
 
             // clang-format off
@@ -66,10 +66,41 @@ static const uint32_t SOUND_TUNES_MEMORY_SIZE = 32 * 1024;
 static uint8_t * const FILE_MANAGER_MEMORY = SOUND_TUNES_MEMORY + SOUND_TUNES_MEMORY_SIZE;
 static const uint32_t FILE_MANAGER_MEMORY_SIZE = 512 * 1024;
 
-static uint8_t * const VRAM_SCREENSHOOT_JPEG_OUT_BUFFER = FILE_MANAGER_MEMORY + FILE_MANAGER_MEMORY_SIZE;
+// catalogs of previously visited directories, catalog of a typical directory is a few KB
+static uint8_t * const CATALOG_CACHE_MEMORY = FILE_MANAGER_MEMORY + FILE_MANAGER_MEMORY_SIZE;
+static const uint32_t CATALOG_CACHE_MEMORY_SIZE = 64 * 1024;
+
+// file manager thumbnails
+static uint8_t * const THUMBNAIL_CACHE_MEMORY = CATALOG_CACHE_MEMORY + CATALOG_CACHE_MEMORY_SIZE;
+static const uint32_t THUMBNAIL_CACHE_MEMORY_SIZE = 80 * 1024;
+
+// multi-resolution U/I history of all channels
+static uint8_t * const CHANNEL_HISTORY_MEMORY = THUMBNAIL_CACHE_MEMORY + THUMBNAIL_CACHE_MEMORY_SIZE;
+static const uint32_t CHANNEL_HISTORY_MEMORY_SIZE = 432 * 1024;
+
+static uint8_t * const TEXT_CACHE_MEMORY = CHANNEL_HISTORY_MEMORY + CHANNEL_HISTORY_MEMORY_SIZE;
+static const uint32_t TEXT_CACHE_MEMORY_SIZE = 256 * 1024;
+
+static uint8_t * const VRAM_SCREENSHOOT_JPEG_OUT_BUFFER = TEXT_CACHE_MEMORY + TEXT_CACHE_MEMORY_SIZE;
 static const uint32_t VRAM_SCREENSHOOT_JPEG_OUT_BUFFER_SIZE = 256 * 1024;
 
-static uint8_t * const SCREENSHOOT_BUFFER_START_ADDRESS = VRAM_SCREENSHOOT_JPEG_OUT_BUFFER + VRAM_SCREENSHOOT_JPEG_OUT_BUFFER_SIZE;
+// tile hashes and work memory for DISPlay:DATA:DELTa?
+static uint8_t * const SCREEN_STREAM_MEMORY = VRAM_SCREENSHOOT_JPEG_OUT_BUFFER + VRAM_SCREENSHOOT_JPEG_OUT_BUFFER_SIZE;
+static const uint32_t SCREEN_STREAM_MEMORY_SIZE = 32 * 1024;
+
+// MQTT publications waiting for the broker to become reachable, older ones are spilled to the SD card
+static uint8_t * const MQTT_OFFLINE_BUFFER = SCREEN_STREAM_MEMORY + SCREEN_STREAM_MEMORY_SIZE;
+static const uint32_t MQTT_OFFLINE_BUFFER_SIZE = 32 * 1024;
+
+// list values prepared for hardware timed list execution
+static uint8_t * const LIST_STAGED_STEPS_MEMORY = MQTT_OFFLINE_BUFFER + MQTT_OFFLINE_BUFFER_SIZE;
+static const uint32_t LIST_STAGED_STEPS_MEMORY_SIZE = 24 * 1024;
+
+// dlog to CSV export buffers
+static uint8_t * const DLOG_EXPORT_MEMORY = LIST_STAGED_STEPS_MEMORY + LIST_STAGED_STEPS_MEMORY_SIZE;
+static const uint32_t DLOG_EXPORT_MEMORY_SIZE = 64 * 1024;
+
+static uint8_t * const SCREENSHOOT_BUFFER_START_ADDRESS = DLOG_EXPORT_MEMORY + DLOG_EXPORT_MEMORY_SIZE;
 static const uint32_t SCREENSHOOT_BUFFER_SIZE = 480 * 272 * 3;
 
 #if defined(EEZ_PLATFORM_STM32)
@@ -30,6 +30,7 @@
 #include <eez/modules/dib-dcp405/dib-dcp405.h>
 
 #include <eez/system.h>
+#include <eez/tasks.h>
 
 #if defined(EEZ_PLATFORM_STM32)
 #include <i2c.h>
@@ -59,6 +60,8 @@ static double g_pidDuty;
 static double g_pidTarget = FAN_MIN_TEMP;
 static PID g_fanPID(&g_pidTemp, &g_pidDuty, &g_pidTarget, FAN_PID_KP, FAN_PID_KI_MIN, FAN_PID_KD, FAN_PID_POn, REVERSE);
 
+static float g_auxTemperature = NAN;
+
 int g_rpm = 0;
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -521,6 +524,12 @@ int updateFanSpeed() {
 
 void tick(uint32_t tickCount) {
 #if defined(EEZ_PLATFORM_STM32)
+    if (!isPsuThread()) {
+        // MAX31760 shares I2C bus with the other devices accessed from the PSU thread
+        sendMessageToPsu(PSU_MESSAGE_FAN_TICK, tickCount);
+        return;
+    }
+
     if (g_testResult == TEST_NONE) {
     	// still testing
     	checkTest();
@@ -578,12 +587,18 @@ void setPidTunings(double Kp, double Ki, double Kd, int POn) {
 
 float readTemperature() {
 #if defined(EEZ_PLATFORM_STM32)
-	float temperature;
-	if (readLocalTemp(&temperature) == HAL_OK) {
-		return roundPrec(temperature, 1.0f);
+	if (!isPsuThread()) {
+		sendMessageToPsu(PSU_MESSAGE_READ_AUX_TEMPERATURE);
+	} else {
+		float temperature;
+		if (readLocalTemp(&temperature) == HAL_OK) {
+			g_auxTemperature = roundPrec(temperature, 1.0f);
+		} else {
+			g_auxTemperature = NAN;
+		}
 	}
 #endif
-	return NAN;
+	return g_auxTemperature;
 }
 
 } // namespace fan
@@ -110,12 +110,7 @@ TransferResult transfer(int slotIndex, uint8_t *output, uint8_t *input, uint32_t
             return (TransferResult)result;
         }
     } else {
-        if (result == HAL_OK) {
-            uint32_t crc = HAL_CRC_Calculate(&hcrc, (uint32_t *)input, bufferSize - 4);
-            return crc == *((uint32_t *)(input + bufferSize - 4)) ? TRANSFER_STATUS_OK : TRANSFER_STATUS_CRC_ERROR;
-        } else {
-            return (TransferResult)result;
-        }
+        return checkCrc(slotIndex, input, bufferSize, (TransferResult)result);
     }
 #endif
 
@@ -130,6 +125,10 @@ TransferResult transferDMA(int slotIndex, uint8_t *output, uint8_t *input, uint3
 
     spi::select(slotIndex, spi::CHIP_SLAVE_MCU);
     auto result = spi::transferDMA(slotIndex, output, input, bufferSize);
+    if (result != HAL_OK) {
+        // transfer is not started, so completion callback will not deselect
+        spi::deselect(slotIndex);
+    }
     return (TransferResult)result;
 #endif
 
@@ -138,6 +137,19 @@ TransferResult transferDMA(int slotIndex, uint8_t *output, uint8_t *input, uint3
 #endif
 }
 
+TransferResult checkCrc(int slotIndex, uint8_t *input, uint32_t bufferSize, TransferResult status) {
+#if defined(EEZ_PLATFORM_STM32)
+    if (status == TRANSFER_STATUS_OK && !g_slots[slotIndex]->spiCrcCalculationEnable) {
+        uint32_t crc = HAL_CRC_Calculate(&hcrc, (uint32_t *)input, bufferSize - 4);
+        if (crc != *((uint32_t *)(input + bufferSize - 4))) {
+            return TRANSFER_STATUS_CRC_ERROR;
+        }
+    }
+#endif
+
+    return status;
+}
+
 } // namespace comm
 } // namespace bp3c
 } // namespace eez
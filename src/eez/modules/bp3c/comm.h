@@ -37,6 +37,10 @@ enum TransferResult {
 TransferResult transfer(int slotIndex, uint8_t *output, uint8_t *input, uint32_t bufferSize);
 TransferResult transferDMA(int slotIndex, uint8_t *output, uint8_t *input, uint32_t bufferSize);
 
+// Checks software CRC, used when hardware CRC calculation is disabled, of the received data.
+// DMA transfer completion doesn't check it, so call this from the thread context with the completion status.
+TransferResult checkCrc(int slotIndex, uint8_t *input, uint32_t bufferSize, TransferResult status);
+
 } // namespace comm
 } // namespace bp3c
 } // namespace eez
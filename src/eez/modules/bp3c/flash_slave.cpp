@@ -55,9 +55,11 @@ namespace flash_slave {
 bool g_bootloaderMode = false;
 static int g_slotIndex;
 static char g_hexFilePath[MAX_PATH_LENGTH + 1];
+static bool g_skipIfIdentical;
 
 #ifdef EEZ_PLATFORM_STM32
 
+static const uint8_t CMD_READ_MEMORY = 0x11;
 static const uint8_t CMD_WRITE_MEMORY = 0x31;
 static const uint8_t CMD_EXTENDED_ERASE = 0x44;
 static const uint8_t ENTER_BOOTLOADER = 0x7F;
@@ -215,17 +217,118 @@ bool eraseAll(int slotIndex) {
 #endif
 }
 
-bool writeMemory(int slotIndex, uint32_t address, const uint8_t *buffer, uint32_t bufferSize) {
-	assert(bufferSize <= 256);
-
 #if defined(EEZ_PLATFORM_STM32)
-	uint8_t addressAndCrc[5] = {
-		(uint8_t)(address >> 24),
-		(uint8_t)((address >> 16) & 0xFF),
-		(uint8_t)((address >> 8) & 0xFF),
-		(uint8_t)(address & 0xFF)
-	};
+static void getAddressAndCrc(uint32_t address, uint8_t *addressAndCrc) {
+	addressAndCrc[0] = (uint8_t)(address >> 24);
+	addressAndCrc[1] = (uint8_t)((address >> 16) & 0xFF);
+	addressAndCrc[2] = (uint8_t)((address >> 8) & 0xFF);
+	addressAndCrc[3] = (uint8_t)(address & 0xFF);
 	addressAndCrc[4] = addressAndCrc[0] ^ addressAndCrc[1] ^ addressAndCrc[2] ^ addressAndCrc[3];
+}
+#endif
+
+bool readMemory(int slotIndex, uint32_t address, uint8_t *buffer, uint32_t bufferSize) {
+	assert(bufferSize > 0 && bufferSize <= 256);
+
+#if defined(EEZ_PLATFORM_STM32)
+	uint8_t addressAndCrc[5];
+	getAddressAndCrc(address, addressAndCrc);
+
+	uint8_t numBytesAndCrc[2];
+	numBytesAndCrc[0] = (uint8_t)(bufferSize - 1);
+	numBytesAndCrc[1] = CRC_MASK ^ numBytesAndCrc[0];
+
+	if (g_slots[slotIndex]->flashMethod == FLASH_METHOD_STM32_BOOTLOADER_SPI) {
+		uint8_t txData[3];
+
+		txData[0] = BL_SPI_SOF;
+		txData[1] = CMD_READ_MEMORY;
+		txData[2] = CRC_MASK ^ CMD_READ_MEMORY;
+
+		spi::select(slotIndex, spi::CHIP_SLAVE_MCU_NO_CRC);
+		spi::transmit(slotIndex, txData, 3);
+		spi::deselect(slotIndex);
+
+		if (!waitForAck(slotIndex)) {
+			return false;
+		}
+
+		spi::select(slotIndex, spi::CHIP_SLAVE_MCU_NO_CRC);
+		spi::transmit(slotIndex, addressAndCrc, 5);
+		spi::deselect(slotIndex);
+
+		if (!waitForAck(slotIndex)) {
+			return false;
+		}
+
+		spi::select(slotIndex, spi::CHIP_SLAVE_MCU_NO_CRC);
+		spi::transmit(slotIndex, numBytesAndCrc, 2);
+		spi::deselect(slotIndex);
+
+		if (!waitForAck(slotIndex)) {
+			return false;
+		}
+
+		// dummy byte followed by data
+		uint8_t dummy = 0;
+		memset(buffer, 0, bufferSize);
+
+		spi::select(slotIndex, spi::CHIP_SLAVE_MCU_NO_CRC);
+		spi::transfer1(slotIndex, &dummy, &dummy);
+		HAL_StatusTypeDef result = spi::transfer(slotIndex, buffer, buffer, (uint16_t)bufferSize);
+		spi::deselect(slotIndex);
+
+		return result == HAL_OK;
+	} else {
+		taskENTER_CRITICAL();
+
+		sendDataAndCRC(CMD_READ_MEMORY);
+
+		uint8_t rxData[1];
+		HAL_StatusTypeDef result = HAL_UART_Receive(phuart, rxData, 1, CMD_TIMEOUT);
+		if (result != HAL_OK || rxData[0] != ACK) {
+			taskEXIT_CRITICAL();
+			return false;
+		}
+
+		HAL_UART_Transmit(phuart, addressAndCrc, 5, 20);
+
+		result = HAL_UART_Receive(phuart, rxData, 1, CMD_TIMEOUT);
+		if (result != HAL_OK || rxData[0] != ACK) {
+			taskEXIT_CRITICAL();
+			return false;
+		}
+
+		HAL_UART_Transmit(phuart, numBytesAndCrc, 2, 20);
+
+		result = HAL_UART_Receive(phuart, rxData, 1, CMD_TIMEOUT);
+		if (result != HAL_OK || rxData[0] != ACK) {
+			taskEXIT_CRITICAL();
+			return false;
+		}
+
+		result = HAL_UART_Receive(phuart, buffer, bufferSize, CMD_TIMEOUT);
+
+		taskEXIT_CRITICAL();
+		return result == HAL_OK;
+	}
+#endif
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+	// there is no slave flash in simulator to compare with
+    return false;
+#endif
+}
+
+// Sends write memory command and data, but doesn't wait for the final ACK
+// which arrives after the slave has programmed the flash. Caller can prepare
+// the next page in the meantime and then call endWriteMemory.
+bool beginWriteMemory(int slotIndex, uint32_t address, const uint8_t *buffer, uint32_t bufferSize) {
+	assert(bufferSize > 0 && bufferSize <= 256);
+
+#if defined(EEZ_PLATFORM_STM32)
+	uint8_t addressAndCrc[5];
+	getAddressAndCrc(address, addressAndCrc);
 
 	uint8_t numBytes = (uint8_t)(bufferSize - 1);
 
@@ -263,7 +366,7 @@ bool writeMemory(int slotIndex, uint32_t address, const uint8_t *buffer, uint32_
 		spi::transmit(slotIndex, &crc, 1);
 		spi::deselect(slotIndex);
 
-		return waitForAck(slotIndex);
+		return true;
 	} else {
 		taskENTER_CRITICAL();
 
@@ -288,17 +391,29 @@ bool writeMemory(int slotIndex, uint32_t address, const uint8_t *buffer, uint32_
 		HAL_UART_Transmit(phuart, (uint8_t *)buffer, bufferSize, 20);
 		HAL_UART_Transmit(phuart, &crc, 1, 20);
 
-		result = HAL_UART_Receive(phuart, rxData, 1, CMD_TIMEOUT);
-		if (result != HAL_OK || rxData[0] != ACK) {
-			taskEXIT_CRITICAL();
-			return false;
-		}
-
 		taskEXIT_CRITICAL();
 		return true;
 	}
 #endif
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+    return true;
+#endif
+}
+
+bool endWriteMemory(int slotIndex) {
+#if defined(EEZ_PLATFORM_STM32)
+	if (g_slots[slotIndex]->flashMethod == FLASH_METHOD_STM32_BOOTLOADER_SPI) {
+		return waitForAck(slotIndex);
+	} else {
+		taskENTER_CRITICAL();
+		uint8_t rxData[1];
+		HAL_StatusTypeDef result = HAL_UART_Receive(phuart, rxData, 1, CMD_TIMEOUT);
+		taskEXIT_CRITICAL();
+		return result == HAL_OK && rxData[0] == ACK;
+	}
+#endif
+
 #if defined(EEZ_PLATFORM_SIMULATOR)
     osDelay(1);
     return true;
@@ -445,6 +560,114 @@ bool readHexRecord(psu::sd_card::BufferedFileRead &file, HexRecord &hexRecord) {
 	return true;
 }
 
+// Data records (usually 16 bytes each) are collected into pages of this size,
+// so bootloader write command is issued once per page instead of once per record.
+static const uint32_t PAGE_SIZE = 256;
+
+struct Page {
+	uint32_t address;
+	uint32_t size;
+	uint8_t data[PAGE_SIZE];
+};
+
+struct HexFileReader {
+	File file;
+	psu::sd_card::BufferedFileRead bufferedFile;
+	HexRecord hexRecord;
+	bool recordPending;
+	uint32_t recordOffset;
+	uint32_t addressUpperBits;
+	bool eofReached;
+
+	HexFileReader() : bufferedFile(file), recordPending(false), recordOffset(0), addressUpperBits(0), eofReached(false) {
+	}
+
+	bool open(const char *filePath) {
+		return file.open(filePath, FILE_OPEN_EXISTING | FILE_READ);
+	}
+
+	void close() {
+		file.close();
+	}
+
+	// Reads next page of contiguous data not crossing PAGE_SIZE boundary.
+	// Returns false when there is no more data, check eofReached to see if whole file is read.
+	bool readPage(Page &page) {
+		page.size = 0;
+
+		while (true) {
+			if (!recordPending) {
+				if (eofReached || !readHexRecord(bufferedFile, hexRecord)) {
+					return page.size > 0;
+				}
+
+				if (hexRecord.recordType == 0x04) {
+					addressUpperBits = ((hexRecord.data[0] << 8) + hexRecord.data[1]) << 16;
+				} else if (hexRecord.recordType == 0x00 && hexRecord.recordLength > 0) {
+					recordPending = true;
+					recordOffset = 0;
+				} else if (hexRecord.recordType == 0x01) {
+					eofReached = true;
+				}
+
+				continue;
+			}
+
+			uint32_t address = (addressUpperBits | hexRecord.address) + recordOffset;
+
+			if (page.size == 0) {
+				page.address = address;
+			} else if (address != page.address + page.size) {
+				return true;
+			}
+
+			uint32_t pageEnd = (page.address & ~(PAGE_SIZE - 1)) + PAGE_SIZE;
+			uint32_t n = MIN(hexRecord.recordLength - recordOffset, pageEnd - address);
+			if (n == 0) {
+				return true;
+			}
+
+			memcpy(page.data + page.size, hexRecord.data + recordOffset, n);
+			page.size += n;
+
+			recordOffset += n;
+			if (recordOffset == hexRecord.recordLength) {
+				recordPending = false;
+			}
+		}
+	}
+};
+
+// Compares CRC of each page from the hex file with CRC of the same memory
+// range read back from the slave MCU.
+static bool isFirmwareIdentical(int slotIndex, const char *hexFilePath) {
+	HexFileReader reader;
+	if (!reader.open(hexFilePath)) {
+		return false;
+	}
+
+	static Page page;
+	static uint8_t slaveData[PAGE_SIZE];
+
+	bool identical = true;
+
+	while (reader.readPage(page)) {
+		if (!readMemory(slotIndex, page.address, slaveData, page.size)) {
+			identical = false;
+			break;
+		}
+
+		if (crc32(page.data, page.size) != crc32(slaveData, page.size)) {
+			identical = false;
+			break;
+		}
+	}
+
+	reader.close();
+
+	return identical && reader.eofReached;
+}
+
 void doStart() {
 #if OPTION_DISPLAY
 	psu::gui::showAsyncOperationInProgress("Preparing...");
@@ -457,9 +680,10 @@ void doStart() {
 	sendMessageToLowPriorityThread(THREAD_MESSAGE_FLASH_SLAVE_UPLOAD_HEX_FILE);
 }
 
-void start(int slotIndex, const char *hexFilePath) {
+void start(int slotIndex, const char *hexFilePath, bool skipIfIdentical) {
 	g_slotIndex = slotIndex;
 	strcpy(g_hexFilePath, hexFilePath);
+	g_skipIfIdentical = skipIfIdentical;
 
 	if (isPsuThread()) {
 		doStart();
@@ -472,18 +696,26 @@ void uploadHexFile() {
 	bool dowloadStarted = false;
 	if (syncWithSlave(g_slotIndex)) {
 		bool eofReached = false;
-	    File file;
-	    psu::sd_card::BufferedFileRead bufferedFile(file);
+		HexFileReader reader;
 	    size_t totalSize = 0;
-		HexRecord hexRecord;
-		uint32_t addressUpperBits = 0;
+
+		// next page is read from the file while the slave is still programming the previous one
+		static Page page;
+		bool writePending = false;
+		bool writeFailed = false;
+
+		if (g_skipIfIdentical && isFirmwareIdentical(g_slotIndex, g_hexFilePath)) {
+			DebugTrace("Firmware is already installed, flashing skipped\n");
+			eofReached = true;
+			goto Exit;
+		}
 
 	    if (!eraseAll(g_slotIndex)) {
 			DebugTrace("Failed to erase all!\n");
 			goto Exit;
 		}
 
-	    if (!file.open(g_hexFilePath, FILE_OPEN_EXISTING | FILE_READ)) {
+	    if (!reader.open(g_hexFilePath)) {
 			DebugTrace("Can't open firmware hex file!\n");
 			goto Exit;
 	    }
@@ -497,30 +729,39 @@ void uploadHexFile() {
 #endif
 
 	#if OPTION_DISPLAY
-	    totalSize = file.size();
+	    totalSize = reader.file.size();
 	#endif
 
-		while (!eofReached && readHexRecord(bufferedFile, hexRecord)) {
-			size_t currentPosition = file.tell();
+		while (reader.readPage(page)) {
+			if (writePending && !endWriteMemory(g_slotIndex)) {
+				DebugTrace("Failed to write memory\n");
+				writePending = false;
+				writeFailed = true;
+				break;
+			}
+
+			if (!beginWriteMemory(g_slotIndex, page.address, page.data, page.size)) {
+				DebugTrace("Failed to write memory at address %08x\n", page.address);
+				writePending = false;
+				writeFailed = true;
+				break;
+			}
+
+			writePending = true;
 
 	#if OPTION_DISPLAY
-			psu::gui::updateProgressPage(currentPosition, totalSize);
+			psu::gui::updateProgressPage(reader.file.tell(), totalSize);
 	#endif
+		}
 
-			if (hexRecord.recordType == 0x04) {
-				addressUpperBits = ((hexRecord.data[0] << 8) + hexRecord.data[1]) << 16;
-			} else if (hexRecord.recordType == 0x00) {
-				uint32_t address = addressUpperBits | hexRecord.address;
-				if (!writeMemory(g_slotIndex, address, hexRecord.data, hexRecord.recordLength)) {
-					DebugTrace("Failed to write memory at address %08x\n", address);
-					break;
-				}
-			} else if (hexRecord.recordType == 0x01) {
-				eofReached = true;
-			}
+		if (writePending && !endWriteMemory(g_slotIndex)) {
+			DebugTrace("Failed to write memory\n");
+			writeFailed = true;
 		}
 
-		file.close();
+		eofReached = !writeFailed && reader.eofReached;
+
+		reader.close();
 
 Exit:
 	#if OPTION_DISPLAY
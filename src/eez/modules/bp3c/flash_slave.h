@@ -24,7 +24,9 @@ namespace flash_slave {
 
 extern bool g_bootloaderMode;
 
-void start(int slotIndex, const char *hexFilePath);
+// If skipIfIdentical is set, slave flash is read back first and
+// erase/write is skipped when it already contains the same firmware.
+void start(int slotIndex, const char *hexFilePath, bool skipIfIdentical = false);
 void doStart();
 void leaveBootloaderMode();
 
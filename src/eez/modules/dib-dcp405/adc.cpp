@@ -20,10 +20,10 @@
 
 #include <eez/modules/psu/channel_dispatcher.h>
 #include <eez/modules/dib-dcp405/adc.h>
+#include <eez/system.h>
 
 #if defined(EEZ_PLATFORM_STM32)
 #include <eez/platform/stm32/spi.h>
-#include <eez/system.h>
 #include <eez/index.h>
 #include <scpi/scpi.h>
 #endif
@@ -96,6 +96,14 @@ uint8_t AnalogDigitalConverter::getReg1Val() {
 #endif
 
 #if defined(EEZ_PLATFORM_SIMULATOR)
+/// Samples per second for CONF_ADC_SPS, first row is normal and second is turbo mode.
+static const uint32_t ADC_SPS[2][7] = {
+    { 20, 45, 90, 175, 330, 600, 1000 },
+    { 40, 90, 180, 350, 660, 1200, 2000 }
+};
+
+static const uint32_t ADC_CONVERSION_TIME_US = 1000000 / ADC_SPS[CONF_ADC_MODE == 2 ? 1 : 0][CONF_ADC_SPS];
+
 static float g_uMon[CH_MAX];
 static float g_iMon[CH_MAX];
 
@@ -279,6 +287,9 @@ bool AnalogDigitalConverter::test() {
 
 void AnalogDigitalConverter::start(AdcDataType adcDataType_) {
     adcDataType = adcDataType_;
+    start_time = micros();
+    conversionPending = true;
+    numSpiTransactions++;
 
 #if defined(EEZ_PLATFORM_STM32)
 	uint8_t data[3];
@@ -309,6 +320,9 @@ void AnalogDigitalConverter::start(AdcDataType adcDataType_) {
 }
 
 float AnalogDigitalConverter::read() {
+    numSpiTransactions++;
+    conversionPending = false;
+
 #if defined(EEZ_PLATFORM_STM32)
     uint8_t data[3];
     uint8_t result[3];
@@ -380,6 +394,16 @@ float AnalogDigitalConverter::read() {
 #endif
 }
 
+bool AnalogDigitalConverter::isConversionPending() {
+    return conversionPending;
+}
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+bool AnalogDigitalConverter::isConversionFinished() {
+    return micros() - start_time >= ADC_CONVERSION_TIME_US;
+}
+#endif
+
 void AnalogDigitalConverter::readAllRegisters(uint8_t registers[]) {
 #if defined(EEZ_PLATFORM_STM32)    
     uint8_t data[5];
@@ -43,10 +43,21 @@ public:
     void start(AdcDataType adcDataType);
     float read();
 
+    // true between start and read
+    bool isConversionPending();
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+    // Model of DRDY timing, conversion takes as long as with the configured data rate.
+    bool isConversionFinished();
+#endif
+
     void readAllRegisters(uint8_t registers[]);
 
+    uint32_t numSpiTransactions = 0;
+
 private:
     uint32_t start_time;
+    bool conversionPending = false;
 
 #if defined(EEZ_PLATFORM_STM32)
     uint8_t getReg1Val();
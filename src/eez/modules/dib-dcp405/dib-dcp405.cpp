@@ -48,6 +48,9 @@
 /// ADC conversion should be finished after ADC_CONVERSION_MAX_TIME_MS milliseconds.
 #define CONF_ADC_CONVERSION_MAX_TIME_MS 10
 
+/// ADC samples/sec and SPI transactions/sec are calculated over this period.
+#define CONF_ADC_STATISTICS_PERIOD_MS 1000
+
 #define CONF_FALLING_EDGE_OVP_PERCENTAGE 2.0f
 
 #define CONF_FALLING_EDGE_HW_OVP_DELAY_MS 2
@@ -95,6 +98,15 @@ struct DcpChannel : public Channel {
 
     bool valueBalancing = false;
 
+	uint32_t lastAdcSampleTickCount = 0;
+	uint32_t numAdcSamples = 0;
+
+	uint32_t adcStatisticsTickCount = 0;
+	uint32_t adcStatisticsNumAdcSamples = 0;
+	uint32_t adcStatisticsNumSpiTransactions = 0;
+	float adcSamplesPerSecond = 0;
+	float spiTransactionsPerSecond = 0;
+
     DcpChannel(uint8_t slotIndex, uint8_t channelIndex, uint8_t subchannelIndex)
         : Channel(slotIndex, channelIndex, subchannelIndex)
     {
@@ -278,6 +290,18 @@ struct DcpChannel : public Channel {
 
 		ioexp.tick(tickCount);
 
+#if defined(EEZ_PLATFORM_STM32)
+		// PSU_MESSAGE_SPI_IRQ is posted without waiting, so it can be lost if queue is full
+		if (ioexp.isInterruptPending()) {
+			onSpiIrq();
+		}
+#endif
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+		// there is no DRDY interrupt in simulator
+		ioexp.setAdcReady(adc.isConversionFinished());
+#endif
+
 #if !CONF_SKIP_PWRGOOD_TEST
 		if (!ioexp.testBit(IOExpander::IO_BIT_IN_PWRGOOD)) {
 			DebugTrace("Ch%d PWRGOOD bit changed to 0, gpio=%d\n", channelIndex + 1, (int)ioexp.gpio);
@@ -287,16 +311,22 @@ struct DcpChannel : public Channel {
 		}
 #endif
 
-		if (isOutputEnabled() && ioexp.isAdcReady()) {
-			auto adcDataType = adc.adcDataType;
-			float value = adc.read();
-			adc.start(getNextAdcDataType(adcDataType));
-			onAdcData(adcDataType, value);
-#ifdef DEBUG
-			psu::debug::g_adcCounter.inc();
+		if (isOutputEnabled()) {
+#if defined(EEZ_PLATFORM_STM32)
+			// ADC is normally read from onSpiIrq, poll DRDY only if interrupt is missed
+			if (!ioexp.isAdcReady() && tickCount - lastAdcSampleTickCount > CONF_ADC_CONVERSION_MAX_TIME_MS * 1000) {
+				ioexp.readGpio();
+				lastAdcSampleTickCount = tickCount;
+			}
 #endif
+
+			if (ioexp.isAdcReady() && adc.isConversionPending()) {
+				readAdc();
+			}
 		}
 
+		updateAdcStatistics(tickCount);
+
 		if (flags.dprogState == DPROG_STATE_ON) {
 			// turn off DP after delay
 			if (delayed_dp_off && (millis() - delayed_dp_off_start) >= DP_OFF_DELAY_PERIOD) {
@@ -393,10 +423,46 @@ struct DcpChannel : public Channel {
 		return ioexp.testBit(IOExpander::IO_BIT_IN_CV_ACTIVE);
 	}
 
+	void readAdc() {
+		ioexp.setAdcReady(false);
+
+		auto adcDataType = adc.adcDataType;
+		float value = adc.read();
+		adc.start(getNextAdcDataType(adcDataType));
+		onAdcData(adcDataType, value);
+
+		lastAdcSampleTickCount = micros();
+		numAdcSamples++;
+
+#ifdef DEBUG
+		psu::debug::g_adcCounter.inc();
+#endif
+	}
+
+	void updateAdcStatistics(uint32_t tickCount) {
+		uint32_t diff = tickCount - adcStatisticsTickCount;
+		if (diff >= CONF_ADC_STATISTICS_PERIOD_MS * 1000) {
+			uint32_t numSpiTransactions = ioexp.numSpiTransactions + adc.numSpiTransactions;
+
+			adcSamplesPerSecond = (numAdcSamples - adcStatisticsNumAdcSamples) * 1E6f / diff;
+			spiTransactionsPerSecond = (numSpiTransactions - adcStatisticsNumSpiTransactions) * 1E6f / diff;
+
+			adcStatisticsTickCount = tickCount;
+			adcStatisticsNumAdcSamples = numAdcSamples;
+			adcStatisticsNumSpiTransactions = numSpiTransactions;
+		}
+	}
+
+	bool getAdcStatistics(float &samplesPerSecond, float &spiTransactionsPerSecond_) override {
+		samplesPerSecond = adcSamplesPerSecond;
+		spiTransactionsPerSecond_ = spiTransactionsPerSecond;
+		return true;
+	}
+
 	void waitConversionEnd() {
 #if defined(EEZ_PLATFORM_STM32)
         for (int i = 0; i < CONF_ADC_CONVERSION_MAX_TIME_MS; i++) {
-            ioexp.tick(micros());
+            ioexp.readGpio();
             if (ioexp.isAdcReady()) {
 				break;
 			}
@@ -405,6 +471,9 @@ struct DcpChannel : public Channel {
 
 		WATCHDOG_RESET(WATCHDOG_LONG_OPERATION);
 #endif
+
+		// conversion result is read by the caller
+		ioexp.setAdcReady(false);
     }
 
 	void adcMeasureUMon() override {
@@ -823,15 +892,24 @@ struct DcpChannel : public Channel {
 
 #if defined(EEZ_PLATFORM_STM32)
 	void onSpiIrq() {
-		uint8_t intcap = ioexp.readIntcapRegister();
+		uint8_t intcap = ioexp.readCapturedInputs();
 		// DebugTrace("CH%d INTCAP 0x%02X\n", (int)(channelIndex + 1), (int)intcap);
-		if (!(intcap & (1 << IOExpander::R2B5_IO_BIT_IN_OVP_FAULT))) {
+		if (g_slots[slotIndex]->moduleRevision >= MODULE_REVISION_DCP405_R2B5 && !(intcap & (1 << IOExpander::R2B5_IO_BIT_IN_OVP_FAULT))) {
 			if (isOutputEnabled() && isHwOvpEnabled(*this)) {
 				protectionEnter(ovp, true);
 			}
 		} else if (!(intcap & (1 << IOExpander::IO_BIT_IN_PWRGOOD))) {
 			NVIC_SystemReset();
 		}
+
+		// DRDY is tested in the current GPIO value, not in INTCAP, because conversion captured
+		// in INTCAP could be already read from tickSpecific, and only if conversion was started,
+		// otherwise previous result would be read as the next ADC data type
+		if (ioexp.isAdcReady() && adc.isConversionPending()) {
+			if (isOutputEnabled() && !isDacTesting()) {
+				readAdc();
+			}
+		}
 	}
 #endif
 
@@ -1092,7 +1170,7 @@ void tickDacRamp(uint32_t tickCount) {
 void readIntcapRegisterShortcut(int slotIndex) {
 	dcp405::DcpChannel *channel = (dcp405::DcpChannel *)Channel::getBySlotIndex(slotIndex, 0);
 	if (channel) {
-		channel->ioexp.readIntcapRegister();
+		channel->ioexp.onInterrupt();
 	}
 }
 #endif
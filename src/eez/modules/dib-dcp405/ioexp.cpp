@@ -34,6 +34,9 @@ namespace eez {
 namespace psu {
 
 #if defined(EEZ_PLATFORM_STM32)
+/// How often registers are read back and compared with the expected values.
+static const uint32_t CONF_IOEXP_VERIFY_INTERVAL_US = 50 * 1000;
+
 // I/O expander MCP23S17-E/SS
 // http://ww1.microchip.com/downloads/en/devicedoc/20001952c.pdf
 static const uint8_t IOEXP_WRITE = 0B01000000;
@@ -64,13 +67,14 @@ static const uint8_t REG_VALUE_IODIRB   = 0B00000000; //
 static const uint8_t REG_VALUE_IPOLA    = 0B00000000; // no pin is inverted
 static const uint8_t REG_VALUE_IPOLB    = 0B00000000; // no pin is inverted
 
-static const uint8_t REG_VALUE_GPINTENA = 0B00100000; // enable interrupt for HW OVP Fault
+static const uint8_t REG_VALUE_GPINTENA = 0B00110000; // enable interrupt for HW OVP Fault and ADC DRDY
+static const uint8_t REG_VALUE_GPINTENA_ADC_DRDY = 0B00010000; // enable interrupt for ADC DRDY only
 static const uint8_t REG_VALUE_GPINTENB = 0B00000000; // no interrupts
 
 static const uint8_t REG_VALUE_DEFVALA  = 0B00100000; // default value for HW OVP Fault is 1
 static const uint8_t REG_VALUE_DEFVALB  = 0B00000000; //
 
-static const uint8_t REG_VALUE_INTCONA  = 0B00100000; // compare HW OVP Fault value with default value
+static const uint8_t REG_VALUE_INTCONA  = 0B00100000; // compare HW OVP Fault value with default value, ADC DRDY interrupts on change
 static const uint8_t REG_VALUE_INTCONB  = 0B00000000; //
 
 static const uint8_t REG_VALUE_IOCON    = 0B00100000; // sequential operation disabled, hw addressing disabled
@@ -145,10 +149,13 @@ void IOExpander::init() {
 #if defined(EEZ_PLATFORM_STM32)
     auto &slot = *g_slots[slotIndex];
 
-    gpio = 0;
+    gpio = 1 << IO_BIT_IN_ADC_DRDY;
     gpioWritten = 0;
     gpioOutputPinsMask = 0;
 
+    lastVerifyTickCount = micros();
+    interruptPending = false;
+
     gpioOutputPinsMask |= 1 << IO_BIT_OUT_DP_ENABLE;
     gpioOutputPinsMask |= 1 << IO_BIT_OUT_OUTPUT_ENABLE;
     gpioOutputPinsMask |= 1 << IO_BIT_OUT_REMOTE_SENSE;
@@ -262,10 +269,10 @@ void IOExpander::reinit() {
 }
 #endif
 
-void IOExpander::tick(uint32_t tick_usec) {
+#if defined(EEZ_PLATFORM_STM32)
+void IOExpander::verify() {
     Channel &channel = Channel::get(channelIndex);
 
-#if defined(EEZ_PLATFORM_STM32)    
 	readGpio();
 
     uint8_t iodira = read(REG_IODIRA);
@@ -284,9 +291,20 @@ void IOExpander::tick(uint32_t tick_usec) {
 
         // testResult = TEST_FAILED;
     }
+}
+#endif
+
+void IOExpander::tick(uint32_t tick_usec) {
+#if defined(EEZ_PLATFORM_STM32)
+    if (tick_usec - lastVerifyTickCount >= CONF_IOEXP_VERIFY_INTERVAL_US) {
+        lastVerifyTickCount = tick_usec;
+        verify();
+    }
 #endif
 
 #if defined(EEZ_PLATFORM_SIMULATOR)
+    Channel &channel = Channel::get(channelIndex);
+
     if (simulator::getPwrgood(channel.channelIndex)) {
         gpio |= 1 << IOExpander::IO_BIT_IN_PWRGOOD;
     } else {
@@ -342,11 +360,16 @@ bool IOExpander::testBit(int io_bit) {
 }
 
 bool IOExpander::isAdcReady() {
-#if defined(EEZ_PLATFORM_STM32)
     return !testBit(IO_BIT_IN_ADC_DRDY);
-#else
-    return true;
-#endif
+}
+
+void IOExpander::setAdcReady(bool ready) {
+    // DRDY is active low
+    if (ready) {
+        gpio &= ~(1 << IO_BIT_IN_ADC_DRDY);
+    } else {
+        gpio |= 1 << IO_BIT_IN_ADC_DRDY;
+    }
 }
 
 void IOExpander::changeBit(int io_bit, bool set) {
@@ -357,7 +380,7 @@ void IOExpander::changeBit(int io_bit, bool set) {
         if (set) {
             write(REG_GPINTENA, REG_VALUE_GPINTENA);
         } else {
-            write(REG_GPINTENA, 0);
+            write(REG_GPINTENA, REG_VALUE_GPINTENA_ADC_DRDY);
         }
     }
 #endif
@@ -394,46 +417,42 @@ void IOExpander::readGpio() {
     gpio = (gpiob << 8) | gpioa;
 }
 
-uint8_t IOExpander::read(uint8_t reg) {
+uint8_t IOExpander::transfer(uint8_t cmd, uint8_t reg, uint8_t val) {
     uint8_t data[3];
-    data[0] = IOEXP_READ;
+    data[0] = cmd;
     data[1] = reg;
-    data[2] = 0;
+    data[2] = val;
     uint8_t result[3];
 
-    if (g_isBooted && !isPsuThread()) {
-        DebugTrace("wrong thread\n");
-    }
-
     spi::select(slotIndex, spi::CHIP_IOEXP);
     spi::transfer3(slotIndex, data, result);
     spi::deselect(slotIndex);
 
+    numSpiTransactions++;
+
     return result[2];
 }
 
-void IOExpander::write(uint8_t reg, uint8_t val) {
-    uint8_t data[3];
-    data[0] = IOEXP_WRITE;
-    data[1] = reg;
-    data[2] = val;
-    uint8_t result[3];
-
+uint8_t IOExpander::read(uint8_t reg) {
     if (g_isBooted && !isPsuThread()) {
         DebugTrace("wrong thread\n");
     }
 
-    spi::select(slotIndex, spi::CHIP_IOEXP);
+    return transfer(IOEXP_READ, reg, 0);
+}
 
-    spi::transfer3(slotIndex, data, result);
+void IOExpander::write(uint8_t reg, uint8_t val) {
+    if (g_isBooted && !isPsuThread()) {
+        DebugTrace("wrong thread\n");
+    }
+
+    transfer(IOEXP_WRITE, reg, val);
 
     if (reg == REG_GPIOA) {
         gpioWritten = (gpioWritten & 0xFF00) | val;
     } else if (reg == REG_GPIOB) {
         gpioWritten = (gpioWritten & 0x00FF) | (val << 8);
     }
-
-    spi::deselect(slotIndex);
 }
 #endif
 
@@ -441,6 +460,27 @@ void IOExpander::write(uint8_t reg, uint8_t val) {
 uint8_t IOExpander::readIntcapRegister() {
     return read(REG_INTCAPA);
 }
+
+void IOExpander::onInterrupt() {
+    interruptPending = true;
+}
+
+bool IOExpander::isInterruptPending() {
+    return interruptPending;
+}
+
+uint8_t IOExpander::readCapturedInputs() {
+    interruptPending = false;
+
+    uint8_t value = readIntcapRegister();
+
+    // INTCAP holds the inputs from the moment of interrupt, ADC could be already read since then
+    uint8_t gpioa = read(REG_GPIOA);
+    uint8_t inputPinsMask = getRegValue(REG_IODIRA_INDEX);
+    gpio = (gpio & ~inputPinsMask) | (gpioa & inputPinsMask);
+
+    return value;
+}
 #endif
 
 void IOExpander::readAllRegisters(uint8_t registers[]) {
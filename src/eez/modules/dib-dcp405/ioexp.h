@@ -56,6 +56,7 @@ public:
     void init();
     bool test();
 
+    /// Inputs are updated from the interrupt, here registers are only periodically verified.
     void tick(uint32_t tick_usec);
 
     bool testBit(int io_bit);
@@ -64,25 +65,44 @@ public:
 #if defined(EEZ_PLATFORM_STM32)
     int getBitDirection(int io_bit); // 0: output, 1: input
     uint8_t readIntcapRegister();
+
+    /// Called from ISR, only marks the interrupt as pending,
+    /// registers are read later from the PSU thread.
+    void onInterrupt();
+    bool isInterruptPending();
+
+    /// Reads INTCAP (this clears the interrupt) and returns its value,
+    /// input bits of port A are updated from the current GPIOA value.
+    uint8_t readCapturedInputs();
+
+    void readGpio();
 #endif
 
     bool isAdcReady();
+    void setAdcReady(bool ready);
 
     void readAllRegisters(uint8_t registers[]);
 
     uint16_t gpio;
 
+    uint32_t numSpiTransactions = 0;
+
 private:
 #if defined(EEZ_PLATFORM_STM32)
     uint16_t gpioWritten;
     uint16_t gpioOutputPinsMask;
 
+    uint32_t lastVerifyTickCount;
+
+    volatile bool interruptPending;
+
     uint8_t getRegValue(int i);
 
     void reinit();
-    void readGpio();
+    void verify();
     uint8_t read(uint8_t reg);
     void write(uint8_t reg, uint8_t val);
+    uint8_t transfer(uint8_t cmd, uint8_t reg, uint8_t val);
 #endif
 };
 
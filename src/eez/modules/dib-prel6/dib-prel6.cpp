@@ -18,6 +18,7 @@
 
 #include <assert.h>
 #include <stdlib.h>
+#include <string.h>
 
 #if defined(EEZ_PLATFORM_STM32)
 #include <spi.h>
@@ -26,6 +27,7 @@
 
 #include "eez/debug.h"
 #include "eez/firmware.h"
+#include <eez/system.h>
 #include "eez/gui/document.h"
 #include "eez/modules/psu/event_queue.h"
 #include "eez/modules/psu/gui/psu.h"
@@ -40,6 +42,9 @@ static const uint16_t MODULE_REVISION_R1B2  = 0x0102;
 
 #define BUFFER_SIZE 16
 
+// Frame is resent even if nothing is changed, so lost slave is detected.
+static const int32_t CONF_KEEP_ALIVE_MS = 500;
+
 struct Prel6Module : public Module {
 public:
     TestResult testResult = TEST_NONE;
@@ -47,7 +52,15 @@ public:
     int numCrcErrors = 0;
     uint8_t input[BUFFER_SIZE];
     uint8_t output[BUFFER_SIZE];
-    bool spiReady;
+    bool spiReady = false;
+
+    // last frame successfully transferred to the slave
+    uint8_t lastTransferredOutput[BUFFER_SIZE];
+    uint32_t lastTransferTickCount;
+
+    bool transferInProgress = false;
+    volatile bool transferCompleted;
+    volatile int transferStatus;
 
     Prel6Module() {
         moduleType = MODULE_TYPE_DIB_PREL6;
@@ -64,6 +77,9 @@ public:
 #endif
         numPowerChannels = 0;
         numOtherChannels = 0;
+
+        memset(output, 0, BUFFER_SIZE);
+        memset(lastTransferredOutput, 0, BUFFER_SIZE);
     }
 
     Module *createModule() override {
@@ -79,6 +95,8 @@ public:
             if (bp3c::comm::masterSynchro(slotIndex)) {
                 synchronized = true;
                 numCrcErrors = 0;
+                lastTransferTickCount = millis();
+                transferInProgress = false;
                 testResult = TEST_OK;
             } else {
                 if (g_slots[slotIndex]->firmwareInstalled) {
@@ -94,16 +112,43 @@ public:
             return;
         }
 
-        static int cnt = 0;
-        if (++cnt < 25) {
+        if (transferInProgress && transferCompleted) {
+            transferInProgress = false;
+            onTransferCompleted();
+        }
+
+        if (synchronized && !transferInProgress) {
+            updateSlave();
+        }
+    }
+
+    void updateSlave() {
+#if defined(EEZ_PLATFORM_STM32)
+        if (!spiReady) {
             return;
         }
-        cnt = 0;
+#endif
+
+        if (memcmp(output, lastTransferredOutput, BUFFER_SIZE) == 0) {
+            int32_t diff = millis() - lastTransferTickCount;
+            if (diff < CONF_KEEP_ALIVE_MS) {
+                return;
+            }
+        }
 
 #if defined(EEZ_PLATFORM_STM32)
-        if (spiReady) {
-            spiReady = false;
-            transfer();
+        spiReady = false;
+#endif
+
+        transferCompleted = false;
+        transferInProgress = true;
+
+        auto status = bp3c::comm::transferDMA(slotIndex, output, input, BUFFER_SIZE);
+#if defined(EEZ_PLATFORM_SIMULATOR)
+        onSpiDmaTransferCompleted(status);
+#else
+        if (status != bp3c::comm::TRANSFER_STATUS_OK) {
+            onSpiDmaTransferCompleted(status);
         }
 #endif
     }
@@ -114,12 +159,21 @@ public:
     }
 #endif
 
-    void transfer() {
-        auto status = bp3c::comm::transfer(slotIndex, output, input, BUFFER_SIZE);
-        if (status == bp3c::comm::TRANSFER_STATUS_OK) {
+    // called from ISR, result is processed in tick()
+    void onSpiDmaTransferCompleted(int status) override {
+        transferStatus = status;
+        transferCompleted = true;
+    }
+
+    void onTransferCompleted() {
+        transferStatus = bp3c::comm::checkCrc(slotIndex, input, BUFFER_SIZE, (bp3c::comm::TransferResult)transferStatus);
+
+        if (transferStatus == bp3c::comm::TRANSFER_STATUS_OK) {
             numCrcErrors = 0;
+            lastTransferTickCount = millis();
+            memcpy(lastTransferredOutput, output, BUFFER_SIZE);
         } else {
-            if (status == bp3c::comm::TRANSFER_STATUS_CRC_ERROR) {
+            if (transferStatus == bp3c::comm::TRANSFER_STATUS_CRC_ERROR) {
                 if (++numCrcErrors >= 10) {
                     psu::event_queue::pushEvent(psu::event_queue::EVENT_ERROR_SLOT1_CRC_CHECK_ERROR + slotIndex);
                     synchronized = false;
@@ -128,7 +182,7 @@ public:
                     DebugTrace("Slot %d CRC %d\n", slotIndex + 1, numCrcErrors);
                 }
             } else {
-                DebugTrace("Slot %d SPI transfer error %d\n", slotIndex + 1, status);
+                DebugTrace("Slot %d SPI transfer error %d\n", slotIndex + 1, transferStatus);
             }
         }
     }
@@ -63,6 +63,13 @@ static const uint16_t MODULE_REVISION_R1B2  = 0x0102;
 
 static const int32_t CONF_TRANSFER_TIMEOUT_MS = 1000;
 
+// Frame is resent even if nothing is changed, so lost slave is detected.
+static const int32_t CONF_KEEP_ALIVE_MS = 500;
+
+// Changes are sent only after they are stable for this long,
+// so burst of ROUT:OPEN/CLOSe commands ends up in a single frame.
+static const int32_t CONF_CHANGE_SETTLE_MS = 5;
+
 static const uint32_t BUFFER_SIZE = 20;
 
 static float U_CAL_POINTS[2] = { 1.0f, 9.0f };
@@ -96,6 +103,17 @@ public:
     uint8_t output[BUFFER_SIZE];
     bool spiReady = false;
 
+    // last frame successfully transferred to the slave
+    FromMasterToSlave lastTransferredData;
+
+    // changed frame waiting for CONF_CHANGE_SETTLE_MS
+    FromMasterToSlave pendingData;
+    uint32_t pendingDataTickCount;
+
+    bool transferInProgress = false;
+    volatile bool transferCompleted;
+    volatile int transferStatus;
+
     uint32_t routes;
 
     char columnLabels[NUM_COLUMNS][MAX_SWITCH_MATRIX_LABEL_LENGTH + 1];
@@ -136,11 +154,13 @@ public:
 
         resetConfiguration();
 
-        auto data = (FromMasterToSlave *)output;
-        data->routes = routes;
-        data->dac1 = dac1;
-        data->dac2 = dac2;
-        data->relayOn = relayOn;
+        memset(&lastTransferredData, 0, sizeof(FromMasterToSlave));
+        lastTransferredData.routes = routes;
+        lastTransferredData.dac1 = dac1;
+        lastTransferredData.dac2 = dac2;
+        lastTransferredData.relayOn = relayOn;
+        memcpy(&pendingData, &lastTransferredData, sizeof(FromMasterToSlave));
+        memcpy(output, &lastTransferredData, sizeof(FromMasterToSlave));
     }
 
     void boot() override {
@@ -166,6 +186,7 @@ public:
                 synchronized = true;
                 numCrcErrors = 0;
                 lastTransferTickCount = millis();
+                transferInProgress = false;
                 testResult = TEST_OK;
             } else {
                 if (g_slots[slotIndex]->firmwareInstalled) {
@@ -176,52 +197,82 @@ public:
         }
     }
 
+    void getData(FromMasterToSlave &data) {
+        data.routes = routes;
+        data.dac1 = calibrationEnabled[0] && isVoltageCalibrationExists(0) ? calibration::remapValue(dac1, calConf[0].u) : dac1;
+        data.dac2 = calibrationEnabled[1] && isVoltageCalibrationExists(1) ? calibration::remapValue(dac2, calConf[1].u) : dac2;
+        data.relayOn = relayOn ? 1 : 0;
+    }
+
     void tick() override {
         if (!synchronized) {
             return;
         }
 
-#if defined(EEZ_PLATFORM_STM32)
-        if (spiReady) {
-#endif
-            FromMasterToSlave data;
-
-            uint32_t newRoutes = routes;
-            uint8_t newRelayOn = relayOn ? 1 : 0;
-
-            data.routes = newRoutes;
-            data.dac1 = calibrationEnabled[0] && isVoltageCalibrationExists(0) ? calibration::remapValue(dac1, calConf[0].u) : dac1;
-            data.dac2 = calibrationEnabled[1] && isVoltageCalibrationExists(1) ? calibration::remapValue(dac2, calConf[1].u) : dac2;
-            data.relayOn = newRelayOn;
+        if (transferInProgress && transferCompleted) {
+            transferInProgress = false;
+            onTransferCompleted();
+        }
 
-            if (memcmp(output, &data, sizeof(FromMasterToSlave)) != 0) {
-                FromMasterToSlave *oldData = (FromMasterToSlave *)output;
+        if (synchronized && !transferInProgress) {
+            updateSlave();
+        }
 
-                uint32_t oldRoutes = oldData->routes;
-                uint8_t oldRelayOn = oldData->relayOn;
+        if (relayCyclesWriteInterval.test(micros())) {
+            sendMessageToLowPriorityThread((LowPriorityThreadMessage)THREAD_MESSAGE_SAVE_RELAY_CYCLES, slotIndex);
+        }
+    }
 
-            	memcpy(output, &data, sizeof(FromMasterToSlave));
-                if (transfer()) {
-                    updateRelayCycles(oldRoutes, newRoutes, oldRelayOn, newRelayOn);
-                }
-#if defined(EEZ_PLATFORM_STM32)
-                spiReady = false;
-#endif
-            }
+    void updateSlave() {
 #if defined(EEZ_PLATFORM_STM32)
-        } else {
+        if (!spiReady) {
             int32_t diff = millis() - lastTransferTickCount;
             if (diff > CONF_TRANSFER_TIMEOUT_MS) {
                 event_queue::pushEvent(event_queue::EVENT_ERROR_SLOT1_SYNC_ERROR + slotIndex);
                 synchronized = false;
                 testResult = TEST_FAILED;
             }
+            return;
         }
 #endif
 
-        if (relayCyclesWriteInterval.test(micros())) {
-            sendMessageToLowPriorityThread((LowPriorityThreadMessage)THREAD_MESSAGE_SAVE_RELAY_CYCLES, slotIndex);
+        FromMasterToSlave data;
+        memset(&data, 0, sizeof(FromMasterToSlave));
+        getData(data);
+
+        uint32_t tickCount = millis();
+
+        if (memcmp(&data, &lastTransferredData, sizeof(FromMasterToSlave)) != 0) {
+            if (memcmp(&data, &pendingData, sizeof(FromMasterToSlave)) != 0) {
+                memcpy(&pendingData, &data, sizeof(FromMasterToSlave));
+                pendingDataTickCount = tickCount;
+            }
+            if ((int32_t)(tickCount - pendingDataTickCount) < CONF_CHANGE_SETTLE_MS) {
+                return;
+            }
+        } else {
+            if ((int32_t)(tickCount - lastTransferTickCount) < CONF_KEEP_ALIVE_MS) {
+                return;
+            }
+        }
+
+        memcpy(output, &data, sizeof(FromMasterToSlave));
+
+#if defined(EEZ_PLATFORM_STM32)
+        spiReady = false;
+#endif
+
+        transferCompleted = false;
+        transferInProgress = true;
+
+        auto status = bp3c::comm::transferDMA(slotIndex, output, input, BUFFER_SIZE);
+#if defined(EEZ_PLATFORM_SIMULATOR)
+        onSpiDmaTransferCompleted(status);
+#else
+        if (status != bp3c::comm::TRANSFER_STATUS_OK) {
+            onSpiDmaTransferCompleted(status);
         }
+#endif
     }
 
 #if defined(EEZ_PLATFORM_STM32)
@@ -230,15 +281,24 @@ public:
     }
 #endif
 
-    bool transfer() {
-#if defined(EEZ_PLATFORM_STM32)
-        auto status = bp3c::comm::transfer(slotIndex, output, input, BUFFER_SIZE);
-        if (status == bp3c::comm::TRANSFER_STATUS_OK) {
+    // called from ISR, result is processed in tick()
+    void onSpiDmaTransferCompleted(int status) override {
+        transferStatus = status;
+        transferCompleted = true;
+    }
+
+    void onTransferCompleted() {
+        transferStatus = bp3c::comm::checkCrc(slotIndex, input, BUFFER_SIZE, (bp3c::comm::TransferResult)transferStatus);
+
+        if (transferStatus == bp3c::comm::TRANSFER_STATUS_OK) {
             numCrcErrors = 0;
             lastTransferTickCount = millis();
-            return true;
+
+            FromMasterToSlave &data = (FromMasterToSlave &)*output;
+            updateRelayCycles(lastTransferredData.routes, data.routes, lastTransferredData.relayOn, data.relayOn);
+            memcpy(&lastTransferredData, &data, sizeof(FromMasterToSlave));
         } else {
-            if (status == bp3c::comm::TRANSFER_STATUS_CRC_ERROR) {
+            if (transferStatus == bp3c::comm::TRANSFER_STATUS_CRC_ERROR) {
                 if (++numCrcErrors >= 10) {
                     psu::event_queue::pushEvent(psu::event_queue::EVENT_ERROR_SLOT1_CRC_CHECK_ERROR + slotIndex);
                     synchronized = false;
@@ -247,12 +307,9 @@ public:
                     DebugTrace("Slot %d CRC %d\n", slotIndex + 1, numCrcErrors);
                 }
             } else {
-                DebugTrace("Slot %d SPI transfer error %d\n", slotIndex + 1, status);
+                DebugTrace("Slot %d SPI transfer error %d\n", slotIndex + 1, transferStatus);
             }
-            return false;
         }
-#endif
-        return true;
     }
 
     void writeUnsavedData() override {
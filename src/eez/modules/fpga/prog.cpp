@@ -28,19 +28,21 @@
 #include <eez/libs/sd_fat/sd_fat.h>
 
 #include <eez/modules/fpga/prog.h>
+#include <eez/modules/fpga/tap_model.h>
 
 namespace eez {
 namespace fpga {
 
 #if defined(EEZ_PLATFORM_SIMULATOR)
 
+// pins are connected to the TAP model
 #define DOUT2_GPIO_Port 0
-#define DOUT2_Pin 0
+#define DOUT2_Pin tap_model::PIN_TMS
 #define GPIOB 0
-#define GPIO_PIN_14 0
+#define GPIO_PIN_14 tap_model::PIN_TDI
 #define GPIOI 0
-#define GPIO_PIN_3 0
-#define GPIO_PIN_1 0
+#define GPIO_PIN_3 tap_model::PIN_TDO
+#define GPIO_PIN_1 tap_model::PIN_TCK
 
 typedef uint32_t GPIO_TypeDef;
 
@@ -50,10 +52,11 @@ enum GPIO_PinState {
 };
 
 void HAL_GPIO_WritePin(GPIO_TypeDef *port, uint32_t pin, GPIO_PinState state) {
+    tap_model::writePin(pin, state == GPIO_PIN_SET);
 }
 
 GPIO_PinState HAL_GPIO_ReadPin(GPIO_TypeDef *port, uint32_t pin) {
-    return GPIO_PIN_SET;
+    return tap_model::readPin(pin) ? GPIO_PIN_SET : GPIO_PIN_RESET;
 }
 
 #endif
@@ -74,6 +77,15 @@ struct Pin {
         return HAL_GPIO_ReadPin(m_port, m_pin);
     }
 
+    // bsrr is either m_pin (set) or m_pin << 16 (reset)
+    void write(uint32_t bsrr) {
+#if defined(EEZ_PLATFORM_STM32)
+        m_port->BSRR = bsrr;
+#else
+        HAL_GPIO_WritePin(m_port, m_pin, bsrr == m_pin ? GPIO_PIN_SET : GPIO_PIN_RESET);
+#endif
+    }
+
     GPIO_TypeDef *m_port;
     uint32_t m_pin;
 };
@@ -83,7 +95,52 @@ Pin tdi(GPIOB, GPIO_PIN_14);
 Pin tdo(GPIOI, GPIO_PIN_3);
 Pin tck(GPIOI, GPIO_PIN_1);
 
+// SPI is used only for the bitstream until SPI JTAG mode is validated on hardware
+ShiftMethod g_shiftMethod = SHIFT_METHOD_TOGGLE_TABLE;
+
+static bool g_spiJtag;
+
+// TDI BSRR values for each bit (LSB first) of every byte value
+static uint32_t g_tdiToggleTable[256][8];
+static uint8_t g_bitReverseTable[256];
+static bool g_tablesInitialized;
+
+static void init_tables() {
+    if (g_tablesInitialized) {
+        return;
+    }
+
+    for (int byte = 0; byte < 256; byte++) {
+        uint8_t reversed = 0;
+        for (int nf = 0; nf < 8; nf++) {
+            if ((byte >> nf) & 1) {
+                g_tdiToggleTable[byte][nf] = tdi.m_pin;
+                reversed |= 0x80 >> nf;
+            } else {
+                g_tdiToggleTable[byte][nf] = tdi.m_pin << 16;
+            }
+        }
+        g_bitReverseTable[byte] = reversed;
+    }
+
+    g_tablesInitialized = true;
+}
+
+static void spi_transmit(const uint8_t *buf, int len) {
+#if defined(EEZ_PLATFORM_STM32)
+    spi::select(0, spi::CHIP_FPGA);
+    spi::transmit(0, (uint8_t *)buf, len);
+    spi::deselect(0);
+#endif
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+    tap_model::spiTransmit(buf, len);
+#endif
+}
+
 void bitbang_jtag_on() {
+    init_tables();
+
     // led=Pin(gpio_led,Pin.OUT)
     // tms=Pin(gpio_tms,Pin.OUT)
     // tck=Pin(gpio_tck,Pin.OUT)
@@ -110,12 +167,16 @@ void bitbang_jtag_off() {
 }
 
 void spi_jtag_on() {
+    g_spiJtag = true;
+
     // global hwspi,swspi
     // hwspi=SPI(spi_channel, baudrate=spi_freq, polarity=1, phase=1, bits=8, firstbit=SPI.MSB, sck=Pin(gpio_tck), mosi=Pin(gpio_tdi), miso=Pin(gpio_tdo))
     // swspi=SPI(-1, baudrate=spi_freq, polarity=1, phase=1, bits=8, firstbit=SPI.MSB, sck=Pin(gpio_tck), mosi=Pin(gpio_tdi), miso=Pin(gpio_tdo))
 }
 
 void spi_jtag_off() {
+    g_spiJtag = false;
+
     // hwspi.deinit()
     // del hwspi
 
@@ -140,6 +201,45 @@ void send_tms0111() {
     send_tms(1); // # -> select DR scan
 }
 
+// Shifts whole bytes LSB first with TMS low, TDO is not sampled.
+static void send_bytes_lsb1st(const uint8_t *buf, int bufLen) {
+    if (g_shiftMethod == SHIFT_METHOD_SPI && g_spiJtag) {
+        // SPI sends MSB first
+        uint8_t reversed[64];
+        while (bufLen > 0) {
+            int n = MIN(bufLen, (int)sizeof(reversed));
+            for (int i = 0; i < n; i++) {
+                reversed[i] = g_bitReverseTable[buf[i]];
+            }
+            spi_transmit(reversed, n);
+            buf += n;
+            bufLen -= n;
+        }
+    } else if (g_shiftMethod != SHIFT_METHOD_BITBANG) {
+        for (int i = 0; i < bufLen; i++) {
+            const uint32_t *bits = g_tdiToggleTable[buf[i]];
+            for (int nf = 0; nf < 8; nf++) {
+                tdi.write(bits[nf]);
+                tck.off();
+                tck.on();
+            }
+        }
+    } else {
+        for (int i = 0; i < bufLen; i++) {
+            uint8_t val = buf[i];
+            for (int nf = 0; nf < 8; nf++) {
+                if ((val >> nf) & 1) {
+                    tdi.on();
+                } else {
+                    tdi.off();
+                }
+                tck.off();
+                tck.on();
+            }
+        }
+    }
+}
+
 void send_read_buf_lsb1st(const uint8_t *buf, int bufLen, int last, uint8_t *w) {
     const uint8_t *p = buf;
     int l = bufLen;
@@ -147,26 +247,28 @@ void send_read_buf_lsb1st(const uint8_t *buf, int bufLen, int last, uint8_t *w)
     int val = 0;
     tms.off();
 
-    for (int i = 0; i < l - 1; i++) {
-        uint8_t byte = 0;
-        uint8_t val = p[i];
-
-        for (int nf = 0; nf < 8; nf++) {
-            if ((val >> nf) & 1) {
-                tdi.on();
-            } else {
-                tdi.off();
-            }
-            tck.off();
-            tck.on();
-            if (tdo.value()) {
-                byte |= 1 << nf;
+    if (w) {
+        for (int i = 0; i < l - 1; i++) {
+            uint8_t byte = 0;
+            uint8_t val = p[i];
+
+            for (int nf = 0; nf < 8; nf++) {
+                if ((val >> nf) & 1) {
+                    tdi.on();
+                } else {
+                    tdi.off();
+                }
+                tck.off();
+                tck.on();
+                if (tdo.value()) {
+                    byte |= 1 << nf;
+                }
             }
-        }
 
-        if (w) {
             w[i] = byte; // # write byte
         }
+    } else {
+        send_bytes_lsb1st(p, l - 1);
     }
 
     uint8_t byte = 0;
@@ -179,7 +281,7 @@ void send_read_buf_lsb1st(const uint8_t *buf, int bufLen, int last, uint8_t *w)
         }
         tck.off();
         tck.on();
-        if (tdo.value()) {
+        if (w && tdo.value()) {
             byte |= 1 << nf;
         }
     }
@@ -195,10 +297,10 @@ void send_read_buf_lsb1st(const uint8_t *buf, int bufLen, int last, uint8_t *w)
     }
     tck.off();
     tck.on();
-    if (tdo.value()) {
-        byte |= 1 << 7;
-    }
     if (w) {
+        if (tdo.value()) {
+            byte |= 1 << 7;
+        }
         w[l - 1] = byte; //# write last byte
     }
 }
@@ -289,8 +391,6 @@ void check_response(uint32_t response, uint32_t expected, uint32_t mask = 0xFFFF
 }
 
 void common_open() {
-    spi_jtag_on();
-
     // hwspi.init(sck=Pin(gpio_tcknc)) # avoid TCK-glitch
 
     bitbang_jtag_on();
@@ -339,6 +439,7 @@ void prog_open() {
     send_tms(0); // # ->capture DR
     send_tms(0); // # ->shift DR
     // # switch from bitbanging to SPI mode
+    spi_jtag_on();
 
     // hwspi.init(sck = Pin(gpio_tck)) // # 1 TCK - glitch ? TDI = 0
 
@@ -401,11 +502,7 @@ bool prog_close() {
 }
 
 void write_block(uint8_t *block, uint32_t blockLen) {
-#if defined(EEZ_PLATFORM_STM32)
-    spi::select(0, spi::CHIP_FPGA);
-    spi::transmit(0, block, blockLen);
-    spi::deselect(0);
-#endif
+    spi_transmit(block, blockLen);
 }
 
 scpi_result_t prog(const char *filePath) {
@@ -463,5 +560,67 @@ Exit:
     return SCPI_RES_OK;
 }
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+
+int testJtag(JtagTestResult *results, int maxResults) {
+    static const char *SHIFT_METHOD_NAMES[] = { "bitbang", "toggle table", "spi" };
+    static const int TEST_SIZE = 4096;
+
+    static uint8_t pattern[TEST_SIZE];
+    uint32_t random = 1;
+    uint32_t expectedHash = 2166136261u;
+    for (int i = 0; i < TEST_SIZE; i++) {
+        random = random * 1103515245 + 12345;
+        pattern[i] = (uint8_t)(random >> 16);
+        expectedHash = (expectedHash ^ pattern[i]) * 16777619u;
+    }
+
+    ShiftMethod savedShiftMethod = g_shiftMethod;
+
+    int numResults = 0;
+
+    for (int method = SHIFT_METHOD_BITBANG; method <= SHIFT_METHOD_SPI && numResults < maxResults; method++) {
+        g_shiftMethod = (ShiftMethod)method;
+
+        tap_model::reset();
+
+        bitbang_jtag_on();
+
+        reset_tap();
+        runtest_idle(1, 0);
+
+        // readback is always done by bitbanging
+        sir(0xE0); // # IDCODE
+        uint32_t idcode = 0;
+        sdr_response((uint8_t *)&idcode, 4);
+
+        sir(0x7A); // # LSC_BITSTREAM_BURST
+        // SPI owns TCK only for the bulk shift, same as when programming
+        spi_jtag_on();
+        uint32_t start = micros();
+        sdr(pattern, TEST_SIZE);
+        uint32_t duration = micros() - start;
+        spi_jtag_off();
+
+        reset_tap();
+
+        bitbang_jtag_off();
+
+        JtagTestResult &result = results[numResults++];
+        result.name = SHIFT_METHOD_NAMES[method];
+        result.passed =
+            idcode == tap_model::IDCODE &&
+            tap_model::g_statistics.lastDrBits == TEST_SIZE * 8 &&
+            tap_model::g_statistics.lastDrHash == expectedHash;
+        result.kbPerSecond = duration > 0 ? TEST_SIZE * 1000000.0f / 1024 / duration : 0.0f;
+    }
+
+    g_shiftMethod = savedShiftMethod;
+
+    return numResults;
+}
+
+#endif
+
 } // namespace fpga
 } // namespace eez
@@ -21,7 +21,28 @@
 namespace eez {
 namespace fpga {
 
+enum ShiftMethod {
+    SHIFT_METHOD_BITBANG,      // one GPIO write for each TDI bit
+    SHIFT_METHOD_TOGGLE_TABLE, // precomputed TDI BSRR values for each byte
+    SHIFT_METHOD_SPI           // SPI peripheral while in SPI JTAG mode (bulk shift), toggle table otherwise
+};
+
+// Used for data shifted without readback, i.e. SDR/SIR without response.
+extern ShiftMethod g_shiftMethod;
+
 scpi_result_t prog(const char *filePath);
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+struct JtagTestResult {
+    const char *name;
+    bool passed;
+    float kbPerSecond;
+};
+
+// Shifts test pattern into the simulated TAP with every shift method and
+// checks that TAP received the same data. Returns number of results.
+int testJtag(JtagTestResult *results, int maxResults);
+#endif
+
 } // namespace fpga
 } // namespace eez
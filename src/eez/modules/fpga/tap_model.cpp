@@ -0,0 +1,216 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+
+#include <eez/modules/fpga/tap_model.h>
+
+namespace eez {
+namespace fpga {
+namespace tap_model {
+
+enum TapState {
+    TEST_LOGIC_RESET,
+    RUN_TEST_IDLE,
+    SELECT_DR_SCAN,
+    CAPTURE_DR,
+    SHIFT_DR,
+    EXIT1_DR,
+    PAUSE_DR,
+    EXIT2_DR,
+    UPDATE_DR,
+    SELECT_IR_SCAN,
+    CAPTURE_IR,
+    SHIFT_IR,
+    EXIT1_IR,
+    PAUSE_IR,
+    EXIT2_IR,
+    UPDATE_IR
+};
+
+// next state for TMS=0 and TMS=1
+static const TapState NEXT_STATE[][2] = {
+    { RUN_TEST_IDLE, TEST_LOGIC_RESET }, // TEST_LOGIC_RESET
+    { RUN_TEST_IDLE, SELECT_DR_SCAN },   // RUN_TEST_IDLE
+    { CAPTURE_DR, SELECT_IR_SCAN },      // SELECT_DR_SCAN
+    { SHIFT_DR, EXIT1_DR },              // CAPTURE_DR
+    { SHIFT_DR, EXIT1_DR },              // SHIFT_DR
+    { PAUSE_DR, UPDATE_DR },             // EXIT1_DR
+    { PAUSE_DR, EXIT2_DR },              // PAUSE_DR
+    { SHIFT_DR, UPDATE_DR },             // EXIT2_DR
+    { RUN_TEST_IDLE, SELECT_DR_SCAN },   // UPDATE_DR
+    { CAPTURE_IR, TEST_LOGIC_RESET },    // SELECT_IR_SCAN
+    { SHIFT_IR, EXIT1_IR },              // CAPTURE_IR
+    { SHIFT_IR, EXIT1_IR },              // SHIFT_IR
+    { PAUSE_IR, UPDATE_IR },             // EXIT1_IR
+    { PAUSE_IR, EXIT2_IR },              // PAUSE_IR
+    { SHIFT_IR, UPDATE_IR },             // EXIT2_IR
+    { RUN_TEST_IDLE, SELECT_DR_SCAN }    // UPDATE_IR
+};
+
+static const uint8_t INSTR_ISC_ERASE = 0x0E;
+static const uint8_t INSTR_ISC_DISABLE = 0x26;
+static const uint8_t INSTR_LSC_READ_STATUS = 0x3C;
+static const uint8_t INSTR_LSC_BITSTREAM_BURST = 0x7A;
+static const uint8_t INSTR_IDCODE = 0xE0;
+
+static const uint32_t STATUS_DONE = 0x100;
+
+static const uint32_t FNV_OFFSET_BASIS = 2166136261u;
+static const uint32_t FNV_PRIME = 16777619u;
+
+Statistics g_statistics;
+
+static TapState g_state = TEST_LOGIC_RESET;
+static uint8_t g_instruction = INSTR_IDCODE;
+static uint8_t g_irShift;
+static uint64_t g_drShift;
+static uint32_t g_status;
+
+static bool g_tms;
+static bool g_tdi;
+static bool g_tck;
+static bool g_tdo;
+
+// bits shifted in during current DR scan
+static uint32_t g_drBits;
+static uint32_t g_drHash;
+static uint8_t g_drByte;
+
+static void captureDr() {
+    if (g_instruction == INSTR_IDCODE) {
+        g_drShift = IDCODE;
+    } else if (g_instruction == INSTR_LSC_READ_STATUS) {
+        g_drShift = g_status;
+    } else {
+        // USERCODE, BYPASS and everything else
+        g_drShift = 0;
+    }
+
+    g_drBits = 0;
+    g_drHash = FNV_OFFSET_BASIS;
+    g_drByte = 0;
+}
+
+static void shiftDr(bool tdi) {
+    g_tdo = g_drShift & 1;
+    g_drShift >>= 1;
+
+    if (tdi) {
+        g_drByte |= 1 << (g_drBits % 8);
+    }
+    if (++g_drBits % 8 == 0) {
+        g_drHash = (g_drHash ^ g_drByte) * FNV_PRIME;
+        g_drByte = 0;
+    }
+}
+
+static void updateDr() {
+    g_statistics.lastDrBits = g_drBits;
+    g_statistics.lastDrHash = g_drHash;
+
+    if (g_instruction == INSTR_ISC_ERASE) {
+        g_status &= ~STATUS_DONE;
+        g_statistics.bitstreamBits = 0;
+    } else if (g_instruction == INSTR_LSC_BITSTREAM_BURST) {
+        g_statistics.bitstreamBits += g_drBits;
+    }
+}
+
+static void updateIr() {
+    g_instruction = g_irShift;
+
+    if (g_instruction == INSTR_ISC_DISABLE && g_statistics.bitstreamBits > 0) {
+        g_status |= STATUS_DONE;
+    }
+}
+
+static void clock(bool tms, bool tdi) {
+    g_statistics.tckCycles++;
+
+    // action of the current state
+    if (g_state == CAPTURE_DR) {
+        captureDr();
+    } else if (g_state == SHIFT_DR) {
+        shiftDr(tdi);
+    } else if (g_state == CAPTURE_IR) {
+        g_irShift = 0x01;
+    } else if (g_state == SHIFT_IR) {
+        g_tdo = g_irShift & 1;
+        g_irShift = (g_irShift >> 1) | (tdi ? 0x80 : 0);
+    }
+
+    g_state = NEXT_STATE[g_state][tms ? 1 : 0];
+
+    // action on entering the new state
+    if (g_state == TEST_LOGIC_RESET) {
+        g_instruction = INSTR_IDCODE;
+    } else if (g_state == UPDATE_DR) {
+        updateDr();
+    } else if (g_state == UPDATE_IR) {
+        updateIr();
+    }
+}
+
+void reset() {
+    g_state = TEST_LOGIC_RESET;
+    g_instruction = INSTR_IDCODE;
+    g_status = 0;
+    g_tck = true;
+    g_tdo = false;
+
+    g_statistics.tckCycles = 0;
+    g_statistics.lastDrBits = 0;
+    g_statistics.lastDrHash = 0;
+    g_statistics.bitstreamBits = 0;
+}
+
+void writePin(uint32_t pin, bool state) {
+    if (pin == PIN_TMS) {
+        g_tms = state;
+    } else if (pin == PIN_TDI) {
+        g_tdi = state;
+    } else if (pin == PIN_TCK) {
+        if (!g_tck && state) {
+            clock(g_tms, g_tdi);
+        }
+        g_tck = state;
+    }
+}
+
+bool readPin(uint32_t pin) {
+    if (pin == PIN_TDO) {
+        return g_tdo;
+    }
+    return false;
+}
+
+void spiTransmit(const uint8_t *buf, int len) {
+    for (int i = 0; i < len; i++) {
+        for (int nf = 7; nf >= 0; nf--) {
+            g_tdi = (buf[i] >> nf) & 1;
+            clock(g_tms, g_tdi);
+        }
+    }
+}
+
+} // namespace tap_model
+} // namespace fpga
+} // namespace eez
+
+#endif // EEZ_PLATFORM_SIMULATOR
@@ -0,0 +1,61 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+
+#include <stdint.h>
+
+namespace eez {
+namespace fpga {
+namespace tap_model {
+
+// Simulator model of the FPGA JTAG TAP (IEEE 1149.1 state machine with
+// the subset of ECP5 instructions used by the programming sequence).
+
+static const uint32_t PIN_TMS = 1 << 0;
+static const uint32_t PIN_TDI = 1 << 1;
+static const uint32_t PIN_TDO = 1 << 2;
+static const uint32_t PIN_TCK = 1 << 3;
+
+static const uint32_t IDCODE = 0x41111043;
+
+struct Statistics {
+    uint32_t tckCycles;
+    uint32_t lastDrBits; // number of bits shifted in during last DR scan
+    uint32_t lastDrHash; // FNV-1a of bytes (assembled LSB first) shifted in during last DR scan
+    uint32_t bitstreamBits;
+};
+
+extern Statistics g_statistics;
+
+void reset();
+
+// TAP is clocked on TCK rising edge.
+void writePin(uint32_t pin, bool state);
+bool readPin(uint32_t pin);
+
+// Same as SPI peripheral shifting whole bytes MSB first on TDI/TCK, TDO is ignored.
+void spiTransmit(const uint8_t *buf, int len);
+
+} // namespace tap_model
+} // namespace fpga
+} // namespace eez
+
+#endif // EEZ_PLATFORM_SIMULATOR
@@ -28,6 +28,8 @@
 
 #include <eez/gui/gui.h>
 
+#include <eez/modules/mcu/text_cache.h>
+
 // TODO
 #include <eez/modules/psu/psu.h>
 #include <eez/modules/psu/persist_conf.h>
@@ -398,13 +400,21 @@ int8_t measureGlyph(uint8_t encoding, gui::font::Font &font) {
 }
 
 int measureStr(const char *text, int textLength, gui::font::Font &font, int max_width) {
+    bool useCache = text_cache::isEnabled();
+    if (useCache) {
+        int width;
+        if (text_cache::findTextWidth(text, textLength, font, width)) {
+            return max_width > 0 && width > max_width ? max_width : width;
+        }
+    }
+
     g_font = font;
 
     int width = 0;
 
     if (textLength == -1) {
-        char encoding;
-        while ((encoding = *text++) != 0) {
+        for (int i = 0; text[i]; ++i) {
+            char encoding = text[i];
             int glyph_width = measureGlyph(encoding);
             if (max_width > 0 && width + glyph_width > max_width) {
                 return max_width;
@@ -422,6 +432,10 @@ int measureStr(const char *text, int textLength, gui::font::Font &font, int max_
         }
     }
 
+    if (useCache) {
+        text_cache::addTextWidth(text, textLength, font, width);
+    }
+
     return width;
 }
 
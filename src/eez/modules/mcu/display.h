@@ -85,6 +85,19 @@ uint8_t setOpacity(uint8_t opacity);
 uint8_t getOpacity();
 
 const uint8_t * takeScreenshot();
+// Same as takeScreenshot but pixels are left in RGB565 format.
+const uint16_t *takeScreenshotRGB565();
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+struct RenderBenchmarkResult {
+    const char *name;
+    float fps;
+};
+
+// Redraws active page numFrames times with every available pixel kernels implementation.
+// Returns number of results.
+int runRenderBenchmark(int numFrames, RenderBenchmarkResult *results, int maxResults);
+#endif
 
 void clearDirty();
 // void markDirty(int x1, int y1, int x2, int y2);
@@ -31,6 +31,8 @@
 #include <cmsis_os.h>
 
 #include <eez/modules/mcu/display.h>
+#include <eez/modules/mcu/simulator/pixel_ops.h>
+#include <eez/modules/mcu/text_cache.h>
 
 #include <eez/modules/psu/gui/psu.h>
 #include <eez/debug.h>
@@ -62,6 +64,12 @@ static uint32_t *g_buffer;
 static uint32_t *g_lastBuffer;
 
 static bool g_takeScreenshot;
+static bool g_screenshotRGB565;
+
+static int g_benchmarkNumFrames;
+static RenderBenchmarkResult *g_benchmarkResults;
+static int g_benchmarkMaxResults;
+static int g_benchmarkNumResults;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -160,6 +168,8 @@ void turnOn() {
     if (!isOn()) {
         g_isOn = true;
 
+        selectPixelOps(PIXEL_OPS_AUTO);
+
         memset(VRAM_BUFFER1_START_ADDRESS, 0, VRAM_BUFFER_SIZE);
         memset(VRAM_BUFFER2_START_ADDRESS, 0, VRAM_BUFFER_SIZE);
         memset(VRAM_ANIMATION_BUFFER1_START_ADDRESS, 0, VRAM_BUFFER_SIZE);
@@ -252,6 +262,21 @@ void doTakeScreenshot() {
 
     int srcAdvance = (DISPLAY_WIDTH - 480) * 4;
 
+    if (g_screenshotRGB565) {
+        uint16_t *dst16 = (uint16_t *)dst;
+
+        for (int y = 0; y < 272; y++) {
+            for (int x = 0; x < 480; x++) {
+                *dst16++ = RGB_TO_COLOR(src[2], src[1], src[0]);
+                src += 4;
+            }
+            src += srcAdvance;
+        }
+
+        g_takeScreenshot = false;
+        return;
+    }
+
     for (int y = 0; y < 272; y++) {
         for (int x = 0; x < 480; x++) {
             uint8_t b = *src++;
@@ -270,6 +295,42 @@ void doTakeScreenshot() {
 
 }
 
+static float measureRenderFps(int numFrames) {
+    uint32_t start = micros();
+
+    for (int i = 0; i < numFrames; i++) {
+        beginBuffersDrawing();
+        refreshScreen();
+        gui::updateScreen();
+        endBuffersDrawing();
+    }
+
+    uint32_t duration = micros() - start;
+
+    return duration > 0 ? numFrames * 1000000.0f / duration : 0.0f;
+}
+
+static void doRenderBenchmark() {
+    const PixelOps *selectedPixelOps = g_pixelOps;
+
+    static const PixelOpsType types[] = { PIXEL_OPS_PORTABLE, PIXEL_OPS_SSE2, PIXEL_OPS_AVX2 };
+
+    g_benchmarkNumResults = 0;
+    for (unsigned i = 0; i < sizeof(types) / sizeof(PixelOpsType) && g_benchmarkNumResults < g_benchmarkMaxResults; i++) {
+        if (selectPixelOps(types[i])) {
+            RenderBenchmarkResult &result = g_benchmarkResults[g_benchmarkNumResults++];
+            result.name = g_pixelOps->name;
+            result.fps = measureRenderFps(g_benchmarkNumFrames);
+        }
+    }
+
+    g_pixelOps = selectedPixelOps;
+
+    refreshScreen();
+
+    g_benchmarkNumFrames = 0;
+}
+
 void sync() {
     static uint32_t g_lastTickCount;
     uint32_t tickCount = millis();
@@ -301,6 +362,10 @@ void sync() {
         doTakeScreenshot();
     }
 
+    if (g_benchmarkNumFrames > 0) {
+        doRenderBenchmark();
+    }
+
     if (isDirty()) {
         updateScreen(g_buffer);
 
@@ -342,6 +407,7 @@ int getDisplayHeight() {
 ////////////////////////////////////////////////////////////////////////////////
 
 const uint8_t *takeScreenshot() {
+	g_screenshotRGB565 = false;
 	g_takeScreenshot = true;
 
 #ifdef __EMSCRIPTEN__
@@ -355,27 +421,47 @@ const uint8_t *takeScreenshot() {
     return SCREENSHOOT_BUFFER_START_ADDRESS;
 }
 
-////////////////////////////////////////////////////////////////////////////////
+const uint16_t *takeScreenshotRGB565() {
+	g_screenshotRGB565 = true;
+	g_takeScreenshot = true;
 
-static void doDrawGlyph(const gui::font::Glyph &glyph, int x_glyph, int y_glyph, int width, int height, int offset, int iStartByte) {
-    uint32_t pixel;
-    ((uint8_t *)&pixel)[0] = COLOR_TO_B(g_fc);
-    ((uint8_t *)&pixel)[1] = COLOR_TO_G(g_fc);
-    ((uint8_t *)&pixel)[2] = COLOR_TO_R(g_fc);
-    uint8_t *pixelAlpha = ((uint8_t *)&pixel) + 3;
+#ifdef __EMSCRIPTEN__
+    doTakeScreenshot();
+#endif
 
-    const uint8_t *src = glyph.data + offset + iStartByte;
-    int nlSrc = glyph.width - width;
+	do {
+		osDelay(0);
+	} while (g_takeScreenshot);
 
-    uint32_t *dst = g_buffer + y_glyph * DISPLAY_WIDTH + x_glyph;
-    int nlDst = DISPLAY_WIDTH - width;
+    return (const uint16_t *)SCREENSHOOT_BUFFER_START_ADDRESS;
+}
 
-    for (const uint8_t *srcEnd = src + height * glyph.width; src != srcEnd; src += nlSrc, dst += nlDst) {
-        for (uint32_t *dstEnd = dst + width; dst != dstEnd; src++, dst++) {
-            *pixelAlpha = *src;
-            *dst = blendColor(pixel, *dst);
-        }
+int runRenderBenchmark(int numFrames, RenderBenchmarkResult *results, int maxResults) {
+    if (!isOn() || numFrames <= 0) {
+        return 0;
     }
+
+    g_benchmarkResults = results;
+    g_benchmarkMaxResults = maxResults;
+    g_benchmarkNumFrames = numFrames;
+
+#ifdef __EMSCRIPTEN__
+    doRenderBenchmark();
+#endif
+
+    do {
+        osDelay(0);
+    } while (g_benchmarkNumFrames > 0);
+
+    return g_benchmarkNumResults;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static void doDrawGlyph(const gui::font::Glyph &glyph, int x_glyph, int y_glyph, int width, int height, int offset, int iStartByte) {
+    const uint8_t *src = glyph.data + offset + iStartByte;
+    uint32_t *dst = g_buffer + y_glyph * DISPLAY_WIDTH + x_glyph;
+    g_pixelOps->blendGlyph(dst, DISPLAY_WIDTH, src, glyph.width, width, height, color16to32(g_fc, 0));
 }
 
 static int8_t drawGlyph(int x1, int y1, int clip_x1, int clip_y1, int clip_x2, int clip_y2, uint8_t encoding) {
@@ -467,19 +553,10 @@ void fillRect(int x1, int y1, int x2, int y2, int r) {
         uint32_t *dst = g_buffer + y1 * DISPLAY_WIDTH + x1;
         int width = x2 - x1 + 1;
         int height = y2 - y1 + 1;
-        int nl = DISPLAY_WIDTH - width;
         if (g_opacity == 255) {
-            for (uint32_t *dstEnd = dst + height * DISPLAY_WIDTH; dst != dstEnd; dst += nl) {
-                for (uint32_t *lineEnd = dst + width; dst != lineEnd; dst++) {
-                    *dst = color32;
-                }
-            }
+            g_pixelOps->fill(dst, DISPLAY_WIDTH, width, height, color32);
         } else {
-            for (uint32_t *dstEnd = dst + height * DISPLAY_WIDTH; dst != dstEnd; dst += nl) {
-                for (uint32_t *lineEnd = dst + width; dst != lineEnd; dst++) {
-                    *dst = blendColor(color32, *dst);
-                }
-            }
+            g_pixelOps->fillBlend(dst, DISPLAY_WIDTH, width, height, color32);
         }
     } else {
         fillRoundedRect(x1, y1, x2, y2, r);
@@ -489,15 +566,8 @@ void fillRect(int x1, int y1, int x2, int y2, int r) {
 }
 
 void fillRect(void *dstBuffer, int x1, int y1, int x2, int y2) {
-    uint32_t color32 = color16to32(g_fc);
     uint32_t *dst = (uint32_t *)dstBuffer + y1 * DISPLAY_WIDTH + x1;
-    int nl = DISPLAY_WIDTH - (x2 - x1 + 1);
-    for (int y = y1; y <= y2; y++) {
-        for (int x = x1; x <= x2; x++) {
-            *dst++ = color32;
-        }
-        dst += nl;
-    }
+    g_pixelOps->fill(dst, DISPLAY_WIDTH, x2 - x1 + 1, y2 - y1 + 1, color16to32(g_fc));
 
     markDirty(x1, y1, x2, y2);
 }
@@ -551,10 +621,10 @@ void bitBlt(void *src, int x1, int y1, int x2, int y2) {
 }
 
 void bitBlt(void *src, void *dst, int x1, int y1, int x2, int y2) {
-    for (int y = y1; y <= y2; ++y) {
-        for (int x = x1; x <= x2; ++x) {
-            int i = y * DISPLAY_WIDTH + x;
-            ((uint32_t *)dst)[i] = ((uint32_t *)src)[i];
+    if (x2 >= x1) {
+        for (int y = y1; y <= y2; ++y) {
+            int i = y * DISPLAY_WIDTH + x1;
+            memcpy((uint32_t *)dst + i, (uint32_t *)src + i, (x2 - x1 + 1) * sizeof(uint32_t));
         }
     }
 
@@ -566,23 +636,17 @@ void bitBlt(void *src, void *dst, int sx, int sy, int sw, int sh, int dx, int dy
         dst = g_buffer;
     }
 
+    uint32_t *srcLine = (uint32_t *)src + sy * DISPLAY_WIDTH + sx;
+    uint32_t *dstLine = (uint32_t *)dst + dy * DISPLAY_WIDTH + dx;
+
     if (opacity == 255) {
-        for (int y = 0; y < sh; ++y) {
-            for (int x = 0; x < sw; ++x) {
-                ((uint32_t *)dst)[(dy + y) * DISPLAY_WIDTH + dx + x] = ((uint32_t *)src)[(sy + y) * DISPLAY_WIDTH + sx + x];
+        if (sw > 0) {
+            for (int y = 0; y < sh; ++y, srcLine += DISPLAY_WIDTH, dstLine += DISPLAY_WIDTH) {
+                memcpy(dstLine, srcLine, sw * sizeof(uint32_t));
             }
         }
     } else {
-        for (int y = 0; y < sh; ++y) {
-            for (int x = 0; x < sw; ++x) {
-                uint8_t *p = (uint8_t *)&((uint32_t *)src)[(sy + y) * DISPLAY_WIDTH + sx + x];
-                p[3] = opacity;
-                ((uint32_t *)dst)[(dy + y) * DISPLAY_WIDTH + dx + x] = blendColor(
-                    ((uint32_t *)src)[(sy + y) * DISPLAY_WIDTH + sx + x],
-                    ((uint32_t *)dst)[(dy + y) * DISPLAY_WIDTH + dx + x]
-                );
-            }
-        }
+        g_pixelOps->blitOpacity(dstLine, DISPLAY_WIDTH, srcLine, DISPLAY_WIDTH, sw, sh, opacity);
     }
 }
 
@@ -630,7 +694,35 @@ void drawBitmap(Image *image, int x, int y) {
     markDirty(x, y, x + image->width - 1, y + image->height - 1);
 }
 
+static bool drawCachedStr(const char *text, int textLength, int x, int y, int clip_x1, int clip_y1, int clip_x2, int clip_y2, gui::font::Font &font) {
+    if (!text_cache::isEnabled()) {
+        return false;
+    }
+
+    const text_cache::TextRun *run = text_cache::findTextRun(text, textLength, font);
+    if (!run) {
+        run = text_cache::addTextRun(text, textLength, font);
+        if (!run) {
+            return false;
+        }
+    }
+
+    const uint8_t *src;
+    int x1, y1, width, height;
+    if (text_cache::clipTextRun(*run, x, y, clip_x1, clip_y1, clip_x2, clip_y2, src, x1, y1, width, height)) {
+        uint32_t *dst = g_buffer + y1 * DISPLAY_WIDTH + x1;
+        g_pixelOps->blendGlyph(dst, DISPLAY_WIDTH, src, run->width, width, height, color16to32(g_fc, 0));
+    }
+
+    return true;
+}
+
 void drawStr(const char *text, int textLength, int x, int y, int clip_x1, int clip_y1, int clip_x2, int clip_y2, gui::font::Font &font, int cursorPosition) {
+    if (cursorPosition == -1 && drawCachedStr(text, textLength, x, y, clip_x1, clip_y1, clip_x2, clip_y2, font)) {
+        markDirty(clip_x1, clip_y1, clip_x2, clip_y2);
+        return;
+    }
+
     g_font = font;
 
     if (textLength == -1) {
@@ -0,0 +1,429 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if OPTION_DISPLAY
+
+#include <string.h>
+
+#include <eez/modules/mcu/display.h>
+#include <eez/modules/mcu/simulator/pixel_ops.h>
+
+#if !defined(__EMSCRIPTEN__) && (defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || defined(_M_IX86))
+#define PIXEL_OPS_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER)
+#include <intrin.h>
+#define TARGET_SSE2
+#define TARGET_AVX2
+#else
+#define TARGET_SSE2 __attribute__((target("sse2")))
+#define TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace eez {
+namespace mcu {
+namespace display {
+
+////////////////////////////////////////////////////////////////////////////////
+// portable
+
+static void fillPortable(uint32_t *dst, int dstStride, int width, int height, uint32_t color) {
+    for (int y = 0; y < height; y++, dst += dstStride) {
+        for (int x = 0; x < width; x++) {
+            dst[x] = color;
+        }
+    }
+}
+
+static void fillBlendPortable(uint32_t *dst, int dstStride, int width, int height, uint32_t color) {
+    for (int y = 0; y < height; y++, dst += dstStride) {
+        for (int x = 0; x < width; x++) {
+            dst[x] = blendColor(color, dst[x]);
+        }
+    }
+}
+
+static void blendGlyphPortable(uint32_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height, uint32_t color) {
+    color &= 0x00FFFFFF;
+    for (int y = 0; y < height; y++, dst += dstStride, src += srcStride) {
+        for (int x = 0; x < width; x++) {
+            dst[x] = blendColor(color | (src[x] << 24), dst[x]);
+        }
+    }
+}
+
+static void blitOpacityPortable(uint32_t *dst, int dstStride, const uint32_t *src, int srcStride, int width, int height, uint8_t opacity) {
+    uint32_t alpha = opacity << 24;
+    for (int y = 0; y < height; y++, dst += dstStride, src += srcStride) {
+        for (int x = 0; x < width; x++) {
+            dst[x] = blendColor((src[x] & 0x00FFFFFF) | alpha, dst[x]);
+        }
+    }
+}
+
+static const PixelOps g_pixelOpsPortable = {
+    "portable",
+    fillPortable,
+    fillBlendPortable,
+    blendGlyphPortable,
+    blitOpacityPortable
+};
+
+#if PIXEL_OPS_X86
+
+////////////////////////////////////////////////////////////////////////////////
+// SSE2
+
+// Same arithmetic as blendColor(), 4 pixels at once. Channel products are
+// smaller than 2^16 so 16-bit multiply is enough and conversion to float
+// is exact, which keeps the result identical to the scalar version.
+TARGET_SSE2 static inline __m128i blend4(__m128i fg, __m128i bg) {
+    const __m128i mask = _mm_set1_epi32(0xFF);
+    const __m128 v0 = _mm_setzero_ps();
+    const __m128 v255 = _mm_set1_ps(255.0f);
+
+    __m128i fa = _mm_srli_epi32(fg, 24);
+    __m128i fr = _mm_and_si128(_mm_srli_epi32(fg, 16), mask);
+    __m128i fgr = _mm_and_si128(_mm_srli_epi32(fg, 8), mask);
+    __m128i fb = _mm_and_si128(fg, mask);
+
+    __m128i ba = _mm_srli_epi32(bg, 24);
+    __m128i br = _mm_and_si128(_mm_srli_epi32(bg, 16), mask);
+    __m128i bgr = _mm_and_si128(_mm_srli_epi32(bg, 8), mask);
+    __m128i bb = _mm_and_si128(bg, mask);
+
+    __m128 alphaMult = _mm_div_ps(_mm_cvtepi32_ps(_mm_mullo_epi16(fa, ba)), v255);
+    __m128 alphaOut = _mm_sub_ps(_mm_cvtepi32_ps(_mm_add_epi32(fa, ba)), alphaMult);
+
+#define BLEND_CHANNEL(F, B) \
+    _mm_cvttps_epi32(_mm_max_ps(_mm_min_ps(_mm_div_ps(_mm_sub_ps( \
+        _mm_cvtepi32_ps(_mm_add_epi32(_mm_mullo_epi16(F, fa), _mm_mullo_epi16(B, ba))), \
+        _mm_mul_ps(_mm_cvtepi32_ps(B), alphaMult)), alphaOut), v255), v0))
+
+    __m128i r = BLEND_CHANNEL(fr, br);
+    __m128i g = BLEND_CHANNEL(fgr, bgr);
+    __m128i b = BLEND_CHANNEL(fb, bb);
+
+#undef BLEND_CHANNEL
+
+    __m128i a = _mm_cvttps_epi32(alphaOut);
+
+    __m128i result = _mm_or_si128(
+        _mm_or_si128(b, _mm_slli_epi32(g, 8)),
+        _mm_or_si128(_mm_slli_epi32(r, 16), _mm_slli_epi32(a, 24)));
+
+    // fully transparent over fully transparent gives transparent black
+    return _mm_andnot_si128(_mm_castps_si128(_mm_cmpeq_ps(alphaOut, v0)), result);
+}
+
+TARGET_SSE2 static void fillSse2(uint32_t *dst, int dstStride, int width, int height, uint32_t color) {
+    __m128i color4 = _mm_set1_epi32(color);
+    for (int y = 0; y < height; y++, dst += dstStride) {
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            _mm_storeu_si128((__m128i *)(dst + x), color4);
+        }
+        for (; x < width; x++) {
+            dst[x] = color;
+        }
+    }
+}
+
+TARGET_SSE2 static void fillBlendSse2(uint32_t *dst, int dstStride, int width, int height, uint32_t color) {
+    __m128i color4 = _mm_set1_epi32(color);
+    for (int y = 0; y < height; y++, dst += dstStride) {
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            __m128i bg = _mm_loadu_si128((const __m128i *)(dst + x));
+            _mm_storeu_si128((__m128i *)(dst + x), blend4(color4, bg));
+        }
+        for (; x < width; x++) {
+            dst[x] = blendColor(color, dst[x]);
+        }
+    }
+}
+
+TARGET_SSE2 static void blendGlyphSse2(uint32_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height, uint32_t color) {
+    color &= 0x00FFFFFF;
+    const __m128i zero = _mm_setzero_si128();
+    __m128i color4 = _mm_set1_epi32(color);
+    __m128i opaque4 = _mm_set1_epi32(color | 0xFF000000);
+
+    for (int y = 0; y < height; y++, dst += dstStride, src += srcStride) {
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            int32_t alpha;
+            memcpy(&alpha, src + x, 4);
+            if (alpha == 0) {
+                // blending with zero alpha leaves destination as it is
+                continue;
+            }
+
+            __m128i alpha4 = _mm_cvtsi32_si128(alpha);
+            if (alpha == -1) {
+                _mm_storeu_si128((__m128i *)(dst + x), opaque4);
+                continue;
+            }
+
+            alpha4 = _mm_unpacklo_epi16(_mm_unpacklo_epi8(alpha4, zero), zero);
+            __m128i fg = _mm_or_si128(color4, _mm_slli_epi32(alpha4, 24));
+            __m128i bg = _mm_loadu_si128((const __m128i *)(dst + x));
+            _mm_storeu_si128((__m128i *)(dst + x), blend4(fg, bg));
+        }
+        for (; x < width; x++) {
+            dst[x] = blendColor(color | (src[x] << 24), dst[x]);
+        }
+    }
+}
+
+TARGET_SSE2 static void blitOpacitySse2(uint32_t *dst, int dstStride, const uint32_t *src, int srcStride, int width, int height, uint8_t opacity) {
+    const __m128i rgbMask = _mm_set1_epi32(0x00FFFFFF);
+    uint32_t alpha = opacity << 24;
+    __m128i alpha4 = _mm_set1_epi32(alpha);
+    for (int y = 0; y < height; y++, dst += dstStride, src += srcStride) {
+        int x = 0;
+        for (; x + 4 <= width; x += 4) {
+            __m128i fg = _mm_or_si128(_mm_and_si128(_mm_loadu_si128((const __m128i *)(src + x)), rgbMask), alpha4);
+            __m128i bg = _mm_loadu_si128((const __m128i *)(dst + x));
+            _mm_storeu_si128((__m128i *)(dst + x), blend4(fg, bg));
+        }
+        for (; x < width; x++) {
+            dst[x] = blendColor((src[x] & 0x00FFFFFF) | alpha, dst[x]);
+        }
+    }
+}
+
+static const PixelOps g_pixelOpsSse2 = {
+    "sse2",
+    fillSse2,
+    fillBlendSse2,
+    blendGlyphSse2,
+    blitOpacitySse2
+};
+
+////////////////////////////////////////////////////////////////////////////////
+// AVX2
+
+TARGET_AVX2 static inline __m256i blend8(__m256i fg, __m256i bg) {
+    const __m256i mask = _mm256_set1_epi32(0xFF);
+    const __m256 v0 = _mm256_setzero_ps();
+    const __m256 v255 = _mm256_set1_ps(255.0f);
+
+    __m256i fa = _mm256_srli_epi32(fg, 24);
+    __m256i fr = _mm256_and_si256(_mm256_srli_epi32(fg, 16), mask);
+    __m256i fgr = _mm256_and_si256(_mm256_srli_epi32(fg, 8), mask);
+    __m256i fb = _mm256_and_si256(fg, mask);
+
+    __m256i ba = _mm256_srli_epi32(bg, 24);
+    __m256i br = _mm256_and_si256(_mm256_srli_epi32(bg, 16), mask);
+    __m256i bgr = _mm256_and_si256(_mm256_srli_epi32(bg, 8), mask);
+    __m256i bb = _mm256_and_si256(bg, mask);
+
+    __m256 alphaMult = _mm256_div_ps(_mm256_cvtepi32_ps(_mm256_mullo_epi16(fa, ba)), v255);
+    __m256 alphaOut = _mm256_sub_ps(_mm256_cvtepi32_ps(_mm256_add_epi32(fa, ba)), alphaMult);
+
+#define BLEND_CHANNEL(F, B) \
+    _mm256_cvttps_epi32(_mm256_max_ps(_mm256_min_ps(_mm256_div_ps(_mm256_sub_ps( \
+        _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_mullo_epi16(F, fa), _mm256_mullo_epi16(B, ba))), \
+        _mm256_mul_ps(_mm256_cvtepi32_ps(B), alphaMult)), alphaOut), v255), v0))
+
+    __m256i r = BLEND_CHANNEL(fr, br);
+    __m256i g = BLEND_CHANNEL(fgr, bgr);
+    __m256i b = BLEND_CHANNEL(fb, bb);
+
+#undef BLEND_CHANNEL
+
+    __m256i a = _mm256_cvttps_epi32(alphaOut);
+
+    __m256i result = _mm256_or_si256(
+        _mm256_or_si256(b, _mm256_slli_epi32(g, 8)),
+        _mm256_or_si256(_mm256_slli_epi32(r, 16), _mm256_slli_epi32(a, 24)));
+
+    return _mm256_andnot_si256(_mm256_castps_si256(_mm256_cmp_ps(alphaOut, v0, _CMP_EQ_OQ)), result);
+}
+
+TARGET_AVX2 static void fillAvx2(uint32_t *dst, int dstStride, int width, int height, uint32_t color) {
+    __m256i color8 = _mm256_set1_epi32(color);
+    for (int y = 0; y < height; y++, dst += dstStride) {
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            _mm256_storeu_si256((__m256i *)(dst + x), color8);
+        }
+        for (; x < width; x++) {
+            dst[x] = color;
+        }
+    }
+}
+
+TARGET_AVX2 static void fillBlendAvx2(uint32_t *dst, int dstStride, int width, int height, uint32_t color) {
+    __m256i color8 = _mm256_set1_epi32(color);
+    for (int y = 0; y < height; y++, dst += dstStride) {
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            __m256i bg = _mm256_loadu_si256((const __m256i *)(dst + x));
+            _mm256_storeu_si256((__m256i *)(dst + x), blend8(color8, bg));
+        }
+        for (; x < width; x++) {
+            dst[x] = blendColor(color, dst[x]);
+        }
+    }
+}
+
+TARGET_AVX2 static void blendGlyphAvx2(uint32_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height, uint32_t color) {
+    color &= 0x00FFFFFF;
+    __m256i color8 = _mm256_set1_epi32(color);
+    __m256i opaque8 = _mm256_set1_epi32(color | 0xFF000000);
+
+    for (int y = 0; y < height; y++, dst += dstStride, src += srcStride) {
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            int64_t alpha;
+            memcpy(&alpha, src + x, 8);
+            if (alpha == 0) {
+                continue;
+            }
+
+            if (alpha == -1) {
+                _mm256_storeu_si256((__m256i *)(dst + x), opaque8);
+                continue;
+            }
+
+            __m256i alpha8 = _mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)(src + x)));
+            __m256i fg = _mm256_or_si256(color8, _mm256_slli_epi32(alpha8, 24));
+            __m256i bg = _mm256_loadu_si256((const __m256i *)(dst + x));
+            _mm256_storeu_si256((__m256i *)(dst + x), blend8(fg, bg));
+        }
+        for (; x < width; x++) {
+            dst[x] = blendColor(color | (src[x] << 24), dst[x]);
+        }
+    }
+}
+
+TARGET_AVX2 static void blitOpacityAvx2(uint32_t *dst, int dstStride, const uint32_t *src, int srcStride, int width, int height, uint8_t opacity) {
+    const __m256i rgbMask = _mm256_set1_epi32(0x00FFFFFF);
+    uint32_t alpha = opacity << 24;
+    __m256i alpha8 = _mm256_set1_epi32(alpha);
+    for (int y = 0; y < height; y++, dst += dstStride, src += srcStride) {
+        int x = 0;
+        for (; x + 8 <= width; x += 8) {
+            __m256i fg = _mm256_or_si256(_mm256_and_si256(_mm256_loadu_si256((const __m256i *)(src + x)), rgbMask), alpha8);
+            __m256i bg = _mm256_loadu_si256((const __m256i *)(dst + x));
+            _mm256_storeu_si256((__m256i *)(dst + x), blend8(fg, bg));
+        }
+        for (; x < width; x++) {
+            dst[x] = blendColor((src[x] & 0x00FFFFFF) | alpha, dst[x]);
+        }
+    }
+}
+
+static const PixelOps g_pixelOpsAvx2 = {
+    "avx2",
+    fillAvx2,
+    fillBlendAvx2,
+    blendGlyphAvx2,
+    blitOpacityAvx2
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+static bool cpuHasSse2() {
+#if defined(_M_X64) || defined(__x86_64__)
+    return true;
+#elif defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 1);
+    return (info[3] & (1 << 26)) != 0;
+#else
+    return __builtin_cpu_supports("sse2");
+#endif
+}
+
+static bool cpuHasAvx2() {
+#if defined(_MSC_VER)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) {
+        return false;
+    }
+
+    // OS must save YMM registers on context switch
+    __cpuid(info, 1);
+    if ((info[2] & (1 << 27)) == 0 || (_xgetbv(0) & 6) != 6) {
+        return false;
+    }
+
+    __cpuidex(info, 7, 0);
+    return (info[1] & (1 << 5)) != 0;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // PIXEL_OPS_X86
+
+////////////////////////////////////////////////////////////////////////////////
+
+const PixelOps *g_pixelOps = &g_pixelOpsPortable;
+
+bool selectPixelOps(PixelOpsType type) {
+#if PIXEL_OPS_X86
+    if (type == PIXEL_OPS_AUTO) {
+        if (cpuHasAvx2()) {
+            type = PIXEL_OPS_AVX2;
+        } else if (cpuHasSse2()) {
+            type = PIXEL_OPS_SSE2;
+        } else {
+            type = PIXEL_OPS_PORTABLE;
+        }
+    }
+
+    if (type == PIXEL_OPS_AVX2) {
+        if (!cpuHasAvx2()) {
+            return false;
+        }
+        g_pixelOps = &g_pixelOpsAvx2;
+        return true;
+    }
+
+    if (type == PIXEL_OPS_SSE2) {
+        if (!cpuHasSse2()) {
+            return false;
+        }
+        g_pixelOps = &g_pixelOpsSse2;
+        return true;
+    }
+#else
+    if (type == PIXEL_OPS_AUTO) {
+        type = PIXEL_OPS_PORTABLE;
+    }
+#endif
+
+    if (type == PIXEL_OPS_PORTABLE) {
+        g_pixelOps = &g_pixelOpsPortable;
+        return true;
+    }
+
+    return false;
+}
+
+} // namespace display
+} // namespace mcu
+} // namespace eez
+
+#endif // OPTION_DISPLAY
@@ -0,0 +1,60 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace eez {
+namespace mcu {
+namespace display {
+
+// Pixel kernels used by the simulator to draw into the RGBA8888 frame buffer.
+// All strides are in pixels. Blending gives the same result as blendColor().
+struct PixelOps {
+    const char *name;
+
+    // fill rectangle with opaque color
+    void (*fill)(uint32_t *dst, int dstStride, int width, int height, uint32_t color);
+
+    // blend color (alpha taken from color) over rectangle
+    void (*fillBlend)(uint32_t *dst, int dstStride, int width, int height, uint32_t color);
+
+    // blend color over rectangle, alpha is taken from A8 glyph bitmap
+    void (*blendGlyph)(uint32_t *dst, int dstStride, const uint8_t *src, int srcStride, int width, int height, uint32_t color);
+
+    // blend source over destination using constant opacity instead of source alpha
+    void (*blitOpacity)(uint32_t *dst, int dstStride, const uint32_t *src, int srcStride, int width, int height, uint8_t opacity);
+};
+
+enum PixelOpsType {
+    PIXEL_OPS_AUTO,
+    PIXEL_OPS_PORTABLE,
+    PIXEL_OPS_SSE2,
+    PIXEL_OPS_AVX2
+};
+
+extern const PixelOps *g_pixelOps;
+
+// Selects implementation, PIXEL_OPS_AUTO picks the best one supported by the CPU.
+// Returns false if requested implementation is not available.
+bool selectPixelOps(PixelOpsType type);
+
+} // namespace display
+} // namespace mcu
+} // namespace eez
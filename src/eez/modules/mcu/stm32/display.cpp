@@ -38,6 +38,7 @@
 
 #include <eez/gui/gui.h>
 #include <eez/modules/mcu/display.h>
+#include <eez/modules/mcu/text_cache.h>
 
 #include <eez/modules/psu/psu.h>
 #include <eez/modules/psu/persist_conf.h>
@@ -66,6 +67,7 @@ static uint16_t *g_buffer;
 static uint16_t *g_animationBuffer;
 
 static bool g_takeScreenshot;
+static bool g_screenshotRGB565;
 
 ////////////////////////////////////////////////////////////////////////////////
 
@@ -507,7 +509,11 @@ void sync() {
     }
 
     if (g_takeScreenshot) {
-    	bitBltRGB888(g_bufferOld, SCREENSHOOT_BUFFER_START_ADDRESS, 0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT);
+        if (g_screenshotRGB565) {
+            bitBlt(g_bufferOld, (uint16_t *)SCREENSHOOT_BUFFER_START_ADDRESS, 0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT);
+        } else {
+    	    bitBltRGB888(g_bufferOld, SCREENSHOOT_BUFFER_START_ADDRESS, 0, 0, DISPLAY_WIDTH, DISPLAY_HEIGHT);
+        }
         DMA2D_WAIT;
     	g_takeScreenshot = false;
     }
@@ -532,6 +538,7 @@ int getDisplayHeight() {
 ////////////////////////////////////////////////////////////////////////////////
 
 const uint8_t *takeScreenshot() {
+	g_screenshotRGB565 = false;
 	g_takeScreenshot = true;
 	do {
 		osDelay(0);
@@ -540,6 +547,16 @@ const uint8_t *takeScreenshot() {
 	return SCREENSHOOT_BUFFER_START_ADDRESS;
 }
 
+const uint16_t *takeScreenshotRGB565() {
+	g_screenshotRGB565 = true;
+	g_takeScreenshot = true;
+	do {
+		osDelay(0);
+	} while (g_takeScreenshot);
+
+	return (const uint16_t *)SCREENSHOOT_BUFFER_START_ADDRESS;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 static int8_t drawGlyph(int x1, int y1, int clip_x1, int clip_y1, int clip_x2, int clip_y2,
@@ -664,7 +681,37 @@ void drawBitmap(Image *image, int x, int y) {
     markDirty(x, y, x + image->width - 1, y + image->height - 1);
 }
 
+static bool drawCachedStr(const char *text, int textLength, int x, int y, int clip_x1, int clip_y1, int clip_x2, int clip_y2, gui::font::Font &font) {
+    if (!text_cache::isEnabled()) {
+        return false;
+    }
+
+    const text_cache::TextRun *run = text_cache::findTextRun(text, textLength, font);
+    if (!run) {
+        // DMA2D could still be reading mask memory that is about to be reused
+        DMA2D_WAIT;
+        run = text_cache::addTextRun(text, textLength, font);
+        if (!run) {
+            return false;
+        }
+    }
+
+    const uint8_t *src;
+    int x1, y1, width, height;
+    if (text_cache::clipTextRun(*run, x, y, clip_x1, clip_y1, clip_x2, clip_y2, src, x1, y1, width, height)) {
+        bitBltA8Init(g_fc);
+        bitBltA8(src, run->width - width, x1, y1, width, height);
+    }
+
+    return true;
+}
+
 void drawStr(const char *text, int textLength, int x, int y, int clip_x1, int clip_y1, int clip_x2, int clip_y2, gui::font::Font &font, int cursorPosition) {
+    if (cursorPosition == -1 && drawCachedStr(text, textLength, x, y, clip_x1, clip_y1, clip_x2, clip_y2, font)) {
+        markDirty(clip_x1, clip_y1, clip_x2, clip_y2);
+        return;
+    }
+
     g_font = font;
 
     bitBltA8Init(g_fc);
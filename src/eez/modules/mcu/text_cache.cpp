@@ -0,0 +1,454 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if OPTION_DISPLAY
+
+#include <string.h>
+
+#include <eez/memory.h>
+#include <eez/util.h>
+#include <eez/gui/gui.h>
+
+#include <eez/modules/mcu/text_cache.h>
+
+namespace eez {
+namespace mcu {
+namespace display {
+namespace text_cache {
+
+static const int NUM_ENTRIES = 256;
+static const int NUM_BUCKETS = 128;
+
+static const int16_t NO_SLOT = -1;
+static const int16_t SLOT_TOO_LARGE = -2;
+static const int16_t SLOT_EMPTY = -3; // nothing to draw, i.e. only spaces
+
+static const int16_t WIDTH_NOT_MEASURED = -1;
+
+struct SlotClass {
+    uint32_t slotSize;
+    int numSlots;
+};
+
+// Masks are stored in fixed size slots, LRU replacement is done per slot class.
+static const SlotClass SLOT_CLASSES[] = {
+    { 1024, 64 },
+    { 4 * 1024, 24 },
+    { 16 * 1024, 4 }
+};
+static const int NUM_SLOT_CLASSES = sizeof(SLOT_CLASSES) / sizeof(SlotClass);
+static const int NUM_SLOTS = 64 + 24 + 4;
+
+struct Entry {
+    uint32_t hash;
+    const uint8_t *fontData;
+    uint32_t lastUsed;
+    int16_t next;
+    int16_t slot;
+    int16_t width;
+    uint8_t textLength;
+    bool used;
+    char text[MAX_TEXT_LENGTH];
+    TextRun run;
+};
+
+struct Cache {
+    int16_t buckets[NUM_BUCKETS];
+    int16_t slotOwners[NUM_SLOTS];
+    Entry entries[NUM_ENTRIES];
+};
+
+static const uint32_t MASKS_OFFSET = (sizeof(Cache) + 3) / 4 * 4;
+
+static_assert(
+    MASKS_OFFSET + 64 * 1024 + 24 * 4 * 1024 + 4 * 16 * 1024 <= TEXT_CACHE_MEMORY_SIZE,
+    "TEXT_CACHE_MEMORY_SIZE too small"
+);
+
+Statistics g_statistics;
+
+static volatile bool g_initialized;
+static uint32_t g_lastUsedCounter;
+
+static Cache *cache() {
+    return (Cache *)TEXT_CACHE_MEMORY;
+}
+
+static uint8_t *slotMask(int slot) {
+    uint8_t *mask = TEXT_CACHE_MEMORY + MASKS_OFFSET;
+    for (int i = 0; i < NUM_SLOT_CLASSES; i++) {
+        if (slot < SLOT_CLASSES[i].numSlots) {
+            return mask + slot * SLOT_CLASSES[i].slotSize;
+        }
+        slot -= SLOT_CLASSES[i].numSlots;
+        mask += SLOT_CLASSES[i].numSlots * SLOT_CLASSES[i].slotSize;
+    }
+    return nullptr;
+}
+
+static void reset() {
+    for (int i = 0; i < NUM_BUCKETS; i++) {
+        cache()->buckets[i] = -1;
+    }
+
+    for (int i = 0; i < NUM_SLOTS; i++) {
+        cache()->slotOwners[i] = -1;
+    }
+
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        cache()->entries[i].used = false;
+    }
+
+    g_initialized = true;
+}
+
+static void init() {
+    if (!g_initialized) {
+        reset();
+    }
+}
+
+bool isEnabled() {
+#if OPTION_GUI_THREAD
+    return osThreadGetId() == gui::g_guiTaskHandle;
+#else
+    return true;
+#endif
+}
+
+static int getTextLength(const char *text, int textLength) {
+    int length = 0;
+    while ((textLength == -1 || length < textLength) && text[length]) {
+        if (++length > MAX_TEXT_LENGTH) {
+            break;
+        }
+    }
+    return length;
+}
+
+static uint32_t calcHash(const char *text, int textLength, const uint8_t *fontData) {
+    // FNV-1a
+    uint32_t hash = 2166136261u ^ (uint32_t)(uintptr_t)fontData;
+    for (int i = 0; i < textLength; i++) {
+        hash = (hash ^ (uint8_t)text[i]) * 16777619u;
+    }
+    return hash;
+}
+
+static Entry *findEntry(const char *text, int textLength, gui::font::Font &font) {
+    init();
+
+    textLength = getTextLength(text, textLength);
+    if (textLength > MAX_TEXT_LENGTH) {
+        return nullptr;
+    }
+
+    uint32_t hash = calcHash(text, textLength, font.fontData);
+
+    for (int16_t i = cache()->buckets[hash % NUM_BUCKETS]; i != -1;) {
+        Entry &entry = cache()->entries[i];
+        if (
+            entry.hash == hash && entry.fontData == font.fontData &&
+            entry.textLength == textLength && memcmp(entry.text, text, textLength) == 0
+        ) {
+            entry.lastUsed = ++g_lastUsedCounter;
+            return &entry;
+        }
+        i = entry.next;
+    }
+
+    return nullptr;
+}
+
+static void freeSlot(Entry &entry) {
+    if (entry.slot >= 0) {
+        cache()->slotOwners[entry.slot] = -1;
+    }
+    entry.slot = NO_SLOT;
+}
+
+static void removeEntry(int entryIndex) {
+    Entry &entry = cache()->entries[entryIndex];
+
+    int16_t *p = &cache()->buckets[entry.hash % NUM_BUCKETS];
+    while (*p != -1) {
+        if (*p == entryIndex) {
+            *p = entry.next;
+            break;
+        }
+        p = &cache()->entries[*p].next;
+    }
+
+    freeSlot(entry);
+    entry.used = false;
+}
+
+static Entry *addEntry(const char *text, int textLength, gui::font::Font &font) {
+    init();
+
+    textLength = getTextLength(text, textLength);
+    if (textLength > MAX_TEXT_LENGTH) {
+        return nullptr;
+    }
+
+    // find free or least recently used entry
+    int entryIndex = 0;
+    for (int i = 0; i < NUM_ENTRIES; i++) {
+        if (!cache()->entries[i].used) {
+            entryIndex = i;
+            break;
+        }
+        if ((int32_t)(cache()->entries[i].lastUsed - cache()->entries[entryIndex].lastUsed) < 0) {
+            entryIndex = i;
+        }
+    }
+
+    if (cache()->entries[entryIndex].used) {
+        removeEntry(entryIndex);
+    }
+
+    Entry &entry = cache()->entries[entryIndex];
+
+    entry.hash = calcHash(text, textLength, font.fontData);
+    entry.fontData = font.fontData;
+    entry.lastUsed = ++g_lastUsedCounter;
+    entry.slot = NO_SLOT;
+    entry.width = WIDTH_NOT_MEASURED;
+    entry.textLength = (uint8_t)textLength;
+    entry.used = true;
+    memcpy(entry.text, text, textLength);
+
+    int16_t &bucket = cache()->buckets[entry.hash % NUM_BUCKETS];
+    entry.next = bucket;
+    bucket = (int16_t)entryIndex;
+
+    return &entry;
+}
+
+static int16_t allocSlot(Entry &entry, uint32_t size) {
+    int slot = 0;
+    for (int i = 0; i < NUM_SLOT_CLASSES; i++) {
+        if (size <= SLOT_CLASSES[i].slotSize) {
+            // find free or least recently used slot in this class
+            int selectedSlot = slot;
+            for (int j = slot; j < slot + SLOT_CLASSES[i].numSlots; j++) {
+                int16_t owner = cache()->slotOwners[j];
+                if (owner == -1) {
+                    selectedSlot = j;
+                    break;
+                }
+                int16_t selectedOwner = cache()->slotOwners[selectedSlot];
+                if ((int32_t)(cache()->entries[owner].lastUsed - cache()->entries[selectedOwner].lastUsed) < 0) {
+                    selectedSlot = j;
+                }
+            }
+
+            int16_t owner = cache()->slotOwners[selectedSlot];
+            if (owner != -1) {
+                cache()->entries[owner].slot = NO_SLOT;
+                g_statistics.runEvictions++;
+            }
+
+            cache()->slotOwners[selectedSlot] = (int16_t)(&entry - cache()->entries);
+            entry.slot = selectedSlot;
+
+            return entry.slot;
+        }
+        slot += SLOT_CLASSES[i].numSlots;
+    }
+
+    return SLOT_TOO_LARGE;
+}
+
+static void rasterize(Entry &entry, gui::font::Font &font) {
+    int ascent = font.getAscent();
+
+    // bounding box of all glyphs
+    int x1 = 0;
+    int y1 = 0;
+    int x2 = 0;
+    int y2 = 0;
+    bool empty = true;
+
+    int x = 0;
+    for (int i = 0; i < entry.textLength; i++) {
+        gui::font::Glyph glyph;
+        font.getGlyph(entry.text[i], glyph);
+        if (!glyph) {
+            continue;
+        }
+
+        if (glyph.width > 0 && glyph.height > 0) {
+            int gx1 = x + glyph.x;
+            int gy1 = ascent - (glyph.y + glyph.height);
+            int gx2 = gx1 + glyph.width;
+            int gy2 = gy1 + glyph.height;
+
+            if (empty) {
+                x1 = gx1;
+                y1 = gy1;
+                x2 = gx2;
+                y2 = gy2;
+                empty = false;
+            } else {
+                x1 = MIN(x1, gx1);
+                y1 = MIN(y1, gy1);
+                x2 = MAX(x2, gx2);
+                y2 = MAX(y2, gy2);
+            }
+        }
+
+        x += glyph.dx;
+    }
+
+    int width = x2 - x1;
+    int height = y2 - y1;
+
+    entry.run.x = x1;
+    entry.run.y = y1;
+    entry.run.width = width;
+    entry.run.height = height;
+
+    if (empty) {
+        entry.run.mask = nullptr;
+        entry.slot = SLOT_EMPTY;
+        return;
+    }
+
+    if (allocSlot(entry, width * height) == SLOT_TOO_LARGE) {
+        entry.slot = SLOT_TOO_LARGE;
+        return;
+    }
+
+    uint8_t *mask = slotMask(entry.slot);
+    memset(mask, 0, width * height);
+
+    x = 0;
+    for (int i = 0; i < entry.textLength; i++) {
+        gui::font::Glyph glyph;
+        font.getGlyph(entry.text[i], glyph);
+        if (!glyph) {
+            continue;
+        }
+
+        const uint8_t *src = glyph.data + gui::font::GLYPH_HEADER_SIZE;
+        uint8_t *dst = mask + (ascent - (glyph.y + glyph.height) - y1) * width + (x + glyph.x - x1);
+
+        for (int gy = 0; gy < glyph.height; gy++, dst += width) {
+            for (int gx = 0; gx < glyph.width; gx++) {
+                uint8_t a = *src++;
+                uint8_t m = dst[gx];
+                // same as drawing overlapping glyphs one after another
+                dst[gx] = m == 0 ? a : (uint8_t)(m + a - (m * a + 127) / 255);
+            }
+        }
+
+        x += glyph.dx;
+    }
+
+    entry.run.mask = mask;
+}
+
+bool findTextWidth(const char *text, int textLength, gui::font::Font &font, int &width) {
+    Entry *entry = findEntry(text, textLength, font);
+    if (entry && entry->width != WIDTH_NOT_MEASURED) {
+        g_statistics.widthHits++;
+        width = entry->width;
+        return true;
+    }
+    g_statistics.widthMisses++;
+    return false;
+}
+
+void addTextWidth(const char *text, int textLength, gui::font::Font &font, int width) {
+    if (width < 0 || width > INT16_MAX) {
+        return;
+    }
+
+    Entry *entry = findEntry(text, textLength, font);
+    if (!entry) {
+        entry = addEntry(text, textLength, font);
+        if (!entry) {
+            return;
+        }
+    }
+
+    entry->width = (int16_t)width;
+}
+
+const TextRun *findTextRun(const char *text, int textLength, gui::font::Font &font) {
+    Entry *entry = findEntry(text, textLength, font);
+    if (entry && (entry->slot >= 0 || entry->slot == SLOT_EMPTY)) {
+        g_statistics.runHits++;
+        return &entry->run;
+    }
+    g_statistics.runMisses++;
+    return nullptr;
+}
+
+const TextRun *addTextRun(const char *text, int textLength, gui::font::Font &font) {
+    Entry *entry = findEntry(text, textLength, font);
+    if (!entry) {
+        entry = addEntry(text, textLength, font);
+        if (!entry) {
+            return nullptr;
+        }
+    }
+
+    if (entry->slot == NO_SLOT) {
+        rasterize(*entry, font);
+    }
+
+    return entry->slot >= 0 || entry->slot == SLOT_EMPTY ? &entry->run : nullptr;
+}
+
+bool clipTextRun(const TextRun &run, int x, int y, int clip_x1, int clip_y1, int clip_x2, int clip_y2,
+                 const uint8_t *&src, int &x1, int &y1, int &width, int &height) {
+    int xRun = x + run.x;
+    int yRun = y + run.y;
+
+    x1 = MAX(xRun, clip_x1);
+    y1 = MAX(yRun, clip_y1);
+    int x2 = MIN(xRun + run.width - 1, clip_x2);
+    int y2 = MIN(yRun + run.height - 1, clip_y2);
+
+    width = x2 - x1 + 1;
+    height = y2 - y1 + 1;
+    if (width <= 0 || height <= 0) {
+        return false;
+    }
+
+    src = run.mask + (y1 - yRun) * run.width + (x1 - xRun);
+    return true;
+}
+
+void clear() {
+    // actual reset is done from the GUI thread on next access
+    g_initialized = false;
+}
+
+void resetStatistics() {
+    memset(&g_statistics, 0, sizeof(g_statistics));
+}
+
+} // namespace text_cache
+} // namespace display
+} // namespace mcu
+} // namespace eez
+
+#endif // OPTION_DISPLAY
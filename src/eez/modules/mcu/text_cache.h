@@ -0,0 +1,77 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <eez/gui/font.h>
+
+namespace eez {
+namespace mcu {
+namespace display {
+namespace text_cache {
+
+// Longer strings are never cached.
+static const int MAX_TEXT_LENGTH = 40;
+
+// Text run rasterized into A8 mask. Color is applied when mask is drawn,
+// so the same run is used for any foreground and background color.
+struct TextRun {
+    const uint8_t *mask;
+    int16_t x; // mask position relative to the text origin
+    int16_t y;
+    int16_t width;
+    int16_t height;
+};
+
+struct Statistics {
+    uint32_t runHits;
+    uint32_t runMisses;
+    uint32_t runEvictions;
+    uint32_t widthHits;
+    uint32_t widthMisses;
+};
+
+extern Statistics g_statistics;
+
+// Cache is used only from the GUI thread, these return false/nullptr when called from other threads.
+bool isEnabled();
+
+bool findTextWidth(const char *text, int textLength, gui::font::Font &font, int &width);
+void addTextWidth(const char *text, int textLength, gui::font::Font &font, int width);
+
+// Lookup doesn't modify any mask memory.
+const TextRun *findTextRun(const char *text, int textLength, gui::font::Font &font);
+// Rasterizes text into mask memory (possibly evicting least recently used run).
+// Returns nullptr if text run is too large to be cached.
+const TextRun *addTextRun(const char *text, int textLength, gui::font::Font &font);
+
+// Clips text run drawn at (x, y), returns false if nothing is visible.
+bool clipTextRun(const TextRun &run, int x, int y, int clip_x1, int clip_y1, int clip_x2, int clip_y2,
+                 const uint8_t *&src, int &x1, int &y1, int &width, int &height);
+
+// Must be called when font data may have changed (i.e. external assets loaded),
+// can be called from any thread.
+void clear();
+void resetStatistics();
+
+} // namespace text_cache
+} // namespace display
+} // namespace mcu
+} // namespace eez
@@ -0,0 +1,395 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2020-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+
+#include <string.h>
+
+#include <eez/system.h>
+
+#include <eez/modules/psu/psu.h>
+#include <eez/modules/psu/adc_replay.h>
+#include <eez/modules/psu/scpi/psu.h>
+
+#include <eez/libs/sd_fat/sd_fat.h>
+
+namespace eez {
+namespace psu {
+namespace adc_replay {
+
+static const uint32_t FILE_MAGIC = 0x43444145; // "EADC"
+static const uint32_t FILE_VERSION = 1;
+
+struct FileHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t numSamples;
+    uint32_t duration;
+};
+
+struct Sample {
+    uint32_t time; // microseconds since the start of recording
+    uint8_t slotIndex;
+    uint8_t subchannelIndex;
+    uint8_t adcDataType;
+    uint8_t reserved;
+    float value;
+};
+
+Statistics g_statistics;
+
+static State g_state = STATE_IDLE;
+static bool g_stopRequested;
+
+static File g_file;
+static char g_filePath[MAX_PATH_LENGTH + 1];
+static uint32_t g_startTime;
+
+static ReplayMode g_replayMode;
+static uint32_t g_numSamplesLeft;
+static Sample g_nextSample;
+static bool g_isNextSampleValid;
+// set while replayed sample is passed to Channel::onAdcData
+static bool g_inReplay;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static void readNextSample() {
+    g_isNextSampleValid = g_numSamplesLeft > 0 && g_file.read(&g_nextSample, sizeof(Sample)) == sizeof(Sample);
+    if (g_isNextSampleValid) {
+        g_numSamplesLeft--;
+    }
+}
+
+static void replayNextSample() {
+    // module in the slot can be different than the one which is recorded
+    Channel *channel = Channel::getBySlotIndex(g_nextSample.slotIndex, g_nextSample.subchannelIndex);
+    if (channel) {
+        g_inReplay = true;
+        channel->onAdcData((AdcDataType)g_nextSample.adcDataType, g_nextSample.value);
+        g_inReplay = false;
+
+        g_statistics.numSamples++;
+    }
+
+    readNextSample();
+}
+
+static void finish() {
+    if (g_state == STATE_RECORDING) {
+        FileHeader header = { FILE_MAGIC, FILE_VERSION, g_statistics.numSamples, g_statistics.duration };
+        g_file.seek(0);
+        g_file.write(&header, sizeof(FileHeader));
+    }
+
+    g_file.close();
+
+    g_state = STATE_IDLE;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+State getState() {
+    return g_state;
+}
+
+int startRecording(const char *filePath) {
+    if (g_state != STATE_IDLE) {
+        return SCPI_ERROR_EXECUTION_ERROR;
+    }
+
+    if (!g_file.open(filePath, FILE_CREATE_ALWAYS | FILE_WRITE)) {
+        return SCPI_ERROR_MASS_STORAGE_ERROR;
+    }
+
+    // number of samples is written when recording is stopped
+    FileHeader header = { FILE_MAGIC, FILE_VERSION, 0, 0 };
+    if (g_file.write(&header, sizeof(FileHeader)) != sizeof(FileHeader)) {
+        g_file.close();
+        return SCPI_ERROR_MASS_STORAGE_ERROR;
+    }
+
+    strcpy(g_filePath, filePath);
+
+    g_statistics.numSamples = 0;
+    g_statistics.duration = 0;
+
+    g_stopRequested = false;
+    g_startTime = micros();
+    g_state = STATE_RECORDING;
+
+    return SCPI_RES_OK;
+}
+
+int startReplay(const char *filePath, ReplayMode mode) {
+    if (g_state != STATE_IDLE) {
+        return SCPI_ERROR_EXECUTION_ERROR;
+    }
+
+    if (!g_file.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        return SCPI_ERROR_FILE_NOT_FOUND;
+    }
+
+    FileHeader header;
+    if (
+        g_file.read(&header, sizeof(FileHeader)) != sizeof(FileHeader) ||
+        header.magic != FILE_MAGIC ||
+        header.version != FILE_VERSION
+    ) {
+        g_file.close();
+        return SCPI_ERROR_MASS_STORAGE_ERROR;
+    }
+
+    g_statistics.numSamples = 0;
+    g_statistics.duration = 0;
+
+    g_replayMode = mode;
+    g_numSamplesLeft = header.numSamples;
+    readNextSample();
+
+    g_stopRequested = false;
+    g_startTime = micros();
+    g_state = STATE_REPLAYING;
+
+    return SCPI_RES_OK;
+}
+
+void stop() {
+    if (g_state == STATE_IDLE) {
+        return;
+    }
+
+    bool isRecording = g_state == STATE_RECORDING;
+
+    g_stopRequested = true;
+    for (int i = 0; i < 100 && g_state != STATE_IDLE; ++i) {
+        osDelay(10);
+    }
+
+    if (isRecording) {
+        onSdCardFileChangeHook(g_filePath);
+    }
+}
+
+bool onAdcData(Channel &channel, AdcDataType adcDataType, float value) {
+    if (g_state == STATE_RECORDING) {
+        if (!g_stopRequested) {
+            Sample sample;
+            sample.time = micros() - g_startTime;
+            sample.slotIndex = channel.slotIndex;
+            sample.subchannelIndex = channel.subchannelIndex;
+            sample.adcDataType = adcDataType;
+            sample.reserved = 0;
+            sample.value = value;
+
+            if (g_file.write(&sample, sizeof(Sample)) == sizeof(Sample)) {
+                g_statistics.numSamples++;
+                g_statistics.duration = sample.time;
+            } else {
+                g_stopRequested = true;
+            }
+        }
+        return true;
+    }
+
+    if (g_state == STATE_REPLAYING) {
+        return g_inReplay;
+    }
+
+    return true;
+}
+
+void tick(uint32_t tickCount) {
+    if (g_state == STATE_IDLE) {
+        return;
+    }
+
+    if (g_state == STATE_REPLAYING && !g_stopRequested) {
+        if (g_replayMode == REPLAY_MODE_FULL_SPEED) {
+            // PSU thread is blocked until all the samples are replayed
+            uint32_t startTime = micros();
+            while (g_isNextSampleValid) {
+                replayNextSample();
+            }
+            g_statistics.duration = micros() - startTime;
+        } else {
+            uint32_t time = tickCount - g_startTime;
+            while (g_isNextSampleValid && (int32_t)(time - g_nextSample.time) >= 0) {
+                replayNextSample();
+            }
+            g_statistics.duration = time;
+        }
+
+        if (g_isNextSampleValid) {
+            return;
+        }
+    } else if (!g_stopRequested) {
+        return;
+    }
+
+    finish();
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+static const int PROTECTION_BENCHMARK_CHUNK_SIZE = 64;
+// evaluation is repeated for each chunk, so time can be measured with the millisecond tick
+static const int PROTECTION_BENCHMARK_NUM_REPEATS = 100;
+
+struct ProtectionBenchmarkChannel {
+    float uMon;
+    float uMonDac;
+    float iMon;
+    ProtectionValue values[3];
+    bool conditionMet[3];
+    // time when condition was met for the first time
+    uint32_t conditionStarted[3];
+};
+
+static bool getBenchmarkSampleChannel(const Sample &sample, Channel *&channel) {
+    channel = Channel::getBySlotIndex(sample.slotIndex, sample.subchannelIndex);
+    return channel != nullptr;
+}
+
+// returns trip bits in bits 0..2 and condition bits in bits 3..5
+static uint8_t evaluateBenchmarkSample(Channel &channel, ProtectionBenchmarkChannel &state, const Sample &sample) {
+    if (sample.adcDataType == ADC_DATA_TYPE_U_MON) {
+        state.uMon = sample.value;
+    } else if (sample.adcDataType == ADC_DATA_TYPE_I_MON) {
+        state.iMon = sample.value;
+    } else if (sample.adcDataType == ADC_DATA_TYPE_U_MON_DAC) {
+        state.uMonDac = sample.value;
+    }
+
+    uint8_t conditions = channel.getProtectionConditions(state.uMon, state.uMonDac, state.iMon);
+
+    const ProtectionThresholds &thresholds = channel.protectionThresholds;
+    uint32_t delays[3] = { thresholds.uDelay, thresholds.iDelay, thresholds.pDelay };
+
+    uint8_t trips = 0;
+    for (int i = 0; i < 3; i++) {
+        if (Channel::protectionDelayStep(state.values[i], conditions & (1 << i), delays[i], sample.time)) {
+            trips |= 1 << i;
+        }
+    }
+
+    return trips | (conditions << 3);
+}
+
+int runProtectionBenchmark(const char *filePath, ProtectionBenchmarkResult &result) {
+    File file;
+    if (!file.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        return SCPI_ERROR_FILE_NOT_FOUND;
+    }
+
+    FileHeader header;
+    if (
+        file.read(&header, sizeof(FileHeader)) != sizeof(FileHeader) ||
+        header.magic != FILE_MAGIC ||
+        header.version != FILE_VERSION
+    ) {
+        file.close();
+        return SCPI_ERROR_MASS_STORAGE_ERROR;
+    }
+
+    static ProtectionBenchmarkChannel states[CH_MAX];
+    static ProtectionBenchmarkChannel scratchStates[CH_MAX];
+    memset(states, 0, sizeof(states));
+
+    Sample samples[PROTECTION_BENCHMARK_CHUNK_SIZE];
+
+    result.numSamples = 0;
+    result.numTrips = 0;
+    result.maxLatency = 0;
+    uint64_t totalLatency = 0;
+    uint32_t totalDuration = 0;
+
+    uint32_t numSamplesLeft = header.numSamples;
+    while (numSamplesLeft > 0) {
+        uint32_t numSamples = MIN(numSamplesLeft, (uint32_t)PROTECTION_BENCHMARK_CHUNK_SIZE);
+        if (file.read(samples, numSamples * sizeof(Sample)) != numSamples * sizeof(Sample)) {
+            break;
+        }
+        numSamplesLeft -= numSamples;
+
+        // reaction latency
+        for (uint32_t j = 0; j < numSamples; j++) {
+            Channel *channel;
+            if (!getBenchmarkSampleChannel(samples[j], channel)) {
+                continue;
+            }
+
+            auto &state = states[channel->channelIndex];
+            uint8_t tripsAndConditions = evaluateBenchmarkSample(*channel, state, samples[j]);
+
+            for (int i = 0; i < 3; i++) {
+                if (!(tripsAndConditions & (1 << (i + 3)))) {
+                    state.conditionMet[i] = false;
+                    continue;
+                }
+
+                if (!state.conditionMet[i]) {
+                    state.conditionMet[i] = true;
+                    state.conditionStarted[i] = samples[j].time;
+                }
+
+                if (tripsAndConditions & (1 << i)) {
+                    uint32_t latency = samples[j].time - state.conditionStarted[i];
+                    result.numTrips++;
+                    if (latency > result.maxLatency) {
+                        result.maxLatency = latency;
+                    }
+                    totalLatency += latency;
+
+                    // channel output would be disabled now, start again with the next sample over the threshold
+                    state.values[i].flags.alarmed = 0;
+                    state.conditionMet[i] = false;
+                }
+            }
+
+            result.numSamples++;
+        }
+
+        // cost, state is not affected by these iterations; in simulator time is measured with
+        // the millisecond tick, so it is correct on average over many chunks
+        memcpy(scratchStates, states, sizeof(states));
+        uint32_t startTime = micros();
+        for (int k = 0; k < PROTECTION_BENCHMARK_NUM_REPEATS; k++) {
+            for (uint32_t j = 0; j < numSamples; j++) {
+                Channel *channel;
+                if (getBenchmarkSampleChannel(samples[j], channel)) {
+                    evaluateBenchmarkSample(*channel, scratchStates[channel->channelIndex], samples[j]);
+                }
+            }
+        }
+        totalDuration += micros() - startTime;
+    }
+
+    file.close();
+
+    result.costPerSample = result.numSamples > 0 ? totalDuration * 1000.0f / (result.numSamples * PROTECTION_BENCHMARK_NUM_REPEATS) : 0;
+    result.avgLatency = result.numTrips > 0 ? (uint32_t)(totalLatency / result.numTrips) : 0;
+
+    return SCPI_RES_OK;
+}
+
+} // namespace adc_replay
+} // namespace psu
+} // namespace eez
+
+#endif // EEZ_PLATFORM_SIMULATOR
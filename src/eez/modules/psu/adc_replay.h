@@ -0,0 +1,79 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2020-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#if defined(EEZ_PLATFORM_SIMULATOR)
+
+namespace eez {
+namespace psu {
+namespace adc_replay {
+
+// Records ADC samples of all the channels, as they are passed to Channel::onAdcData,
+// and replays them later through the same path, so the whole measurement chain
+// (protection, history, DLOG ...) can be benchmarked with the same input every time.
+
+enum State {
+    STATE_IDLE,
+    STATE_RECORDING,
+    STATE_REPLAYING
+};
+
+enum ReplayMode {
+    REPLAY_MODE_FULL_SPEED,
+    REPLAY_MODE_REAL_TIME
+};
+
+struct Statistics {
+    uint32_t numSamples; // recorded or replayed
+    uint32_t duration;   // in microseconds
+};
+
+extern Statistics g_statistics;
+
+State getState();
+
+// Called from the SCPI thread, returns SCPI_RES_OK or SCPI error.
+int startRecording(const char *filePath);
+int startReplay(const char *filePath, ReplayMode mode);
+// File is closed in the PSU thread, this waits for it.
+void stop();
+
+// Called from the PSU thread. Returns false if sample should be ignored,
+// that is, live ADC samples are ignored during the replay.
+bool onAdcData(Channel &channel, AdcDataType adcDataType, float value);
+void tick(uint32_t tickCount);
+
+struct ProtectionBenchmarkResult {
+    uint32_t numSamples;
+    float costPerSample; // in nanoseconds
+    uint32_t numTrips;
+    uint32_t maxLatency; // in microseconds of the recording, from the first sample over the threshold to the trip
+    uint32_t avgLatency;
+};
+
+// Runs recorded samples through the protection evaluation (thresholds and delay timers) of the
+// channels, with the current protection configuration and as if output is enabled. Channels
+// are not affected, protection state is kept separately.
+int runProtectionBenchmark(const char *filePath, ProtectionBenchmarkResult &result);
+
+} // namespace adc_replay
+} // namespace psu
+} // namespace eez
+
+#endif // EEZ_PLATFORM_SIMULATOR
@@ -22,12 +22,16 @@
 
 #include <eez/modules/psu/psu.h>
 
+#include <float.h>
 #include <math.h>
 #include <stdio.h>
+#include <string.h>
 #include <assert.h>
 
 #include <eez/firmware.h>
+#include <eez/memory.h>
 #include <eez/system.h>
+#include <eez/modules/psu/adc_replay.h>
 #include <eez/modules/psu/board.h>
 #include <eez/modules/psu/calibration.h>
 #include <eez/modules/psu/channel_dispatcher.h>
@@ -53,198 +57,263 @@ using namespace scpi;
 
 namespace psu {
 
-void ChannelHistory::reset() {
-    for (int i = 0; i < CHANNEL_HISTORY_SIZE; ++i) {
-        uHistory[i] = 0;
-        iHistory[i] = 0;
-    }
-    historyStarted = 0;
-    historyPosition = 1;
+static const uint32_t HISTORY_SECOND_MICROSECONDS = 1000000;
+// number of samples merged into one sample of the next level, i.e. 60 seconds into a minute
+static const uint32_t HISTORY_DECIMATION = 60;
+
+static_assert(
+    CH_MAX * ChannelHistory::NUM_LEVELS * CHANNEL_HISTORY_SIZE * sizeof(ChannelHistory::Sample) <= CHANNEL_HISTORY_MEMORY_SIZE,
+    "CHANNEL_HISTORY_MEMORY_SIZE too small"
+);
+
+void ChannelHistory::Accumulator::reset() {
+    uMin = FLT_MAX;
+    uMax = -FLT_MAX;
+    uSum = 0;
+    iMin = FLT_MAX;
+    iMax = -FLT_MAX;
+    iSum = 0;
+    pMin = FLT_MAX;
+    pMax = -FLT_MAX;
+    pSum = 0;
+    count = 0;
 }
 
-void ChannelHistory::update(uint32_t tickCount) {
-    if (!historyStarted) {
-        historyStarted = 1;
-        historyLastTick = tickCount;
-        historyPosition = 1;
-    } else {
-        uint32_t ytViewRateMicroseconds = (int)round(channel.ytViewRate * 1000000L);
-        while (tickCount - historyLastTick >= ytViewRateMicroseconds) {
-            uint32_t historyIndex = historyPosition % CHANNEL_HISTORY_SIZE;
-            uHistory[historyIndex] = channel_dispatcher::getUMonLast(channel);
-            iHistory[historyIndex] = channel_dispatcher::getIMonLast(channel);
-            historyPosition++;
-            historyLastTick += ytViewRateMicroseconds;
-        }
+void ChannelHistory::Accumulator::add(float u, float i) {
+    if (u < uMin) {
+        uMin = u;
     }
-}
+    if (u > uMax) {
+        uMax = u;
+    }
+    uSum += u;
 
-float ChannelHistory::getChannel0HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
-    Channel &channel = *Channel::g_channels[0];
-    ChannelHistory *channelHistory = channel.channelHistory;
-    if (!channelHistory) {
-        return NAN;
+    if (i < iMin) {
+        iMin = i;
+    }
+    if (i > iMax) {
+        iMax = i;
     }
+    iSum += i;
 
-    uint32_t position = rowIndex % CHANNEL_HISTORY_SIZE;
-    
-    if (columnIndex == 0) {
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_VOLTAGE) {
-            return channelHistory->uHistory[position];
-        }
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_CURRENT) {
-            return channelHistory->iHistory[position];
-        }
-    } else {
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_VOLTAGE) {
-            return channelHistory->uHistory[position];
-        }
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_CURRENT) {
-            return channelHistory->iHistory[position];
-        }
+    float p = u * i;
+    if (p < pMin) {
+        pMin = p;
+    }
+    if (p > pMax) {
+        pMax = p;
     }
+    pSum += p;
 
-    return channelHistory->uHistory[position] * channelHistory->iHistory[position];
+    count++;
 }
 
-float ChannelHistory::getChannel1HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
-    Channel &channel = *Channel::g_channels[1];
-    ChannelHistory *channelHistory = channel.channelHistory;
-    if (!channelHistory) {
-        return NAN;
+void ChannelHistory::Accumulator::add(const Sample &sample) {
+    if (sample.uMin < uMin) {
+        uMin = sample.uMin;
     }
+    if (sample.uMax > uMax) {
+        uMax = sample.uMax;
+    }
+    uSum += sample.uAvg;
 
-    uint32_t position = rowIndex % CHANNEL_HISTORY_SIZE;
+    if (sample.iMin < iMin) {
+        iMin = sample.iMin;
+    }
+    if (sample.iMax > iMax) {
+        iMax = sample.iMax;
+    }
+    iSum += sample.iAvg;
 
-    if (columnIndex == 0) {
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_VOLTAGE) {
-            return channelHistory->uHistory[position];
-        }
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_CURRENT) {
-            return channelHistory->iHistory[position];
-        }
-    } else {
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_VOLTAGE) {
-            return channelHistory->uHistory[position];
-        }
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_CURRENT) {
-            return channelHistory->iHistory[position];
-        }
+    if (sample.pMin < pMin) {
+        pMin = sample.pMin;
     }
+    if (sample.pMax > pMax) {
+        pMax = sample.pMax;
+    }
+    pSum += sample.pAvg;
 
-    return channelHistory->uHistory[position] * channelHistory->iHistory[position];
+    count++;
 }
 
-float ChannelHistory::getChannel2HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
-    Channel &channel = *Channel::g_channels[2];
-    ChannelHistory *channelHistory = channel.channelHistory;
-    if (!channelHistory) {
-        return NAN;
-    }
+void ChannelHistory::Accumulator::getSample(Sample &sample) {
+    sample.uMin = uMin;
+    sample.uMax = uMax;
+    sample.uAvg = uSum / count;
+    sample.iMin = iMin;
+    sample.iMax = iMax;
+    sample.iAvg = iSum / count;
+    sample.pMin = pMin;
+    sample.pMax = pMax;
+    sample.pAvg = pSum / count;
+}
 
-    uint32_t position = rowIndex % CHANNEL_HISTORY_SIZE;
+ChannelHistory::ChannelHistory(Channel& channel_)
+    : samples((Sample *)CHANNEL_HISTORY_MEMORY + channel_.channelIndex * NUM_LEVELS * CHANNEL_HISTORY_SIZE)
+    , channel(channel_)
+{
+}
 
-    if (columnIndex == 0) {
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_VOLTAGE) {
-            return channelHistory->uHistory[position];
-        }
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_CURRENT) {
-            return channelHistory->iHistory[position];
-        }
-    } else {
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_VOLTAGE) {
-            return channelHistory->uHistory[position];
-        }
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_CURRENT) {
-            return channelHistory->iHistory[position];
-        }
+void ChannelHistory::reset() {
+    memset(samples, 0, NUM_LEVELS * CHANNEL_HISTORY_SIZE * sizeof(Sample));
+    for (int level = 0; level < NUM_LEVELS; level++) {
+        positions[level] = 1;
+        accumulators[level].reset();
     }
+    historyStarted = 0;
+}
 
-    return channelHistory->uHistory[position] * channelHistory->iHistory[position];
+void ChannelHistory::resetViewLevel() {
+    memset(samples + LEVEL_VIEW * CHANNEL_HISTORY_SIZE, 0, CHANNEL_HISTORY_SIZE * sizeof(Sample));
+    positions[LEVEL_VIEW] = 1;
+    accumulators[LEVEL_VIEW].reset();
+    viewLastTick = micros();
 }
 
-float ChannelHistory::getChannel3HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
-    Channel &channel = *Channel::g_channels[3];
-    ChannelHistory *channelHistory = channel.channelHistory;
-    if (!channelHistory) {
-        return NAN;
+void ChannelHistory::addSample(Level level) {
+    Sample &sample = samples[level * CHANNEL_HISTORY_SIZE + positions[level] % CHANNEL_HISTORY_SIZE];
+    accumulators[level].getSample(sample);
+    accumulators[level].reset();
+    positions[level]++;
+
+    if (level != LEVEL_VIEW && level + 1 < NUM_LEVELS) {
+        Level nextLevel = (Level)(level + 1);
+        accumulators[nextLevel].add(sample);
+        if (accumulators[nextLevel].count == HISTORY_DECIMATION) {
+            addSample(nextLevel);
+        }
     }
+}
 
-    uint32_t position = rowIndex % CHANNEL_HISTORY_SIZE;
+void ChannelHistory::update(uint32_t tickCount) {
+    float u = channel_dispatcher::getUMonLast(channel);
+    float i = channel_dispatcher::getIMonLast(channel);
 
-    if (columnIndex == 0) {
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_VOLTAGE) {
-            return channelHistory->uHistory[position];
+    if (!historyStarted) {
+        historyStarted = 1;
+        viewLastTick = tickCount;
+        secondsLastTick = tickCount;
+        return;
+    }
+
+    // min/max are tracked for every tick, so short spikes between samples are not lost
+    accumulators[LEVEL_SECONDS].add(u, i);
+    while (tickCount - secondsLastTick >= HISTORY_SECOND_MICROSECONDS) {
+        if (accumulators[LEVEL_SECONDS].count == 0) {
+            accumulators[LEVEL_SECONDS].add(u, i);
         }
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_CURRENT) {
-            return channelHistory->iHistory[position];
+        addSample(LEVEL_SECONDS);
+        secondsLastTick += HISTORY_SECOND_MICROSECONDS;
+    }
+
+    if (getViewLevel() == LEVEL_VIEW) {
+        accumulators[LEVEL_VIEW].add(u, i);
+        uint32_t ytViewRateMicroseconds = (uint32_t)round(channel.ytViewRate * 1000000.0);
+        while (tickCount - viewLastTick >= ytViewRateMicroseconds) {
+            if (accumulators[LEVEL_VIEW].count == 0) {
+                accumulators[LEVEL_VIEW].add(u, i);
+            }
+            addSample(LEVEL_VIEW);
+            viewLastTick += ytViewRateMicroseconds;
         }
     } else {
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_VOLTAGE) {
-            return channelHistory->uHistory[position];
-        }
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_CURRENT) {
-            return channelHistory->iHistory[position];
+        viewLastTick = tickCount;
+    }
+}
+
+ChannelHistory::Level ChannelHistory::getViewLevel() {
+    // view rate entered as 60 s or 1 h is not always exactly the same float
+    for (int level = LEVEL_SECONDS; level < NUM_LEVELS; level++) {
+        float period = getPeriod((Level)level);
+        if (fabsf(channel.ytViewRate - period) < period * 1E-4f) {
+            return (Level)level;
         }
     }
+    return LEVEL_VIEW;
+}
 
-    return channelHistory->uHistory[position] * channelHistory->iHistory[position];
+uint32_t ChannelHistory::getPosition(Level level) {
+    return positions[level];
 }
 
-float ChannelHistory::getChannel4HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
-    Channel &channel = *Channel::g_channels[4];
-    ChannelHistory *channelHistory = channel.channelHistory;
-    if (!channelHistory) {
-        return NAN;
-    }
+const ChannelHistory::Sample &ChannelHistory::getSample(Level level, uint32_t position) {
+    return samples[level * CHANNEL_HISTORY_SIZE + position % CHANNEL_HISTORY_SIZE];
+}
 
-    uint32_t position = rowIndex % CHANNEL_HISTORY_SIZE;
+uint32_t ChannelHistory::getFirstPosition(Level level) {
+    // sample at (position - CHANNEL_HISTORY_SIZE) is the next one to be overwritten
+    uint32_t position = positions[level];
+    return position > CHANNEL_HISTORY_SIZE ? position - CHANNEL_HISTORY_SIZE + 1 : 1;
+}
 
-    if (columnIndex == 0) {
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_VOLTAGE) {
-            return channelHistory->uHistory[position];
-        }
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_CURRENT) {
-            return channelHistory->iHistory[position];
-        }
-    } else {
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_VOLTAGE) {
-            return channelHistory->uHistory[position];
-        }
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_CURRENT) {
-            return channelHistory->iHistory[position];
-        }
+float ChannelHistory::getPeriod(Level level) {
+    if (level == LEVEL_VIEW) {
+        return channel.ytViewRate;
     }
 
-    return channelHistory->uHistory[position] * channelHistory->iHistory[position];
+    float period = HISTORY_SECOND_MICROSECONDS / 1000000.0f;
+    for (int i = LEVEL_SECONDS; i < level; i++) {
+        period *= HISTORY_DECIMATION;
+    }
+    return period;
 }
 
-float ChannelHistory::getChannel5HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
-    Channel &channel = *Channel::g_channels[5];
+float ChannelHistory::getHistoryValue(int channelIndex, uint32_t rowIndex, uint8_t columnIndex, float *max) {
+    Channel &channel = *Channel::g_channels[channelIndex];
     ChannelHistory *channelHistory = channel.channelHistory;
     if (!channelHistory) {
         return NAN;
     }
 
-    uint32_t position = rowIndex % CHANNEL_HISTORY_SIZE;
+    const Sample &sample = channelHistory->getSample(channelHistory->getViewLevel(), rowIndex);
 
-    if (columnIndex == 0) {
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_VOLTAGE) {
-            return channelHistory->uHistory[position];
-        }
-        if (channel.flags.displayValue1 == DISPLAY_VALUE_CURRENT) {
-            return channelHistory->iHistory[position];
-        }
-    } else {
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_CURRENT) {
-            return channelHistory->iHistory[position];
+    int displayValue = columnIndex == 0 ? channel.flags.displayValue1 : channel.flags.displayValue2;
+
+    if (displayValue == DISPLAY_VALUE_VOLTAGE) {
+        if (max) {
+            *max = sample.uMax;
+            return sample.uMin;
         }
-        if (channel.flags.displayValue2 == DISPLAY_VALUE_VOLTAGE) {
-            return channelHistory->uHistory[position];
+        return sample.uAvg;
+    }
+
+    if (displayValue == DISPLAY_VALUE_CURRENT) {
+        if (max) {
+            *max = sample.iMax;
+            return sample.iMin;
         }
+        return sample.iAvg;
     }
 
-    return channelHistory->uHistory[position] * channelHistory->iHistory[position];
+    if (max) {
+        *max = sample.pMax;
+        return sample.pMin;
+    }
+    return sample.pAvg;
+}
+
+float ChannelHistory::getChannel0HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
+    return getHistoryValue(0, rowIndex, columnIndex, max);
+}
+
+float ChannelHistory::getChannel1HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
+    return getHistoryValue(1, rowIndex, columnIndex, max);
+}
+
+float ChannelHistory::getChannel2HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
+    return getHistoryValue(2, rowIndex, columnIndex, max);
+}
+
+float ChannelHistory::getChannel3HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
+    return getHistoryValue(3, rowIndex, columnIndex, max);
+}
+
+float ChannelHistory::getChannel4HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
+    return getHistoryValue(4, rowIndex, columnIndex, max);
+}
+
+float ChannelHistory::getChannel5HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
+    return getHistoryValue(5, rowIndex, columnIndex, max);
 }
 
 YtDataGetValueFunctionPointer ChannelHistory::getChannelHistoryValueFuncs(int channelIndex) {
@@ -445,6 +514,7 @@ Channel::Channel(uint8_t slotIndex_, uint8_t channelIndex_, uint8_t subchannelIn
     subchannelIndex = subchannelIndex_;
     *label = 0;
     color = channelIndex;
+    protectionThresholdsChanged = true;
 }
 
 void Channel::initParams(uint16_t moduleRevision) {
@@ -541,49 +611,89 @@ float Channel::getSwOvpProtectionLevel() {
     return channel_dispatcher::getUProtectionLevel(*this);
 }
 
-bool Channel::checkSwOvpCondition() {
-    float uProtectionLevel = getSwOvpProtectionLevel();
-    return channel_dispatcher::getUMonLast(*this) > uProtectionLevel || (flags.rprogEnabled && channel_dispatcher::getUMonDacLast(*this) > uProtectionLevel);
+static uint32_t getProtectionDelay(float delay) {
+    return delay > 0 ? (uint32_t)ceilf(delay * 1000000.0f) : 0;
 }
 
-void Channel::protectionCheck(ProtectionValue &cpv) {
-    bool state;
-    bool condition;
-    float delay;
+void Channel::doUpdateProtectionThresholds() {
+    protectionThresholds.uState = flags.rprogEnabled || prot_conf.flags.u_state;
+    protectionThresholds.uHwOvp = (params.features & CH_FEATURE_HW_OVP) && prot_conf.flags.u_type;
+    protectionThresholds.uCheckMonDac = flags.rprogEnabled;
+    protectionThresholds.uLevel = getSwOvpProtectionLevel();
+    protectionThresholds.uDelay = getProtectionDelay(prot_conf.u_delay - PROT_DELAY_CORRECTION);
 
-    if (IS_OVP_VALUE(this, cpv)) {
-        state = (flags.rprogEnabled || prot_conf.flags.u_state) && !((params.features & CH_FEATURE_HW_OVP) && prot_conf.flags.u_type && !prot_conf.flags.u_hwOvpDeactivated);
-        condition = checkSwOvpCondition();
-        delay = prot_conf.u_delay;
-        delay -= PROT_DELAY_CORRECTION;
-    } else if (IS_OCP_VALUE(this, cpv)) {
-        state = prot_conf.flags.i_state;
-        condition = channel_dispatcher::getIMonLast(*this) >= channel_dispatcher::getISet(*this);
-        delay = prot_conf.i_delay;
-        delay -= PROT_DELAY_CORRECTION;
+    protectionThresholds.iState = prot_conf.flags.i_state;
+    protectionThresholds.iLevel = channel_dispatcher::getISet(*this);
+    protectionThresholds.iDelay = getProtectionDelay(prot_conf.i_delay - PROT_DELAY_CORRECTION);
+
+    protectionThresholds.pState = prot_conf.flags.p_state;
+    protectionThresholds.pLevel = channel_dispatcher::getPowerProtectionLevel(*this);
+    protectionThresholds.pDelay = getProtectionDelay(prot_conf.p_delay);
+}
+
+void Channel::updateProtectionThresholds() {
+    // thresholds of the coupled channels depend on the values of both channels
+    auto couplingType = channel_dispatcher::getCouplingType();
+    if (channelIndex < 2 && (couplingType == channel_dispatcher::COUPLING_TYPE_SERIES || couplingType == channel_dispatcher::COUPLING_TYPE_PARALLEL)) {
+        Channel::get(0).protectionThresholdsChanged = true;
+        Channel::get(1).protectionThresholdsChanged = true;
     } else {
-        state = prot_conf.flags.p_state;
-        condition = channel_dispatcher::getUMonLast(*this) * channel_dispatcher::getIMonLast(*this) > channel_dispatcher::getPowerProtectionLevel(*this);
-        delay = prot_conf.p_delay;
+        protectionThresholdsChanged = true;
     }
+}
 
-    if (state && isOutputEnabled() && condition) {
-        if (delay > 0) {
-            if (cpv.flags.alarmed) {
-                if (micros() - cpv.alarm_started >= delay * 1000000UL) {
-                    cpv.flags.alarmed = 0;
-                    protectionEnter(cpv, false);
-                }
-            } else {
-                cpv.flags.alarmed = 1;
-                cpv.alarm_started = micros();
-            }
-        } else {
-            protectionEnter(cpv, false);
-        }
-    } else {
+void Channel::updateAllProtectionThresholds() {
+    for (int i = 0; i < CH_NUM; i++) {
+        Channel::get(i).protectionThresholdsChanged = true;
+    }
+}
+
+uint8_t Channel::getProtectionConditions(float uMon, float uMonDac, float iMon) {
+    const ProtectionThresholds &thresholds = protectionThresholds;
+
+    uint8_t conditions = 0;
+
+    if (
+        thresholds.uState &&
+        !(thresholds.uHwOvp && !prot_conf.flags.u_hwOvpDeactivated) &&
+        (uMon > thresholds.uLevel || (thresholds.uCheckMonDac && uMonDac > thresholds.uLevel))
+    ) {
+        conditions |= PROTECTION_CONDITION_OVP;
+    }
+
+    if (thresholds.iState && iMon >= thresholds.iLevel) {
+        conditions |= PROTECTION_CONDITION_OCP;
+    }
+
+    if (thresholds.pState && uMon * iMon > thresholds.pLevel) {
+        conditions |= PROTECTION_CONDITION_OPP;
+    }
+
+    return conditions;
+}
+
+bool Channel::protectionDelayStep(ProtectionValue &cpv, bool condition, uint32_t delay, uint32_t time) {
+    if (!condition) {
+        cpv.flags.alarmed = 0;
+        return false;
+    }
+
+    if (delay == 0) {
+        return true;
+    }
+
+    if (!cpv.flags.alarmed) {
+        cpv.flags.alarmed = 1;
+        cpv.alarm_started = time;
+        return false;
+    }
+
+    if (time - cpv.alarm_started >= delay) {
         cpv.flags.alarmed = 0;
+        return true;
     }
+
+    return false;
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -649,9 +759,12 @@ void Channel::reset() {
     // [SOUR[n]]:VOLT:STEP -> set all to default
     u.init(params.U_MIN, params.U_DEF_STEP, u.max);
     i.init(params.I_MIN, params.I_DEF_STEP, i.max);
+    updateProtectionThresholds();
 
     u.rampDuration = RAMP_DURATION_DEF_VALUE_U;
     i.rampDuration = RAMP_DURATION_DEF_VALUE_I;
+    u.rampShape = ramp::RAMP_SHAPE_LINEAR;
+    i.rampShape = ramp::RAMP_SHAPE_LINEAR;
 
     maxCurrentLimitCause = MAX_CURRENT_LIMIT_CAUSE_NONE;
     p_limit = roundChannelValue(UNIT_WATT, params.PTOT);
@@ -682,12 +795,20 @@ void Channel::reset() {
 }
 
 uint32_t Channel::getCurrentHistoryValuePosition() {
-    return channelHistory ? channelHistory->historyPosition : 0;
+    return channelHistory ? channelHistory->getPosition(channelHistory->getViewLevel()) : 0;
+}
+
+int Channel::getHistoryViewLevel() {
+    return channelHistory ? channelHistory->getViewLevel() : ChannelHistory::LEVEL_VIEW;
 }
 
 void Channel::resetHistoryForAllChannels() {
+    // view rate has changed
     for (int i = 0; i < CH_NUM; i++) {
-        Channel::get(i).resetHistory();
+        Channel &channel = Channel::get(i);
+        if (channel.channelHistory) {
+            channel.channelHistory->resetViewLevel();
+        }
     }
 }
 
@@ -713,6 +834,8 @@ void Channel::clearProtectionConf() {
     prot_conf.p_delay = params.OPP_DEFAULT_DELAY;
     prot_conf.p_level = params.OPP_DEFAULT_LEVEL;
 
+    updateProtectionThresholds();
+
     temperature::sensors[temp_sensor::CH1 + channelIndex].prot_conf.state = OTP_CH_DEFAULT_STATE;
     temperature::sensors[temp_sensor::CH1 + channelIndex].prot_conf.level = OTP_CH_DEFAULT_LEVEL;
     temperature::sensors[temp_sensor::CH1 + channelIndex].prot_conf.delay = OTP_CH_DEFAULT_DELAY;
@@ -879,6 +1002,12 @@ void Channel::addIMonDacAdcValue(float value) {
 }
 
 void Channel::onAdcData(AdcDataType adcDataType, float value) {
+#if defined(EEZ_PLATFORM_SIMULATOR)
+    if (!adc_replay::onAdcData(*this, adcDataType, value)) {
+        return;
+    }
+#endif
+
     switch (adcDataType) {
     case ADC_DATA_TYPE_U_MON:
         addUMonAdcValue(value);
@@ -897,6 +1026,8 @@ void Channel::onAdcData(AdcDataType adcDataType, float value) {
         break;
     }
 
+    channel_dispatcher::updateCoupledMonValues(*this);
+
     protectionCheck();
 }
 
@@ -919,9 +1050,40 @@ void Channel::setCvMode(bool cv_mode) {
 }
 
 void Channel::protectionCheck() {
-    protectionCheck(ovp);
-    protectionCheck(ocp);
-    protectionCheck(opp);
+    if (protectionThresholdsChanged) {
+        // cleared before rebuild, so a change made in the meantime is not lost
+        protectionThresholdsChanged = false;
+        doUpdateProtectionThresholds();
+    }
+
+    uint8_t conditions = 0;
+    if (isOutputEnabled()) {
+        conditions = getProtectionConditions(
+            channel_dispatcher::getUMonLast(*this),
+            channel_dispatcher::getUMonDacLast(*this),
+            channel_dispatcher::getIMonLast(*this)
+        );
+    }
+
+    uint32_t time = micros();
+
+    if (protectionDelayStep(ovp, conditions & PROTECTION_CONDITION_OVP, protectionThresholds.uDelay, time)) {
+        protectionEnter(ovp, false);
+        if (!isOutputEnabled()) {
+            conditions = 0;
+        }
+    }
+
+    if (protectionDelayStep(ocp, conditions & PROTECTION_CONDITION_OCP, protectionThresholds.iDelay, time)) {
+        protectionEnter(ocp, false);
+        if (!isOutputEnabled()) {
+            conditions = 0;
+        }
+    }
+
+    if (protectionDelayStep(opp, conditions & PROTECTION_CONDITION_OPP, protectionThresholds.pDelay, time)) {
+        protectionEnter(opp, false);
+    }
 }
 
 void Channel::updateAllChannels() {
@@ -958,6 +1120,7 @@ void Channel::executeOutputEnable(bool enable, uint16_t tasks) {
     u.resetMonValues();
     i.resetMonValues();
     setOutputEnable(enable, tasks);
+    channel_dispatcher::updateCoupledMonValues(*this);
 
     if (tasks & OUTPUT_ENABLE_TASK_FINALIZE) {
         setOperBits(OPER_ISUM_OE_OFF, !enable);
@@ -1123,6 +1286,7 @@ void Channel::doRemoteProgrammingEnable(bool enable) {
     }
 
     flags.rprogEnabled = enable;
+    updateProtectionThresholds();
 
     if (enable) {
     	channel_dispatcher::setVoltageLimit(*this, channel_dispatcher::getUMaxOvpLimit(*this));
@@ -1228,11 +1392,14 @@ float Channel::getCalibratedVoltage(float value) {
 void Channel::doSetVoltage(float value) {
     u.set = value;
     u.mon_dac = 0;
+    channel_dispatcher::updateCoupledMonValues(*this);
 
     if (prot_conf.u_level < u.set) {
         prot_conf.u_level = u.set;
     }
 
+    updateProtectionThresholds();
+
 	value = getCalibratedVoltage(value);
 
     setDacVoltageFloat(value);
@@ -1261,6 +1428,9 @@ void Channel::doSetCurrent(float value) {
 
     i.set = value;
     i.mon_dac = 0;
+    channel_dispatcher::updateCoupledMonValues(*this);
+
+    updateProtectionThresholds();
 
     if (isCurrentCalibrationEnabled()) {
         value = calibration::remapValue(value, cal_conf.i[flags.currentCurrentRange]);
@@ -1333,6 +1503,7 @@ void Channel::disableProtection() {
         prot_conf.flags.u_state = 0;
         prot_conf.flags.i_state = 0;
         prot_conf.flags.p_state = 0;
+        updateProtectionThresholds();
         temperature::disableChannelProtection(this);
     }
 }
@@ -1422,6 +1593,12 @@ MaxCurrentLimitCause Channel::getMaxCurrentLimitCause() const {
 
 void Channel::limitMaxCurrent(MaxCurrentLimitCause cause) {
     if (cause != maxCurrentLimitCause) {
+        if (!isPsuThread()) {
+            // current limit is set through DAC, that must be done from the PSU thread
+            sendMessageToPsu(PSU_MESSAGE_LIMIT_MAX_CURRENT, (channelIndex << 8) | cause);
+            return;
+        }
+
         maxCurrentLimitCause = cause;
 
         if (isMaxCurrentLimited()) {
@@ -1530,6 +1707,7 @@ void Channel::setCurrentRangeSelectionMode(CurrentRangeSelectionMode mode) {
         float limit = 0.05f;
         if (i.set > limit) {
             i.set = limit;
+            updateProtectionThresholds();
         }
         if (i.limit > limit) {
             i.limit = limit;
@@ -1622,6 +1800,10 @@ float Channel::getISet() const {
 void Channel::readAllRegisters(uint8_t ioexpRegisters[], uint8_t adcRegisters[]) {
 }
 
+bool Channel::getAdcStatistics(float &samplesPerSecond, float &spiTransactionsPerSecond) {
+    return false;
+}
+
 #if defined(DEBUG) && defined(EEZ_PLATFORM_STM32)
 int Channel::getIoExpBitDirection(int io_bit) {
 	return 0;
@@ -188,6 +188,28 @@ struct ProtectionValue {
     uint32_t alarm_started;
 };
 
+/// Protection thresholds precomputed from the protection configuration and set values,
+/// so that only measured values are compared for each ADC sample.
+struct ProtectionThresholds {
+    float uLevel;
+    float iLevel;
+    float pLevel;
+    // in microseconds, 0 means protection is entered immediately
+    uint32_t uDelay;
+    uint32_t iDelay;
+    uint32_t pDelay;
+    unsigned uState : 1;
+    // OVP is checked by HW, unless HW OVP is (temporarily) deactivated
+    unsigned uHwOvp : 1;
+    unsigned uCheckMonDac : 1;
+    unsigned iState : 1;
+    unsigned pState : 1;
+};
+
+static const uint8_t PROTECTION_CONDITION_OVP = 1 << 0;
+static const uint8_t PROTECTION_CONDITION_OCP = 1 << 1;
+static const uint8_t PROTECTION_CONDITION_OPP = 1 << 2;
+
 enum ChannelMode {
     CHANNEL_MODE_UR,
     CHANNEL_MODE_CC,
@@ -210,23 +232,82 @@ typedef float(*YtDataGetValueFunctionPointer)(uint32_t rowIndex, uint8_t columnI
 struct ChannelHistory {
     friend struct Channel;
 
-    ChannelHistory(Channel& channel_) : channel(channel_) {}
+    /// LEVEL_VIEW is sampled at the channel YT view rate. Other levels have fixed
+    /// sample period and each one is fed by decimating the level below it.
+    enum Level {
+        LEVEL_VIEW,
+        LEVEL_SECONDS,
+        LEVEL_MINUTES,
+        LEVEL_HOURS,
+        NUM_LEVELS
+    };
+
+    /// Min, max and average of all the measurements taken during the sample period.
+    struct Sample {
+        float uMin;
+        float uMax;
+        float uAvg;
+        float iMin;
+        float iMax;
+        float iAvg;
+        // power is calculated for each measurement, uMax * iMax is not the max power
+        float pMin;
+        float pMax;
+        float pAvg;
+    };
+
+    ChannelHistory(Channel& channel_);
 
     void reset();
+    /// Long term levels are kept when only the view rate is changed.
+    void resetViewLevel();
     void update(uint32_t tickCount);
 
+    /// View rates of 1 s, 1 min and 1 h are displayed from the long term levels.
+    Level getViewLevel();
+    uint32_t getPosition(Level level);
+    const Sample &getSample(Level level, uint32_t position);
+    /// Oldest position still in the history, positions from there up to (not including) getPosition are valid.
+    uint32_t getFirstPosition(Level level);
+    /// Time between two samples in seconds.
+    float getPeriod(Level level);
+
+    /// Value function returns average if max is nullptr, otherwise it returns min and sets max.
     static YtDataGetValueFunctionPointer getChannelHistoryValueFuncs(int channelIndex);
 
 protected:
+    struct Accumulator {
+        float uMin;
+        float uMax;
+        float uSum;
+        float iMin;
+        float iMax;
+        float iSum;
+        float pMin;
+        float pMax;
+        float pSum;
+        uint32_t count;
+
+        void reset();
+        void add(float u, float i);
+        void add(const Sample &sample);
+        void getSample(Sample &sample);
+    };
+
     bool historyStarted;
-    float uHistory[CHANNEL_HISTORY_SIZE];
-    float iHistory[CHANNEL_HISTORY_SIZE];
-    uint32_t historyPosition;
-    uint32_t historyLastTick;
+    Sample *samples;
+    uint32_t positions[NUM_LEVELS];
+    Accumulator accumulators[NUM_LEVELS];
+    uint32_t viewLastTick;
+    uint32_t secondsLastTick;
+
+    void addSample(Level level);
 
 private: 
     Channel& channel;
 
+    static float getHistoryValue(int channelIndex, uint32_t rowIndex, uint8_t columnIndex, float *max);
+
     static float getChannel0HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max);
     static float getChannel1HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max);
     static float getChannel2HistoryValue(uint32_t rowIndex, uint8_t columnIndex, float *max);
@@ -329,6 +410,7 @@ public:
 
         float triggerLevel;
         float rampDuration;
+        uint8_t rampShape; // ramp::RampShape
 
         void init(float set_, float step_, float limit_);
         void resetMonValues();
@@ -406,6 +488,10 @@ public:
     ProtectionValue ocp;
     ProtectionValue opp;
 
+    ProtectionThresholds protectionThresholds;
+    // Set from any thread, thresholds are rebuilt only by the PSU thread in protectionCheck().
+    volatile bool protectionThresholdsChanged;
+
     float ytViewRate;
 
     float outputDelayDuration;
@@ -442,6 +528,18 @@ public:
 
     static void updateAllChannels();
 
+    /// Must be called after protection configuration or set values are changed.
+    /// Thresholds are rebuilt before the next protection check.
+    void updateProtectionThresholds();
+    static void updateAllProtectionThresholds();
+
+    /// Returns PROTECTION_CONDITION_* bits of the protections whose condition is met for the given measured values.
+    uint8_t getProtectionConditions(float uMon, float uMonDac, float iMon);
+
+    /// Delay timer state machine: IDLE -> ALARMED when condition is met, ALARMED -> IDLE when condition
+    /// is no longer met, ALARMED -> IDLE and returns true when condition is met for the delay duration.
+    static bool protectionDelayStep(ProtectionValue &cpv, bool condition, uint32_t delay, uint32_t time);
+
     /// Is channel output enabled?
     bool isOutputEnabled();
 
@@ -558,6 +656,8 @@ public:
     bool isCurrentLimitExceeded(float i);
 
     uint32_t getCurrentHistoryValuePosition();
+    int getHistoryViewLevel();
+    ChannelHistory *getHistory() { return channelHistory; }
 
     static void resetHistoryForAllChannels();
     void resetHistory();
@@ -662,6 +762,9 @@ public:
 
     virtual void readAllRegisters(uint8_t ioexpRegisters[], uint8_t adcRegisters[]);
 
+    /// Returns false if channel doesn't collect ADC statistics.
+    virtual bool getAdcStatistics(float &samplesPerSecond, float &spiTransactionsPerSecond);
+
     virtual void getVoltageStepValues(StepValues *stepValues, bool calibrationMode) = 0;
     virtual void getCurrentStepValues(StepValues *stepValues, bool calibrationMode) = 0;
     virtual void getPowerStepValues(StepValues *stepValues) = 0;
@@ -702,10 +805,9 @@ private:
     int reg_get_ques_isum_bit_mask_for_channel_protection_value(ProtectionValue &cpv);
 
     void clearProtectionConf();
-    void protectionCheck(ProtectionValue &cpv);
     void protectionCheck();
 
-    bool checkSwOvpCondition();
+    void doUpdateProtectionThresholds();
     float getSwOvpProtectionLevel();
 
     void doCalibrationEnable(bool enable);
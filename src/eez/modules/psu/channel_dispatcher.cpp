@@ -24,6 +24,7 @@
 #include <eez/modules/psu/channel_dispatcher.h>
 #include <eez/modules/psu/event_queue.h>
 #include <eez/modules/psu/list_program.h>
+#include <eez/modules/psu/ramp.h>
 #include <eez/modules/psu/gui/psu.h>
 #include <eez/scpi/regs.h>
 #include <eez/modules/psu/temperature.h>
@@ -38,10 +39,40 @@ namespace channel_dispatcher {
 
 static CouplingType g_couplingType = COUPLING_TYPE_NONE;
 
+// Sums of monitored values of channels 1 and 2, so getters for coupled channel
+// don't have to combine both channels on every call (GUI reads these values
+// many times per frame). Updated whenever channel 1 or 2 monitored values change.
+static struct {
+    float uMon;
+    float uMonLast;
+    float uMonDac;
+    float uMonDacLast;
+    float iMon;
+    float iMonLast;
+    float iMonDac;
+} g_coupledMonValues;
+
 CouplingType getCouplingType() {
     return g_couplingType;
 }
 
+void updateCoupledMonValues(const Channel &channel) {
+    if (channel.channelIndex >= 2 || CH_NUM < 2) {
+        return;
+    }
+
+    Channel &channel1 = Channel::get(0);
+    Channel &channel2 = Channel::get(1);
+
+    g_coupledMonValues.uMon = channel1.u.mon + channel2.u.mon;
+    g_coupledMonValues.uMonLast = channel1.u.mon_last + channel2.u.mon_last;
+    g_coupledMonValues.uMonDac = channel1.u.mon_dac + channel2.u.mon_dac;
+    g_coupledMonValues.uMonDacLast = channel1.u.mon_dac_last + channel2.u.mon_dac_last;
+    g_coupledMonValues.iMon = channel1.i.mon + channel2.i.mon;
+    g_coupledMonValues.iMonLast = channel1.i.mon_last + channel2.i.mon_last;
+    g_coupledMonValues.iMonDac = channel1.i.mon_dac + channel2.i.mon_dac;
+}
+
 bool isTrackingAllowed(Channel &channel, int *err) {
     if (!channel.isOk()) {
         if (err) {
@@ -227,6 +258,7 @@ void setCouplingTypeInPsuThread(CouplingType couplingType) {
                 channel.ytViewRate = channel1.ytViewRate;
 
                 channel.u.rampDuration = channel1.u.rampDuration;
+                channel.u.rampShape = channel1.u.rampShape;
             }
 
             channel.setCurrentRangeSelectionMode(CURRENT_RANGE_SELECTION_USE_BOTH);
@@ -274,6 +306,12 @@ void setCouplingTypeInPsuThread(CouplingType couplingType) {
     g_couplingType = couplingType;
     bp3c::io_exp::switchChannelCoupling(g_couplingType);
 
+    if (CH_NUM >= 2) {
+        updateCoupledMonValues(Channel::get(0));
+    }
+
+    Channel::updateAllProtectionThresholds();
+
     if (g_couplingType == COUPLING_TYPE_PARALLEL) {
         event_queue::pushEvent(event_queue::EVENT_INFO_COUPLED_IN_PARALLEL);
     } else if (g_couplingType == COUPLING_TYPE_SERIES) {
@@ -423,14 +461,18 @@ void setTrackingChannels(uint16_t trackingEnabled) {
                     temperature::sensors[temp_sensor::CH1 + i].prot_conf.delay = t_delay;
 
                     trackingChannel.u.rampDuration = RAMP_DURATION_DEF_VALUE_U;
+                    trackingChannel.u.rampShape = ramp::RAMP_SHAPE_LINEAR;
 
                     trackingChannel.i.rampDuration = RAMP_DURATION_DEF_VALUE_I;
+                    trackingChannel.i.rampShape = ramp::RAMP_SHAPE_LINEAR;
 
                     trackingChannel.resetHistory();
                 }
             }
         }
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 CouplingType getType() {
@@ -485,14 +527,14 @@ float getUSet(int slotIndex, int subchannelIndex) {
 
 float getUMon(const Channel &channel) {
     if (channel.channelIndex < 2 && g_couplingType == COUPLING_TYPE_SERIES) {
-        return Channel::get(0).u.mon + Channel::get(1).u.mon;
+        return g_coupledMonValues.uMon;
     }
     return channel.u.mon;
 }
 
 float getUMonLast(const Channel &channel) {
     if (channel.channelIndex < 2 && g_couplingType == COUPLING_TYPE_SERIES) {
-        return Channel::get(0).u.mon_last + Channel::get(1).u.mon_last;
+        return g_coupledMonValues.uMonLast;
     }
     return channel.u.mon_last;
 }
@@ -510,14 +552,14 @@ float getUMonLast(int slotIndex, int subchannelIndex) {
 
 float getUMonDac(const Channel &channel) {
     if (channel.channelIndex < 2 && g_couplingType == COUPLING_TYPE_SERIES) {
-        return Channel::get(0).u.mon_dac + Channel::get(1).u.mon_dac;
+        return g_coupledMonValues.uMonDac;
     }
     return channel.u.mon_dac;
 }
 
 float getUMonDacLast(const Channel &channel) {
     if (channel.channelIndex < 2 && g_couplingType == COUPLING_TYPE_SERIES) {
-        return Channel::get(0).u.mon_dac_last + Channel::get(1).u.mon_dac_last;
+        return g_coupledMonValues.uMonDacLast;
     }
     return channel.u.mon_dac_last;
 }
@@ -754,6 +796,8 @@ void setOvpParameters(Channel &channel, int state, int type, float level, float
         channel.prot_conf.u_level = roundPrec(level, channel.getVoltageResolution());
         channel.prot_conf.u_delay = delay;
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 void setOvpState(Channel &channel, int state) {
@@ -770,6 +814,8 @@ void setOvpState(Channel &channel, int state) {
     } else {
         channel.prot_conf.flags.u_state = state;
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 void setOvpType(Channel &channel, int type) {
@@ -794,6 +840,8 @@ void setOvpType(Channel &channel, int type) {
             channel.prot_conf.flags.u_type = type;
         }
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 void setOvpLevel(Channel &channel, float level) {
@@ -813,6 +861,8 @@ void setOvpLevel(Channel &channel, float level) {
     } else {
         channel.prot_conf.u_level = roundPrec(level, channel.getVoltageResolution());
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 void setOvpDelay(Channel &channel, float delay) {
@@ -831,6 +881,8 @@ void setOvpDelay(Channel &channel, float delay) {
     } else {
         channel.prot_conf.u_delay = delay;
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 float getISet(const Channel &channel) {
@@ -853,14 +905,14 @@ float getISet(int slotIndex, int subchannelIndex) {
 
 float getIMon(const Channel &channel) {
     if (channel.channelIndex < 2 && g_couplingType == COUPLING_TYPE_PARALLEL) {
-        return Channel::get(0).i.mon + Channel::get(1).i.mon;
+        return g_coupledMonValues.iMon;
     }
     return channel.i.mon;
 }
 
 float getIMonLast(const Channel &channel) {
     if (channel.channelIndex < 2 && g_couplingType == COUPLING_TYPE_PARALLEL) {
-        return Channel::get(0).i.mon_last + Channel::get(1).i.mon_last;
+        return g_coupledMonValues.iMonLast;
     }
     return channel.i.mon_last;
 }
@@ -878,7 +930,7 @@ float getIMonLast(int slotIndex, int subchannelIndex) {
 
 float getIMonDac(const Channel &channel) {
     if (channel.channelIndex < 2 && g_couplingType == COUPLING_TYPE_PARALLEL) {
-        return Channel::get(0).i.mon_dac + Channel::get(1).i.mon_dac;
+        return g_coupledMonValues.iMonDac;
     }
     return channel.i.mon_dac;
 }
@@ -1025,6 +1077,46 @@ void setCurrent(Channel &channel, float current) {
     }
 }
 
+void setVoltageAndCurrentInPsuThread(int channelIndex) {
+    setVoltageAndCurrent(Channel::get(channelIndex), g_setVoltageValues[channelIndex], g_setCurrentValues[channelIndex]);
+}
+
+void setVoltageAndCurrent(Channel &channel, float voltage, float current) {
+    if (!isPsuThread()) {
+        g_setVoltageValues[channel.channelIndex] = voltage;
+        g_setCurrentValues[channel.channelIndex] = current;
+        sendMessageToPsu(PSU_MESSAGE_SET_VOLTAGE_AND_CURRENT, channel.channelIndex);
+        return;
+    }
+
+    if (channel.channelIndex < 2 && g_couplingType == COUPLING_TYPE_SERIES) {
+        voltage /= 2;
+        for (int i = 0; i < 2; ++i) {
+            Channel::get(i).setVoltage(voltage);
+            Channel::get(i).setCurrent(current);
+        }
+    } else if (channel.channelIndex < 2 && g_couplingType == COUPLING_TYPE_PARALLEL) {
+        current /= 2;
+        for (int i = 0; i < 2; ++i) {
+            Channel::get(i).setVoltage(voltage);
+            Channel::get(i).setCurrent(current);
+        }
+    } else if (channel.flags.trackingEnabled) {
+        voltage = roundTrackingValuePrecision(UNIT_VOLT, voltage);
+        current = roundTrackingValuePrecision(UNIT_AMPER, current);
+        for (int i = 0; i < CH_NUM; ++i) {
+            Channel &trackingChannel = Channel::get(i);
+            if (trackingChannel.flags.trackingEnabled) {
+                trackingChannel.setVoltage(voltage);
+                trackingChannel.setCurrent(current);
+            }
+        }
+    } else {
+        channel.setVoltage(voltage);
+        channel.setCurrent(current);
+    }
+}
+
 void setCurrentStep(Channel &channel, float currentStep) {
     if (channel.channelIndex < 2 && (g_couplingType == COUPLING_TYPE_SERIES || g_couplingType == COUPLING_TYPE_PARALLEL)) {
         Channel::get(0).i.step = currentStep;
@@ -1084,6 +1176,8 @@ void setOcpParameters(Channel &channel, int state, float delay) {
         channel.prot_conf.flags.i_state = state;
         channel.prot_conf.i_delay = delay;
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 void setOcpState(Channel &channel, int state) {
@@ -1099,6 +1193,8 @@ void setOcpState(Channel &channel, int state) {
     } else {
         channel.prot_conf.flags.i_state = state;
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 void setOcpDelay(Channel &channel, float delay) {
@@ -1117,6 +1213,8 @@ void setOcpDelay(Channel &channel, float delay) {
     } else {
         channel.prot_conf.i_delay = delay;
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 float getPowerLimit(const Channel &channel) {
@@ -1224,6 +1322,8 @@ void setOppParameters(Channel &channel, int state, float level, float delay) {
         channel.prot_conf.p_level = roundPrec(level, channel.getPowerResolution());
         channel.prot_conf.p_delay = delay;
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 void setOppState(Channel &channel, int state) {
@@ -1240,6 +1340,8 @@ void setOppState(Channel &channel, int state) {
     } else {
         channel.prot_conf.flags.p_state = state;
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 void setOppLevel(Channel &channel, float level) {
@@ -1261,6 +1363,8 @@ void setOppLevel(Channel &channel, float level) {
     } else {
         channel.prot_conf.p_level = roundPrec(level, channel.getPowerResolution());
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 void setOppDelay(Channel &channel, float delay) {
@@ -1279,6 +1383,8 @@ void setOppDelay(Channel &channel, float delay) {
     } else {
         channel.prot_conf.p_delay = delay;
     }
+
+    Channel::updateAllProtectionThresholds();
 }
 
 void setVoltageRampDuration(Channel &channel, float duration) {
@@ -1317,6 +1423,38 @@ void setCurrentRampDuration(Channel &channel, float duration) {
     }
 }
 
+void setVoltageRampShape(Channel &channel, uint8_t shape) {
+    if (channel.channelIndex < 2 && (g_couplingType == COUPLING_TYPE_SERIES || g_couplingType == COUPLING_TYPE_PARALLEL)) {
+        Channel::get(0).u.rampShape = shape;
+        Channel::get(1).u.rampShape = shape;
+    } else if (channel.flags.trackingEnabled) {
+        for (int i = 0; i < CH_NUM; ++i) {
+            Channel &trackingChannel = Channel::get(i);
+            if (trackingChannel.flags.trackingEnabled) {
+                trackingChannel.u.rampShape = shape;
+            }
+        }
+    } else {
+        channel.u.rampShape = shape;
+    }
+}
+
+void setCurrentRampShape(Channel &channel, uint8_t shape) {
+    if (channel.channelIndex < 2 && (g_couplingType == COUPLING_TYPE_SERIES || g_couplingType == COUPLING_TYPE_PARALLEL)) {
+        Channel::get(0).i.rampShape = shape;
+        Channel::get(1).i.rampShape = shape;
+    } else if (channel.flags.trackingEnabled) {
+        for (int i = 0; i < CH_NUM; ++i) {
+            Channel &trackingChannel = Channel::get(i);
+            if (trackingChannel.flags.trackingEnabled) {
+                trackingChannel.i.rampShape = shape;
+            }
+        }
+    } else {
+        channel.i.rampShape = shape;
+    }
+}
+
 void setOutputDelayDuration(Channel &channel, float duration) {
     duration = roundPrec(duration, RAMP_DURATION_PREC);
 
@@ -1996,6 +2134,22 @@ void setListCount(Channel &channel, uint16_t value) {
     }
 }
 
+void setListTiming(Channel &channel, uint8_t timing) {
+    if (channel.channelIndex < 2 && (g_couplingType == COUPLING_TYPE_SERIES || g_couplingType == COUPLING_TYPE_PARALLEL)) {
+        list::setTiming(Channel::get(0), (list::ListTiming)timing);
+        list::setTiming(Channel::get(1), (list::ListTiming)timing);
+    } else if (channel.flags.trackingEnabled) {
+        for (int i = 0; i < CH_NUM; ++i) {
+            Channel &trackingChannel = Channel::get(i);
+            if (trackingChannel.flags.trackingEnabled) {
+                list::setTiming(trackingChannel, (list::ListTiming)timing);
+            }
+        }
+    } else {
+        list::setTiming(channel, (list::ListTiming)timing);
+    }
+}
+
 void setCurrentRangeSelectionMode(Channel &channel, CurrentRangeSelectionMode mode) {
     if (!isPsuThread()) {
         sendMessageToPsu(PSU_MESSAGE_SET_CURRENT_RANGE_SELECTION_MODE, (channel.channelIndex << 8) | mode );
@@ -2123,6 +2277,7 @@ const char *copyChannelToChannel(int srcChannelIndex, int dstChannelIndex) {
 
     if (dstChannel.params.features & CH_FEATURE_RPROG) {
         dstChannel.flags.rprogEnabled = srcChannel.flags.rprogEnabled;
+        dstChannel.updateProtectionThresholds();
     }
 
     auto displayValue1 = srcChannel.flags.displayValue1;
@@ -2374,6 +2529,80 @@ bool getMeasuredCurrent(int slotIndex, int subchannelIndex, float &value, int *e
     }
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+
+static float getCallsPerSecond(uint32_t numCalls, uint32_t startUsec) {
+    uint32_t durationUsec = micros() - startUsec;
+    if (durationUsec == 0) {
+        durationUsec = 1;
+    }
+    return numCalls * 1000000.0f / durationUsec;
+}
+
+bool runBenchmark(int numIterations, BenchmarkResult &result, int *err) {
+    if (CH_NUM < 2) {
+        if (err) {
+            *err = SCPI_ERROR_HARDWARE_MISSING;
+        }
+        return false;
+    }
+
+    Channel &channel = Channel::get(0);
+
+    static const CouplingType couplingTypes[] = {
+        COUPLING_TYPE_NONE,
+        COUPLING_TYPE_SERIES,
+        COUPLING_TYPE_PARALLEL
+    };
+
+    static const int NUM_GETTERS = 6;
+
+    volatile float sum = 0;
+
+    CouplingType savedCouplingType = g_couplingType;
+
+    for (int i = 0; i < 3; i++) {
+        g_couplingType = couplingTypes[i];
+
+        uint32_t start = micros();
+
+        for (int j = 0; j < numIterations; j++) {
+            sum += getUSet(channel);
+            sum += getUMon(channel);
+            sum += getUMonLast(channel);
+            sum += getISet(channel);
+            sum += getIMon(channel);
+            sum += getIMonLast(channel);
+        }
+
+        result.getCallsPerSecond[i] = getCallsPerSecond(NUM_GETTERS * numIterations, start);
+    }
+
+    g_couplingType = savedCouplingType;
+
+    float voltage = getUSet(channel);
+    float current = getISet(channel);
+
+    uint32_t start = micros();
+    for (int j = 0; j < numIterations; j++) {
+        setVoltage(channel, voltage);
+        setCurrent(channel, current);
+    }
+    result.setCallsPerSecond = getCallsPerSecond(numIterations, start);
+
+    start = micros();
+    for (int j = 0; j < numIterations; j++) {
+        setVoltageAndCurrent(channel, voltage, current);
+    }
+    result.setBatchCallsPerSecond = getCallsPerSecond(numIterations, start);
+
+    return true;
+}
+
+#endif
+
 } // namespace channel_dispatcher
 } // namespace psu
 } // namespace eez
@@ -42,6 +42,9 @@ bool setCouplingType(CouplingType couplingType, int *err);
 void setCouplingTypeInPsuThread(CouplingType couplingType);
 CouplingType getCouplingType();
 
+// Must be called after monitored values of the channel are changed.
+void updateCoupledMonValues(const Channel &channel);
+
 void setTrackingChannels(uint16_t trackingEnabled);
 
 float getValuePrecision(const Channel &channel, Unit unit, float value);
@@ -92,6 +95,9 @@ float getIMax(int slotIndex, int subchannelIndex);
 void setCurrent(Channel &channel, float current);
 void setCurrentStep(Channel &channel, float currentStep);
 void setCurrentLimit(Channel &channel, float limit);
+
+// Sets both values with a single coupling dispatch (and a single message to the PSU thread).
+void setVoltageAndCurrent(Channel &channel, float voltage, float current);
 void setOcpParameters(Channel &channel, int state, float delay);
 void setOcpState(Channel &channel, int state);
 void setOcpDelay(Channel &channel, float delay);
@@ -114,6 +120,8 @@ void setOppDelay(Channel &channel, float delay);
 
 void setVoltageRampDuration(Channel &channel, float duration);
 void setCurrentRampDuration(Channel &channel, float duration);
+void setVoltageRampShape(Channel &channel, uint8_t shape);
+void setCurrentRampShape(Channel &channel, uint8_t shape);
 
 void setOutputDelayDuration(Channel &channel, float duration);
 
@@ -165,6 +173,7 @@ void setDwellList(Channel &channel, float *list, uint16_t listLength);
 void setVoltageList(Channel &channel, float *list, uint16_t listLength);
 void setCurrentList(Channel &channel, float *list, uint16_t listLength);
 void setListCount(Channel &channel, uint16_t value);
+void setListTiming(Channel &channel, uint8_t timing);
 
 void setCurrentRangeSelectionMode(Channel &channel, CurrentRangeSelectionMode mode);
 void enableAutoSelectCurrentRange(Channel &channel, bool enable);
@@ -176,6 +185,7 @@ void setLoad(Channel &channel, float load);
 
 void setVoltageInPsuThread(int channelIndex);
 void setCurrentInPsuThread(int channelIndex);
+void setVoltageAndCurrentInPsuThread(int channelIndex);
 
 const char *copyChannelToChannel(int srcChannelIndex, int dstChannelIndex);
 
@@ -234,6 +244,18 @@ float getCurrentMaxValue(int slotIndex, int subchannelIndex);
 bool getMeasuredVoltage(int slotIndex, int subchannelIndex, float &value, int *err);
 bool getMeasuredCurrent(int slotIndex, int subchannelIndex, float &value, int *err);
 
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+struct BenchmarkResult {
+    float getCallsPerSecond[3]; // getters for channel 1 when uncoupled, in series and in parallel
+    float setCallsPerSecond; // setVoltage followed by setCurrent in the current coupling
+    float setBatchCallsPerSecond; // setVoltageAndCurrent in the current coupling
+};
+
+// Coupling type is switched temporarily (without touching the hardware) only for the getters,
+// setters write current set values back to channel 1.
+bool runBenchmark(int numIterations, BenchmarkResult &result, int *err);
+#endif
+
 } // namespace channel_dispatcher
 } // namespace psu
 } // namespace eez
@@ -87,6 +87,9 @@
 /// Temperature reading interval.
 #define TEMP_SENSOR_READ_EVERY_MS 1000
 
+/// Period of the temperature and fan control task.
+#define TEMPERATURE_TASK_PERIOD_MS 100
+
 /// Minimum OTP delay
 #define OTP_AUX_MIN_DELAY 0.0f
 
@@ -209,7 +212,8 @@
 
 #define GUI_YT_VIEW_RATE_DEFAULT 0.1f
 #define GUI_YT_VIEW_RATE_MIN 0.005f
-#define GUI_YT_VIEW_RATE_MAX 300.0f
+/// 1 h per sample, so the hourly level of the channel history (512 h) can be displayed.
+#define GUI_YT_VIEW_RATE_MAX 3600.0f
 
 #define MAX_LIST_LENGTH 256
 
@@ -339,6 +339,32 @@ bool getDateTimeAsString(char *buffer) {
     return false;
 }
 
+bool parseDateTime(const char *str, uint32_t &result) {
+    int year, month, day;
+    int hour = 0;
+    int minute = 0;
+    int second = 0;
+    int n = sscanf(str, "%d-%d-%d %d:%d:%d", &year, &month, &day, &hour, &minute, &second);
+    if (n < 3 || n == 4) {
+        return false;
+    }
+
+    if (year < 2000 || year > 2099 || month < 0 || month > 12 || day < 0 || day > 31) {
+        return false;
+    }
+
+    if (hour < 0 || hour > 23 || minute < 0 || minute > 59 || second < 0 || second > 59) {
+        return false;
+    }
+
+    if (!isValidDate((uint8_t)(year - 2000), (uint8_t)month, (uint8_t)day)) {
+        return false;
+    }
+
+    result = makeTime(year, month, day, hour, minute, second);
+    return true;
+}
+
 uint32_t now() {
     uint8_t year, month, day, hour, minute, second;
     rtc::readDateTime(year, month, day, hour, minute, second);
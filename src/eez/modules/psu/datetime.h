@@ -51,6 +51,11 @@ void convertTime12to24(uint8_t &hour, bool am);
 /// \returns true if successful.
 bool getDateTimeAsString(char *buffer);
 
+/// Parses date time given as "YYYY-MM-DD[ HH:MM[:SS]]".
+/// \param result Local time in seconds since 1970.
+/// \returns true if successful.
+bool parseDateTime(const char *str, uint32_t &result);
+
 uint32_t now();
 uint32_t nowUtc();
 
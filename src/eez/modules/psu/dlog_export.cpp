@@ -0,0 +1,456 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <string.h>
+#include <stdio.h>
+
+#include <eez/system.h>
+#include <eez/memory.h>
+
+#include <eez/modules/psu/psu.h>
+#include <eez/modules/psu/dlog_view.h>
+#include <eez/modules/psu/dlog_export.h>
+#include <eez/modules/psu/sd_card.h>
+#include <eez/modules/psu/scpi/psu.h>
+#if OPTION_DISPLAY
+#include <eez/modules/psu/gui/psu.h>
+#endif
+
+#include <eez/libs/sd_fat/sd_fat.h>
+
+namespace eez {
+namespace psu {
+namespace dlog_export {
+
+static const uint32_t INPUT_BUFFER_SIZE = 16 * 1024;
+static const uint32_t OUTPUT_BUFFER_SIZE = DLOG_EXPORT_MEMORY_SIZE - INPUT_BUFFER_SIZE;
+
+static uint8_t * const g_inputBuffer = DLOG_EXPORT_MEMORY;
+static char * const g_outputBuffer = (char *)(DLOG_EXPORT_MEMORY + INPUT_BUFFER_SIZE);
+
+// X value and all the Y values, each with separator, and line ending
+static const uint32_t MAX_ROW_LENGTH = (dlog_view::MAX_NUM_OF_Y_AXES + 1) * 18 + 2;
+
+static_assert(INPUT_BUFFER_SIZE >= dlog_view::MAX_NUM_OF_Y_AXES * sizeof(float), "INPUT_BUFFER_SIZE too small");
+static_assert(OUTPUT_BUFFER_SIZE >= 2 * MAX_ROW_LENGTH, "DLOG_EXPORT_MEMORY_SIZE too small");
+
+static bool g_exporting;
+static volatile bool g_abort;
+
+static char g_csvFilePath[MAX_PATH_LENGTH + 1];
+static File g_dlogFile;
+static File g_csvFile;
+
+static dlog_view::Recording g_recording;
+
+static uint32_t g_decimation;
+static uint32_t g_columns;
+static uint32_t g_rowSize;
+static uint32_t g_nextRowIndex;
+static uint32_t g_outputLength;
+
+////////////////////////////////////////////////////////////////////////////////
+
+static bool flush() {
+    if (g_outputLength > 0) {
+        if (g_csvFile.write(g_outputBuffer, g_outputLength) != g_outputLength) {
+            return false;
+        }
+        g_outputLength = 0;
+    }
+    return true;
+}
+
+static void appendText(const char *text) {
+    size_t length = strlen(text);
+    if (length > OUTPUT_BUFFER_SIZE - g_outputLength) {
+        length = OUTPUT_BUFFER_SIZE - g_outputLength;
+    }
+    memcpy(g_outputBuffer + g_outputLength, text, length);
+    g_outputLength += length;
+}
+
+static void appendUnit(Unit unit) {
+    const char *unitName = getUnitName(unit);
+    if (unit != UNIT_BIT && unitName && *unitName) {
+        appendText(" [");
+        appendText(unitName);
+        appendText("]");
+    }
+}
+
+static void writeHeaderRow() {
+    auto &xAxis = g_recording.parameters.xAxis;
+    appendText(xAxis.label[0] ? xAxis.label : xAxis.unit == UNIT_SECOND ? "Time" : "X");
+    appendUnit(xAxis.unit);
+
+    for (int yAxisIndex = 0; yAxisIndex < g_recording.parameters.numYAxes; yAxisIndex++) {
+        if (g_columns & (1 << yAxisIndex)) {
+            char label[dlog_view::MAX_LABEL_LENGTH + 1];
+            dlog_view::getLabel(g_recording, yAxisIndex, label, sizeof(label));
+
+            appendText(",");
+            appendText(label);
+            appendUnit(g_recording.parameters.yAxes[yAxisIndex].unit);
+        }
+    }
+
+    appendText("\r\n");
+}
+
+static void writeRow(uint32_t rowIndex, const float *values) {
+    char *p = g_outputBuffer + g_outputLength;
+
+    double x = g_recording.parameters.xAxis.range.min + (double)rowIndex * g_recording.parameters.xAxis.step;
+    p += sprintf(p, "%.9g", x);
+
+    // same layout as in dlog_view::calcColumnIndexes
+    uint32_t bitMask = 0;
+    uint32_t bits = 0;
+    uint32_t m = 0;
+
+    for (int yAxisIndex = 0; yAxisIndex < g_recording.parameters.numYAxes; yAxisIndex++) {
+        bool isBit = g_recording.parameters.yAxes[yAxisIndex].unit == UNIT_BIT;
+
+        float value = 0;
+        if (isBit) {
+            if (bitMask <= 1) {
+                bits = *(const uint32_t *)&values[m++];
+                bitMask = 0x8000;
+            } else {
+                bitMask >>= 1;
+            }
+        } else {
+            bitMask = 0;
+            value = values[m++];
+        }
+
+        if (g_columns & (1 << yAxisIndex)) {
+            *p++ = ',';
+            if (isBit) {
+                *p++ = (bits & bitMask) ? '1' : '0';
+            } else if (!isNaN(value)) {
+                p += sprintf(p, "%g", value);
+            }
+        }
+    }
+
+    *p++ = '\r';
+    *p++ = '\n';
+
+    g_outputLength = p - g_outputBuffer;
+}
+
+static void finish(int err) {
+    if (!err && !flush()) {
+        err = SCPI_ERROR_MASS_STORAGE_ERROR;
+    }
+
+    g_dlogFile.close();
+    g_csvFile.close();
+
+    if (err) {
+        sd_card::deleteFile(g_csvFilePath, nullptr);
+        if (err != SCPI_ERROR_FILE_TRANSFER_ABORTED) {
+            generateError(err);
+        }
+    } else {
+        onSdCardFileChangeHook(g_csvFilePath);
+    }
+
+#if OPTION_DISPLAY
+    psu::gui::hideProgressPage();
+#endif
+
+    g_exporting = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+bool start(const char *dlogFilePath, const char *csvFilePath, uint32_t decimation, uint32_t columns, int *err) {
+    if (g_exporting) {
+        *err = SCPI_ERROR_EXECUTION_ERROR;
+        return false;
+    }
+
+    if (decimation == 0) {
+        *err = SCPI_ERROR_ILLEGAL_PARAMETER_VALUE;
+        return false;
+    }
+
+    memset(&g_recording, 0, sizeof(g_recording));
+    g_nextRowIndex = 0;
+
+    if (!g_dlogFile.open(dlogFilePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        *err = SCPI_ERROR_FILE_NOT_FOUND;
+        return false;
+    }
+
+    if (!dlog_view::readFileHeader(g_dlogFile, g_recording, g_inputBuffer, INPUT_BUFFER_SIZE)) {
+        g_dlogFile.close();
+        *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+        return false;
+    }
+
+    uint32_t allColumns = (1 << g_recording.parameters.numYAxes) - 1;
+    if (columns == 0) {
+        columns = allColumns;
+    } else if (columns & ~allColumns) {
+        g_dlogFile.close();
+        *err = SCPI_ERROR_DATA_OUT_OF_RANGE;
+        return false;
+    }
+
+    if (!g_csvFile.open(csvFilePath, FILE_CREATE_ALWAYS | FILE_WRITE)) {
+        g_dlogFile.close();
+        *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+        return false;
+    }
+
+    strcpy(g_csvFilePath, csvFilePath);
+
+    g_decimation = decimation;
+    g_columns = columns;
+    g_rowSize = g_recording.numFloatsPerRow * sizeof(float);
+    g_outputLength = 0;
+    g_abort = false;
+
+    writeHeaderRow();
+
+    g_exporting = true;
+
+#if OPTION_DISPLAY
+    psu::gui::showProgressPage("Exporting to CSV...", abort);
+#endif
+
+    return true;
+}
+
+void abort() {
+    g_abort = true;
+}
+
+bool isExporting() {
+    return g_exporting;
+}
+
+float getProgress() {
+    if (g_recording.numSamples == 0) {
+        return g_exporting ? 0 : 100.0f;
+    }
+    return 100.0f * MIN(g_nextRowIndex, g_recording.numSamples) / g_recording.numSamples;
+}
+
+void tick() {
+    if (!g_exporting) {
+        return;
+    }
+
+    if (g_abort) {
+        finish(SCPI_ERROR_FILE_TRANSFER_ABORTED);
+        return;
+    }
+
+    if (g_nextRowIndex >= g_recording.numSamples) {
+        finish(0);
+        return;
+    }
+
+    // read as many rows as fits in the input buffer, but stop after the last row that is going to be exported
+    uint32_t numRows = MIN(g_recording.numSamples - g_nextRowIndex, INPUT_BUFFER_SIZE / g_rowSize);
+    numRows = MIN(numRows, (numRows - 1) / g_decimation * g_decimation + 1);
+
+    if (!g_dlogFile.seek(g_recording.dataOffset + g_nextRowIndex * g_rowSize)) {
+        finish(SCPI_ERROR_MASS_STORAGE_ERROR);
+        return;
+    }
+
+    uint32_t bytesToRead = numRows * g_rowSize;
+    if (g_dlogFile.read(g_inputBuffer, bytesToRead) != bytesToRead) {
+        finish(SCPI_ERROR_MASS_STORAGE_ERROR);
+        return;
+    }
+
+    for (uint32_t i = 0; i < numRows; i += g_decimation) {
+        if (OUTPUT_BUFFER_SIZE - g_outputLength < MAX_ROW_LENGTH) {
+            if (!flush()) {
+                finish(SCPI_ERROR_MASS_STORAGE_ERROR);
+                return;
+            }
+        }
+
+        writeRow(g_nextRowIndex + i, (const float *)(g_inputBuffer + i * g_rowSize));
+    }
+
+    g_nextRowIndex += ((numRows - 1) / g_decimation + 1) * g_decimation;
+
+#if OPTION_DISPLAY
+    if (!psu::gui::updateProgressPage(MIN(g_nextRowIndex, g_recording.numSamples), g_recording.numSamples)) {
+        // progress page is closed
+        g_abort = true;
+    }
+#endif
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+
+static const char *BENCHMARK_DLOG_FILE_PATH = "/dlog_export_benchmark.dlog";
+static const char *BENCHMARK_CSV_FILE_PATH = "/dlog_export_benchmark.csv";
+
+static const int BENCHMARK_NUM_Y_AXES = 6;
+
+static uint8_t *g_benchmarkBuffer;
+
+static void benchmarkWrite(const void *data, uint32_t size) {
+    memcpy(g_benchmarkBuffer, data, size);
+    g_benchmarkBuffer += size;
+}
+
+static void benchmarkWriteField(uint8_t fieldId, int yAxisIndex, const void *data, uint16_t size) {
+    uint16_t fieldLength = sizeof(uint16_t) + sizeof(uint8_t) + (yAxisIndex != -1 ? sizeof(uint8_t) : 0) + size;
+    benchmarkWrite(&fieldLength, sizeof(fieldLength));
+    benchmarkWrite(&fieldId, sizeof(fieldId));
+    if (yAxisIndex != -1) {
+        uint8_t index = (uint8_t)(yAxisIndex + 1);
+        benchmarkWrite(&index, sizeof(index));
+    }
+    benchmarkWrite(data, size);
+}
+
+static bool generateBenchmarkFile(uint32_t size, uint32_t &numRows) {
+    File file;
+    if (!file.open(BENCHMARK_DLOG_FILE_PATH, FILE_CREATE_ALWAYS | FILE_WRITE)) {
+        return false;
+    }
+
+    static const float PERIOD = 0.001f;
+
+    uint32_t rowSize = BENCHMARK_NUM_Y_AXES * sizeof(float);
+    numRows = size / rowSize;
+
+    // header (format version 2), channels 1-3 voltage and current
+    g_benchmarkBuffer = DLOG_EXPORT_MEMORY;
+
+    uint32_t magic1 = dlog_view::MAGIC1;
+    uint32_t magic2 = dlog_view::MAGIC2;
+    uint16_t version = dlog_view::VERSION2;
+    uint16_t numColumns = BENCHMARK_NUM_Y_AXES;
+    benchmarkWrite(&magic1, sizeof(magic1));
+    benchmarkWrite(&magic2, sizeof(magic2));
+    benchmarkWrite(&version, sizeof(version));
+    benchmarkWrite(&numColumns, sizeof(numColumns));
+    uint32_t *dataOffset = (uint32_t *)g_benchmarkBuffer;
+    benchmarkWrite(&magic1, sizeof(uint32_t));
+
+    uint8_t xUnit = UNIT_SECOND;
+    float xStep = PERIOD;
+    float xRangeMax = numRows * PERIOD;
+    benchmarkWriteField(dlog_view::FIELD_ID_X_UNIT, -1, &xUnit, sizeof(xUnit));
+    benchmarkWriteField(dlog_view::FIELD_ID_X_STEP, -1, &xStep, sizeof(xStep));
+    benchmarkWriteField(dlog_view::FIELD_ID_X_RANGE_MAX, -1, &xRangeMax, sizeof(xRangeMax));
+
+    for (int yAxisIndex = 0; yAxisIndex < BENCHMARK_NUM_Y_AXES; yAxisIndex++) {
+        uint8_t yUnit = yAxisIndex % 2 == 0 ? UNIT_VOLT : UNIT_AMPER;
+        uint8_t channelIndex = (uint8_t)(yAxisIndex / 2 + 1);
+        benchmarkWriteField(dlog_view::FIELD_ID_Y_UNIT, yAxisIndex, &yUnit, sizeof(yUnit));
+        benchmarkWriteField(dlog_view::FIELD_ID_Y_CHANNEL_INDEX, yAxisIndex, &channelIndex, sizeof(channelIndex));
+    }
+
+    // header is padded so that data starts at the row boundary
+    uint32_t headerSize = (g_benchmarkBuffer - DLOG_EXPORT_MEMORY + rowSize - 1) / rowSize * rowSize;
+    memset(g_benchmarkBuffer, 0, DLOG_EXPORT_MEMORY + headerSize - g_benchmarkBuffer);
+    *dataOffset = headerSize;
+
+    if (file.write(DLOG_EXPORT_MEMORY, headerSize) != headerSize) {
+        file.close();
+        return false;
+    }
+
+    // data
+    uint32_t numRowsPerChunk = DLOG_EXPORT_MEMORY_SIZE / rowSize;
+    for (uint32_t rowIndex = 0; rowIndex < numRows; ) {
+        uint32_t n = MIN(numRowsPerChunk, numRows - rowIndex);
+
+        float *values = (float *)DLOG_EXPORT_MEMORY;
+        for (uint32_t i = 0; i < n; i++, rowIndex++) {
+            for (int yAxisIndex = 0; yAxisIndex < BENCHMARK_NUM_Y_AXES; yAxisIndex++) {
+                float value = (rowIndex % 1000) * 0.01f + yAxisIndex;
+                *values++ = yAxisIndex % 2 == 0 ? value : value / 10.0f;
+            }
+        }
+
+        if (file.write(DLOG_EXPORT_MEMORY, n * rowSize) != n * rowSize) {
+            file.close();
+            return false;
+        }
+    }
+
+    return file.close();
+}
+
+bool runBenchmark(uint32_t sizeMB, uint32_t decimation, BenchmarkResult &result, int *err) {
+    if (g_exporting) {
+        *err = SCPI_ERROR_EXECUTION_ERROR;
+        return false;
+    }
+
+    uint32_t startTime = millis();
+    if (!generateBenchmarkFile(sizeMB * 1024 * 1024, result.numRows)) {
+        sd_card::deleteFile(BENCHMARK_DLOG_FILE_PATH, nullptr);
+        *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+        return false;
+    }
+    result.generateTimeMs = millis() - startTime;
+
+    startTime = millis();
+    bool success = start(BENCHMARK_DLOG_FILE_PATH, BENCHMARK_CSV_FILE_PATH, decimation, 0, err);
+    if (success) {
+        result.dlogFileSize = g_dlogFile.size();
+
+        while (g_exporting) {
+            tick();
+        }
+
+        success = g_nextRowIndex >= g_recording.numSamples;
+        if (!success) {
+            *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+        }
+    }
+    result.exportTimeMs = millis() - startTime;
+
+    if (success) {
+        File file;
+        if (file.open(BENCHMARK_CSV_FILE_PATH, FILE_OPEN_EXISTING | FILE_READ)) {
+            result.csvFileSize = file.size();
+            file.close();
+        }
+    }
+
+    sd_card::deleteFile(BENCHMARK_DLOG_FILE_PATH, nullptr);
+    sd_card::deleteFile(BENCHMARK_CSV_FILE_PATH, nullptr);
+
+    return success;
+}
+
+#endif
+
+} // namespace dlog_export
+} // namespace psu
+} // namespace eez
@@ -0,0 +1,63 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+namespace eez {
+namespace psu {
+namespace dlog_export {
+
+// Export of dlog file to CSV. First CSV column is X value (usually time),
+// followed by the selected Y values, bits (digital inputs) are exported as 0/1.
+//
+// Export is done in the low priority thread, one chunk of rows per call to tick(),
+// so memory usage doesn't depend on the size of dlog file.
+
+// columns is bit mask of Y values to export (bit 0 is the first Y value), 0 means all,
+// every n-th row is exported where n is decimation.
+bool start(const char *dlogFilePath, const char *csvFilePath, uint32_t decimation, uint32_t columns, int *err);
+void abort();
+
+bool isExporting();
+
+// percentage of rows processed in the current (or last) export
+float getProgress();
+
+// called from the low priority thread
+void tick();
+
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+
+struct BenchmarkResult {
+    uint32_t dlogFileSize;
+    uint32_t csvFileSize;
+    uint32_t numRows;
+    uint32_t generateTimeMs;
+    uint32_t exportTimeMs;
+};
+
+// Generates dlog file of given size (in MB) and exports it to CSV.
+bool runBenchmark(uint32_t sizeMB, uint32_t decimation, BenchmarkResult &result, int *err);
+
+#endif
+
+} // namespace dlog_export
+} // namespace psu
+} // namespace eez
@@ -856,6 +856,50 @@ void log(float *values) {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+uint32_t getFirstAvailableRow() {
+    uint32_t rowSize = g_recording.numFloatsPerRow * 4;
+    if (rowSize == 0 || g_bufferIndex <= g_recording.dataOffset + DLOG_RECORD_BUFFER_SIZE) {
+        return 0;
+    }
+
+    // first row which starts after the oldest byte still in the buffer
+    return (g_bufferIndex - DLOG_RECORD_BUFFER_SIZE - g_recording.dataOffset + rowSize - 1) / rowSize;
+}
+
+uint32_t readRows(uint32_t rowIndex, uint32_t numRows, float *values) {
+    if (osMutexWait(g_mutexId, 5) != osOK) {
+        return 0;
+    }
+
+    uint32_t i;
+    for (i = 0; i < numRows; i++, rowIndex++) {
+        if (rowIndex < getFirstAvailableRow() || rowIndex >= g_recording.size) {
+            break;
+        }
+
+        for (int yAxisIndex = 0; yAxisIndex < g_recording.parameters.numYAxes; yAxisIndex++) {
+            auto p = DLOG_RECORD_BUFFER + (
+                    g_recording.dataOffset + (
+                        rowIndex * g_recording.numFloatsPerRow
+                        + g_recording.columnFloatIndexes[yAxisIndex]
+                    ) * 4
+                ) % DLOG_RECORD_BUFFER_SIZE;
+
+            if (g_recording.parameters.yAxes[yAxisIndex].unit == UNIT_BIT) {
+                *values++ = *(uint32_t *)p & (0x8000 >> g_recording.parameters.yAxes[yAxisIndex].channelIndex) ? 1.0f : 0.0f;
+            } else {
+                *values++ = *(float *)p;
+            }
+        }
+    }
+
+    osMutexRelease(g_mutexId);
+
+    return i;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 const char *getLatestFilePath() {
     return g_recording.parameters.filePath[0] != 0 ? g_recording.parameters.filePath : nullptr;
 }
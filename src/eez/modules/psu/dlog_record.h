@@ -72,6 +72,13 @@ void tick(uint32_t tick_usec);
 void log(float *values);
 
 void fileWrite(bool flush = false);
+
+/// Oldest row still in the record buffer, rows from there up to g_recording.size can be read.
+uint32_t getFirstAvailableRow();
+/// Reads values of all Y axes (bits as 0 or 1) for numRows rows starting at rowIndex.
+/// Returns number of rows read, it is less than numRows if some row is no longer
+/// (or not yet) in the record buffer.
+uint32_t readRows(uint32_t rowIndex, uint32_t numRows, float *values);
 void stateTransition(int event, int *perr = nullptr);
 
 const char *getLatestFilePath();
@@ -60,6 +60,7 @@ Recording g_recording;
 
 struct CacheBlock {
     unsigned valid: 1;
+    unsigned prefetched: 1; // loaded by prefetcher and not accessed yet
     uint32_t loadedValues;
     uint32_t startAddress;
 };
@@ -73,8 +74,17 @@ static const uint32_t NUM_ELEMENTS_PER_BLOCKS = 480 * MAX_NUM_OF_Y_VALUES;
 static const uint32_t BLOCK_SIZE = NUM_ELEMENTS_PER_BLOCKS * sizeof(BlockElement);
 static const uint32_t NUM_BLOCKS = FILE_VIEW_BUFFER_SIZE / (BLOCK_SIZE + sizeof(CacheBlock));
 
+// number of pages prefetched in the scroll direction and in the opposite direction
+static const uint32_t PREFETCH_PAGES_AHEAD = 2;
+static const uint32_t PREFETCH_PAGES_BEHIND = 1;
+
+// all blocks are invalidated on every x axis div change, so wait for zooming to stop
+static const uint32_t PREFETCH_ZOOM_SETTLE_TIME_MS = 500;
+
 CacheBlock *g_cacheBlocks = (CacheBlock *)FILE_VIEW_BUFFER;
 
+CacheStatistics g_cacheStatistics;
+
 static bool g_isLoading;
 static bool g_interruptLoading;
 static uint32_t g_blockIndexToLoad;
@@ -82,6 +92,10 @@ static float g_loadScale;
 static bool g_refreshed;
 static bool g_wasExecuting;
 
+static uint32_t g_lastPosition;
+static int g_scrollDirection = 1;
+static uint32_t g_lastXAxisDivChangeTickCount;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 eez_err_t Parameters::enableDlogItem(int slotIndex, int subchannelIndex, int resourceIndex, bool enable) {
@@ -259,6 +273,124 @@ void invalidateAllBlocks() {
     }
 }
 
+// Cache is direct mapped, block is kept in the slot (block number % NUM_BLOCKS), so blocks
+// closer than NUM_BLOCKS to each other never replace each other.
+static unsigned getCacheBlockIndex(uint32_t blockStartAddress) {
+    unsigned blockIndex = (blockStartAddress / BLOCK_SIZE) % NUM_BLOCKS;
+
+    if (!(g_cacheBlocks[blockIndex].valid && g_cacheBlocks[blockIndex].startAddress == blockStartAddress)) {
+        BlockElement *blockElements = getCacheBlock(blockIndex);
+        for (unsigned i = 0; i < NUM_ELEMENTS_PER_BLOCKS; i++) {
+            blockElements[i].min = NAN;
+            blockElements[i].max = NAN;
+        }
+
+        g_cacheBlocks[blockIndex].valid = 1;
+        g_cacheBlocks[blockIndex].prefetched = 0;
+        g_cacheBlocks[blockIndex].loadedValues = 0;
+        g_cacheBlocks[blockIndex].startAddress = blockStartAddress;
+    }
+
+    return blockIndex;
+}
+
+static void requestBlockLoad(unsigned blockIndex) {
+    g_isLoading = true;
+    g_interruptLoading = false;
+    g_blockIndexToLoad = blockIndex;
+    g_loadScale = g_recording.xAxisDiv / g_recording.xAxisDivMin;
+
+    sendMessageToLowPriorityThread(THREAD_MESSAGE_DLOG_LOAD_BLOCK);
+}
+
+static bool isBlockLoaded(uint32_t blockNumber) {
+    unsigned blockIndex = blockNumber % NUM_BLOCKS;
+    return g_cacheBlocks[blockIndex].valid &&
+        g_cacheBlocks[blockIndex].startAddress == blockNumber * BLOCK_SIZE &&
+        g_cacheBlocks[blockIndex].loadedValues == NUM_ELEMENTS_PER_BLOCKS;
+}
+
+static bool prefetchBlock(int32_t blockNumber, uint32_t numBlocks, uint32_t firstVisibleBlock, uint32_t lastVisibleBlock) {
+    if (blockNumber < 0 || (uint32_t)blockNumber >= numBlocks || isBlockLoaded(blockNumber)) {
+        return false;
+    }
+
+    // never replace a block from the visible window
+    unsigned blockIndex = blockNumber % NUM_BLOCKS;
+    if (g_cacheBlocks[blockIndex].valid) {
+        uint32_t cachedBlockNumber = g_cacheBlocks[blockIndex].startAddress / BLOCK_SIZE;
+        if (cachedBlockNumber != (uint32_t)blockNumber && cachedBlockNumber >= firstVisibleBlock && cachedBlockNumber <= lastVisibleBlock) {
+            return false;
+        }
+    }
+
+    blockIndex = getCacheBlockIndex(blockNumber * BLOCK_SIZE);
+    if (!g_cacheBlocks[blockIndex].prefetched && g_cacheBlocks[blockIndex].loadedValues == 0) {
+        g_cacheBlocks[blockIndex].prefetched = 1;
+        g_cacheStatistics.prefetchLoads++;
+    }
+
+    requestBlockLoad(blockIndex);
+    return true;
+}
+
+// Loads blocks around the visible window while the visible window is fully loaded and
+// nothing else is loading, nearest blocks in the scroll direction first.
+static void prefetchBlocks() {
+    uint32_t position = getPosition(g_recording);
+    if (position > g_lastPosition) {
+        g_scrollDirection = 1;
+    } else if (position < g_lastPosition) {
+        g_scrollDirection = -1;
+    }
+    g_lastPosition = position;
+
+    if (g_isLoading || millis() - g_lastXAxisDivChangeTickCount < PREFETCH_ZOOM_SETTLE_TIME_MS) {
+        return;
+    }
+
+    uint32_t rowSize = getNumElementsPerRow() * sizeof(BlockElement);
+    if (rowSize == 0 || g_recording.size == 0) {
+        return;
+    }
+
+    uint32_t numBlocks = (g_recording.size * rowSize + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    uint32_t firstVisibleBlock = position * rowSize / BLOCK_SIZE;
+    uint32_t lastVisibleBlock = MIN(((position + g_recording.pageSize) * rowSize - 1) / BLOCK_SIZE, numBlocks - 1);
+    uint32_t numVisibleBlocks = lastVisibleBlock - firstVisibleBlock + 1;
+    if (numVisibleBlocks >= NUM_BLOCKS) {
+        return;
+    }
+
+    // visible window is loaded on demand from getValue
+    for (uint32_t blockNumber = firstVisibleBlock; blockNumber <= lastVisibleBlock; blockNumber++) {
+        if (!isBlockLoaded(blockNumber)) {
+            return;
+        }
+    }
+
+    // whole prefetch span must fit in the cache, so that prefetched blocks don't replace each other
+    uint32_t maxPrefetchBlocks = NUM_BLOCKS - numVisibleBlocks;
+    uint32_t numBlocksAhead = MIN(PREFETCH_PAGES_AHEAD * numVisibleBlocks, maxPrefetchBlocks);
+    uint32_t numBlocksBehind = MIN(PREFETCH_PAGES_BEHIND * numVisibleBlocks, maxPrefetchBlocks - numBlocksAhead);
+
+    int32_t aheadBlock = g_scrollDirection > 0 ? lastVisibleBlock : firstVisibleBlock;
+    int32_t behindBlock = g_scrollDirection > 0 ? firstVisibleBlock : lastVisibleBlock;
+
+    for (uint32_t i = 1; i <= MAX(numBlocksAhead, numBlocksBehind); i++) {
+        if (i <= numBlocksAhead && prefetchBlock(aheadBlock + g_scrollDirection * (int32_t)i, numBlocks, firstVisibleBlock, lastVisibleBlock)) {
+            return;
+        }
+        if (i <= numBlocksBehind && prefetchBlock(behindBlock - g_scrollDirection * (int32_t)i, numBlocks, firstVisibleBlock, lastVisibleBlock)) {
+            return;
+        }
+    }
+}
+
+void resetCacheStatistics() {
+    memset(&g_cacheStatistics, 0, sizeof(g_cacheStatistics));
+}
+
 void loadBlock() {
     static const int NUM_VALUES_ROWS = 16;
     float values[18 * NUM_VALUES_ROWS];
@@ -383,39 +515,38 @@ void stateManagment() {
         ++g_recording.refreshCounter;
         g_refreshed = false;
     }
+
+    if (g_state == STATE_READY && &getRecording() == &g_recording && psu::gui::isPageOnStack(PAGE_ID_DLOG_VIEW)) {
+        prefetchBlocks();
+    }
 }
 
 float getValue(uint32_t rowIndex, uint8_t columnIndex, float *max) {
     uint32_t blockElementAddress = (rowIndex * getNumElementsPerRow() + columnIndex) * sizeof(BlockElement);
 
-    uint32_t blockIndex = blockElementAddress / BLOCK_SIZE;
-    uint32_t blockStartAddress = blockIndex * BLOCK_SIZE;
+    uint32_t blockStartAddress = blockElementAddress / BLOCK_SIZE * BLOCK_SIZE;
 
-    blockIndex %= NUM_BLOCKS;
+    unsigned blockIndex = getCacheBlockIndex(blockStartAddress);
 
     BlockElement *blockElements = getCacheBlock(blockIndex);
 
-    if (!(g_cacheBlocks[blockIndex].valid && g_cacheBlocks[blockIndex].startAddress == blockStartAddress)) {
-        for (unsigned i = 0; i < NUM_ELEMENTS_PER_BLOCKS; i++) {
-            blockElements[i].min = NAN;
-            blockElements[i].max = NAN;
-        }
+    uint32_t blockElementIndex = (blockElementAddress % BLOCK_SIZE) / sizeof(BlockElement);
 
-        g_cacheBlocks[blockIndex].valid = 1;
-        g_cacheBlocks[blockIndex].loadedValues = 0;
-        g_cacheBlocks[blockIndex].startAddress = blockStartAddress;
+    if (blockElementIndex < g_cacheBlocks[blockIndex].loadedValues) {
+        g_cacheStatistics.valueHits++;
+    } else {
+        g_cacheStatistics.valueMisses++;
     }
 
-    if (g_cacheBlocks[blockIndex].loadedValues < NUM_ELEMENTS_PER_BLOCKS && !g_isLoading) {
-        g_isLoading = true;
-        g_interruptLoading = false;
-        g_blockIndexToLoad = blockIndex;
-        g_loadScale = g_recording.xAxisDiv / g_recording.xAxisDivMin;
-
-        sendMessageToLowPriorityThread(THREAD_MESSAGE_DLOG_LOAD_BLOCK);
+    if (g_cacheBlocks[blockIndex].prefetched) {
+        g_cacheBlocks[blockIndex].prefetched = 0;
+        g_cacheStatistics.prefetchHits++;
     }
 
-    uint32_t blockElementIndex = (blockElementAddress % BLOCK_SIZE) / sizeof(BlockElement);
+    if (g_cacheBlocks[blockIndex].loadedValues < NUM_ELEMENTS_PER_BLOCKS && !g_isLoading) {
+        g_cacheStatistics.demandLoads++;
+        requestBlockLoad(blockIndex);
+    }
 
     BlockElement *blockElement = blockElements + blockElementIndex;
 
@@ -488,6 +619,8 @@ void changeXAxisDiv(Recording &recording, float xAxisDiv) {
         
         adjustXAxisOffset(recording);
 
+        g_lastXAxisDivChangeTickCount = millis();
+
         invalidateAllBlocks();
     }
 }
@@ -779,202 +912,223 @@ void scaleToFit(Recording &recording) {
     }
 }
 
-bool openFile(const char *filePath, int *err) {
-    if (!isLowPriorityThread()) {
-        g_state = STATE_LOADING;
-        g_loadingStartTickCount = millis();
+bool readFileHeader(File &file, Recording &recording, uint8_t *buffer, uint32_t bufferSize) {
+    uint32_t read = file.read(buffer, DLOG_VERSION1_HEADER_SIZE);
+    if (read != DLOG_VERSION1_HEADER_SIZE) {
+        return false;
+    }
 
-        strcpy(g_filePath, filePath);
-        memset(&g_recording, 0, sizeof(Recording));
+    uint32_t offset = 0;
 
-        sendMessageToLowPriorityThread(THREAD_MESSAGE_DLOG_SHOW_FILE);
-        return true;
+    uint32_t magic1 = readUint32(buffer, offset);
+    uint32_t magic2 = readUint32(buffer, offset);
+    uint16_t version = readUint16(buffer, offset);
+
+    if (magic1 != MAGIC1 || magic2 != MAGIC2 || (version != VERSION1 && version != VERSION2)) {
+        return false;
     }
 
-    g_state = STATE_LOADING;
+    bool invalidHeader = false;
 
-    File file;
-    if (file.open(filePath != nullptr ? filePath : g_filePath, FILE_OPEN_EXISTING | FILE_READ)) {
-        uint8_t * buffer = FILE_VIEW_BUFFER;
-        uint32_t read = file.read(buffer, DLOG_VERSION1_HEADER_SIZE);
-        if (read == DLOG_VERSION1_HEADER_SIZE) {
-            uint32_t offset = 0;
+    if (version == VERSION1) {
+        recording.dataOffset = DLOG_VERSION1_HEADER_SIZE;
 
-            uint32_t magic1 = readUint32(buffer, offset);
-            uint32_t magic2 = readUint32(buffer, offset);
-            uint16_t version = readUint16(buffer, offset);
+        readUint16(buffer, offset); // flags
+        uint32_t columns = readUint32(buffer, offset);
+        float period = readFloat(buffer, offset);
+        float duration = readFloat(buffer, offset);
+        readUint32(buffer, offset); // startTime
 
-            if (magic1 == MAGIC1 && magic2 == MAGIC2 && (version == VERSION1 || version == VERSION2)) {
-                bool invalidHeader = false;
+        recording.parameters.period = period;
+        recording.parameters.time = duration;
 
-                if (version == VERSION1) {
-                    g_recording.dataOffset = DLOG_VERSION1_HEADER_SIZE;
+        for (int channelIndex = 0; channelIndex < CH_MAX; ++channelIndex) {
+            if (columns & (1 << (4 * channelIndex))) {
+                recording.parameters.enableDlogItem(255, channelIndex, 0, true);
+            }
 
-                    readUint16(buffer, offset); // flags
-                    uint32_t columns = readUint32(buffer, offset);
-                    float period = readFloat(buffer, offset);
-                    float duration = readFloat(buffer, offset);
-                    readUint32(buffer, offset); // startTime
+            if (columns & (2 << (4 * channelIndex))) {
+                recording.parameters.enableDlogItem(255, channelIndex, 1, true);
+            }
 
-                    g_recording.parameters.period = period;
-                    g_recording.parameters.time = duration;
+            if (columns & (4 << (4 * channelIndex))) {
+                recording.parameters.enableDlogItem(255, channelIndex, 2, true);
+            }
+        }
 
-                    for (int channelIndex = 0; channelIndex < CH_MAX; ++channelIndex) {
-                        if (columns & (1 << (4 * channelIndex))) {
-                            g_recording.parameters.enableDlogItem(255, channelIndex, 0, true);
-                        }
+        initAxis(recording);
+    } else {
+        readUint16(buffer, offset); // No. of columns
+        recording.dataOffset = readUint32(buffer, offset);
+
+        // read the rest of the header
+        if (recording.dataOffset > bufferSize) {
+            invalidHeader = true;
+        } else if (DLOG_VERSION1_HEADER_SIZE < recording.dataOffset) {
+            uint32_t headerRemaining = recording.dataOffset - DLOG_VERSION1_HEADER_SIZE;
+            uint32_t read = file.read(buffer + DLOG_VERSION1_HEADER_SIZE, headerRemaining);
+            if (read != headerRemaining) {
+                invalidHeader = true;
+            }
+        }
 
-                        if (columns & (2 << (4 * channelIndex))) {
-                            g_recording.parameters.enableDlogItem(255, channelIndex, 1, true);
-                        }
+        while (!invalidHeader && offset < recording.dataOffset) {
+            uint16_t fieldLength = readUint16(buffer, offset);
+            if (fieldLength == 0) {
+                break;
+            }
 
-                        if (columns & (4 << (4 * channelIndex))) {
-                            g_recording.parameters.enableDlogItem(255, channelIndex, 2, true);
-                        }
-                    }
+            if (offset - sizeof(uint16_t) + fieldLength > recording.dataOffset) {
+                invalidHeader = true;
+                break;
+            }
 
-                    initAxis(g_recording);
-                } else {
-                    readUint16(buffer, offset); // No. of columns
-                    g_recording.dataOffset = readUint32(buffer, offset);
-
-                    // read the rest of the header
-                    if (DLOG_VERSION1_HEADER_SIZE < g_recording.dataOffset) {
-                        uint32_t headerRemaining = g_recording.dataOffset - DLOG_VERSION1_HEADER_SIZE;
-                        uint32_t read = file.read(buffer + DLOG_VERSION1_HEADER_SIZE, headerRemaining);
-                        if (read != headerRemaining) {
-                            invalidHeader = true;
-                        }
-                    }
+            uint8_t fieldId = readUint8(buffer, offset);
 
-                    while (!invalidHeader && offset < g_recording.dataOffset) {
-                        uint16_t fieldLength = readUint16(buffer, offset);
-                        if (fieldLength == 0) {
-                        	break;
-                        }
+            uint16_t fieldDataLength = fieldLength - sizeof(uint16_t) - sizeof(uint8_t);
 
-                        if (offset - sizeof(uint16_t) + fieldLength > g_recording.dataOffset) {
-                            invalidHeader = true;
-                            break;
-                        }
+            if (fieldId == FIELD_ID_COMMENT) {
+                if (fieldDataLength > MAX_COMMENT_LENGTH) {
+                    invalidHeader = true;
+                    break;
+                }
+                for (int i = 0; i < fieldDataLength; i++) {
+                    recording.parameters.comment[i] = readUint8(buffer, offset);
+                }
+                recording.parameters.comment[MAX_COMMENT_LENGTH] = 0;
+            } else if (fieldId == FIELD_ID_X_UNIT) {
+                recording.parameters.xAxis.unit = (Unit)readUint8(buffer, offset);
+            } else if (fieldId == FIELD_ID_X_STEP) {
+                recording.parameters.xAxis.step = readFloat(buffer, offset);
+            } else if (fieldId == FIELD_ID_X_SCALE) {
+                recording.parameters.xAxis.scale = (Scale)readUint8(buffer, offset);
+            } else if (fieldId == FIELD_ID_X_RANGE_MIN) {
+                recording.parameters.xAxis.range.min = readFloat(buffer, offset);
+            } else if (fieldId == FIELD_ID_X_RANGE_MAX) {
+                recording.parameters.xAxis.range.max = readFloat(buffer, offset);
+            } else if (fieldId == FIELD_ID_X_LABEL) {
+                if (fieldDataLength > MAX_LABEL_LENGTH) {
+                    invalidHeader = true;
+                    break;
+                }
+                for (int i = 0; i < fieldDataLength; i++) {
+                    recording.parameters.xAxis.label[i] = readUint8(buffer, offset);
+                }
+                recording.parameters.xAxis.label[MAX_LABEL_LENGTH] = 0;
+            } else if (fieldId >= FIELD_ID_Y_UNIT && fieldId <= FIELD_ID_Y_CHANNEL_INDEX) {
+                int8_t yAxisIndex = (int8_t)readUint8(buffer, offset);
+                if (yAxisIndex > MAX_NUM_OF_Y_AXES) {
+                    invalidHeader = true;
+                    break;
+                }
 
-                        uint8_t fieldId = readUint8(buffer, offset);
+                fieldDataLength -= sizeof(uint8_t);
 
-                        uint16_t fieldDataLength = fieldLength - sizeof(uint16_t) - sizeof(uint8_t);
+                yAxisIndex--;
+                if (yAxisIndex >= recording.parameters.numYAxes) {
+                    recording.parameters.numYAxes = yAxisIndex + 1;
+                    initYAxis(recording.parameters, yAxisIndex);
+                }
 
-                        if (fieldId == FIELD_ID_COMMENT) {
-                            if (fieldDataLength > MAX_COMMENT_LENGTH) {
-                                invalidHeader = true;
-                                break;
-                            }
-                            for (int i = 0; i < fieldDataLength; i++) {
-                                g_recording.parameters.comment[i] = readUint8(buffer, offset);
-                            }
-                            g_recording.parameters.comment[MAX_COMMENT_LENGTH] = 0;
-                        } else if (fieldId == FIELD_ID_X_UNIT) {
-                            g_recording.parameters.xAxis.unit = (Unit)readUint8(buffer, offset);
-                        } else if (fieldId == FIELD_ID_X_STEP) {
-                            g_recording.parameters.xAxis.step = readFloat(buffer, offset);
-                        } else if (fieldId == FIELD_ID_X_SCALE) {
-                            g_recording.parameters.xAxis.scale = (Scale)readUint8(buffer, offset);
-                        } else if (fieldId == FIELD_ID_X_RANGE_MIN) {
-                            g_recording.parameters.xAxis.range.min = readFloat(buffer, offset);
-                        } else if (fieldId == FIELD_ID_X_RANGE_MAX) {
-                            g_recording.parameters.xAxis.range.max = readFloat(buffer, offset);
-                        } else if (fieldId == FIELD_ID_X_LABEL) {
-                            if (fieldDataLength > MAX_LABEL_LENGTH) {
-                                invalidHeader = true;
-                                break;
-                            }
-                            for (int i = 0; i < fieldDataLength; i++) {
-                                g_recording.parameters.xAxis.label[i] = readUint8(buffer, offset);
-                            }
-                            g_recording.parameters.xAxis.label[MAX_LABEL_LENGTH] = 0;
-                        } else if (fieldId >= FIELD_ID_Y_UNIT && fieldId <= FIELD_ID_Y_CHANNEL_INDEX) {
-                            int8_t yAxisIndex = (int8_t)readUint8(buffer, offset);
-                            if (yAxisIndex > MAX_NUM_OF_Y_AXES) {
-                                invalidHeader = true;
-                                break;
-                            }
+                YAxis &destYAxis = yAxisIndex >= 0 ? recording.parameters.yAxes[yAxisIndex] : recording.parameters.yAxis;
+
+                if (fieldId == FIELD_ID_Y_UNIT) {
+                    destYAxis.unit = (Unit)readUint8(buffer, offset);
+                } else if (fieldId == FIELD_ID_Y_RANGE_MIN) {
+                    destYAxis.range.min = readFloat(buffer, offset);
+                } else if (fieldId == FIELD_ID_Y_RANGE_MAX) {
+                    destYAxis.range.max = readFloat(buffer, offset);
+                } else if (fieldId == FIELD_ID_Y_LABEL) {
+                    if (fieldDataLength > MAX_LABEL_LENGTH) {
+                        invalidHeader = true;
+                        break;
+                    }
+                    for (int i = 0; i < fieldDataLength; i++) {
+                        destYAxis.label[i] = readUint8(buffer, offset);
+                    }
+                    destYAxis.label[MAX_LABEL_LENGTH] = 0;
+                } else if (fieldId == FIELD_ID_Y_CHANNEL_INDEX) {
+                    destYAxis.channelIndex = (int16_t)(readUint8(buffer, offset)) - 1;
+                } else {
+                    // unknown field, skip
+                    offset += fieldDataLength;
+                }
+            } else if (fieldId == FIELD_ID_Y_SCALE) {
+                recording.parameters.yAxisScale = (Scale)readUint8(buffer, offset);
+            } else if (fieldId == FIELD_ID_CHANNEL_MODULE_TYPE) {
+                readUint8(buffer, offset); // channel index
+                readUint16(buffer, offset); // module type
+            } else if (fieldId == FIELD_ID_CHANNEL_MODULE_REVISION) {
+                readUint8(buffer, offset); // channel index
+                readUint16(buffer, offset); // module revision
+            } else {
+                // unknown field, skip
+                offset += fieldDataLength;
+            }
+        }
 
-                            fieldDataLength -= sizeof(uint8_t);
+        recording.parameters.period = recording.parameters.xAxis.step;
+        recording.parameters.time = recording.parameters.xAxis.range.max - recording.parameters.xAxis.range.min;
+    }
 
-                            yAxisIndex--;
-                            if (yAxisIndex >= g_recording.parameters.numYAxes) {
-                                g_recording.parameters.numYAxes = yAxisIndex + 1;
-                                initYAxis(g_recording.parameters, yAxisIndex);
-                            }
+    if (invalidHeader) {
+        return false;
+    }
 
-                            YAxis &destYAxis = yAxisIndex >= 0 ? g_recording.parameters.yAxes[yAxisIndex] : g_recording.parameters.yAxis;
-
-                            if (fieldId == FIELD_ID_Y_UNIT) {
-                                destYAxis.unit = (Unit)readUint8(buffer, offset);
-                            } else if (fieldId == FIELD_ID_Y_RANGE_MIN) {
-                                destYAxis.range.min = readFloat(buffer, offset);
-                            } else if (fieldId == FIELD_ID_Y_RANGE_MAX) {
-                                destYAxis.range.max = readFloat(buffer, offset);
-                            } else if (fieldId == FIELD_ID_Y_LABEL) {
-                                if (fieldDataLength > MAX_LABEL_LENGTH) {
-                                    invalidHeader = true;
-                                    break;
-                                }
-                                for (int i = 0; i < fieldDataLength; i++) {
-                                    destYAxis.label[i] = readUint8(buffer, offset);
-                                }
-                                destYAxis.label[MAX_LABEL_LENGTH] = 0;
-                            } else if (fieldId == FIELD_ID_Y_CHANNEL_INDEX) {
-                                destYAxis.channelIndex = (int16_t)(readUint8(buffer, offset)) - 1;
-                            } else {
-                                // unknown field, skip
-                                offset += fieldDataLength;
-                            }
-                        } else if (fieldId == FIELD_ID_Y_SCALE) {
-                            g_recording.parameters.yAxisScale = (Scale)readUint8(buffer, offset);
-                        } else if (fieldId == FIELD_ID_CHANNEL_MODULE_TYPE) {
-                            readUint8(buffer, offset); // channel index
-                            readUint16(buffer, offset); // module type
-                        } else if (fieldId == FIELD_ID_CHANNEL_MODULE_REVISION) {
-                            readUint8(buffer, offset); // channel index
-                            readUint16(buffer, offset); // module revision
-                        } else {
-                            // unknown field, skip
-                            offset += fieldDataLength;
-                        }
-                    }
+    calcColumnIndexes(recording);
+    if (recording.numFloatsPerRow == 0) {
+        return false;
+    }
 
-					g_recording.parameters.period = g_recording.parameters.xAxis.step;
-					g_recording.parameters.time = g_recording.parameters.xAxis.range.max - g_recording.parameters.xAxis.range.min;
-                }
+    recording.numSamples = (file.size() - recording.dataOffset) / (recording.numFloatsPerRow * sizeof(float));
 
-                if (!invalidHeader) {
-                    initDlogValues(g_recording);
-                    calcColumnIndexes(g_recording);
+    return true;
+}
 
-                    g_recording.pageSize = VIEW_WIDTH;
+bool openFile(const char *filePath, int *err) {
+    if (!isLowPriorityThread()) {
+        g_state = STATE_LOADING;
+        g_loadingStartTickCount = millis();
+
+        strcpy(g_filePath, filePath);
+        memset(&g_recording, 0, sizeof(Recording));
+
+        sendMessageToLowPriorityThread(THREAD_MESSAGE_DLOG_SHOW_FILE);
+        return true;
+    }
 
-                    g_recording.numSamples = (file.size() - g_recording.dataOffset) / (g_recording.numFloatsPerRow * sizeof(float));
-                    g_recording.xAxisDivMin = g_recording.pageSize * g_recording.parameters.period / NUM_HORZ_DIVISIONS;
-                    g_recording.xAxisDivMax = MAX(g_recording.numSamples, g_recording.pageSize) * g_recording.parameters.period / NUM_HORZ_DIVISIONS;
+    g_state = STATE_LOADING;
 
-                    g_recording.size = g_recording.numSamples;
+    File file;
+    if (file.open(filePath != nullptr ? filePath : g_filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        if (readFileHeader(file, g_recording, FILE_VIEW_BUFFER, FILE_VIEW_BUFFER_SIZE)) {
+            initDlogValues(g_recording);
 
-                    g_recording.xAxisOffset = 0.0f;
-                    g_recording.xAxisDiv = g_recording.xAxisDivMin;
+            g_recording.pageSize = VIEW_WIDTH;
 
-                    g_recording.cursorOffset = VIEW_WIDTH / 2;
+            g_recording.xAxisDivMin = g_recording.pageSize * g_recording.parameters.period / NUM_HORZ_DIVISIONS;
+            g_recording.xAxisDivMax = MAX(g_recording.numSamples, g_recording.pageSize) * g_recording.parameters.period / NUM_HORZ_DIVISIONS;
 
-                    g_recording.getValue = getValue;
-                    g_isLoading = false;
+            g_recording.size = g_recording.numSamples;
 
-                    if (isMulipleValuesOverlayHeuristic(g_recording)) {
-                        autoScale(g_recording);
-                    }
+            g_recording.xAxisOffset = 0.0f;
+            g_recording.xAxisDiv = g_recording.xAxisDivMin;
 
-                    g_state = STATE_READY;
+            g_recording.cursorOffset = VIEW_WIDTH / 2;
 
-                    invalidateAllBlocks();
-                }
+            g_recording.getValue = getValue;
+            g_isLoading = false;
+
+            g_lastPosition = 0;
+            g_scrollDirection = 1;
+
+            if (isMulipleValuesOverlayHeuristic(g_recording)) {
+                autoScale(g_recording);
             }
+
+            g_state = STATE_READY;
+
+            invalidateAllBlocks();
         }
 
         if (g_state != STATE_READY) {
@@ -54,6 +54,10 @@ OFFSET    TYPE    WIDTH    DESCRIPTION
 */
 
 namespace eez {
+
+// forward declaration
+class File;
+
 namespace psu {
 namespace dlog_view {
 
@@ -202,14 +206,31 @@ extern bool g_showLatest;
 // open dlog file for viewing
 bool openFile(const char *filePath, int *err = nullptr);
 
+// Parses dlog file header into recording (which should be zeroed before the call),
+// buffer must be large enough for the whole header. On success, file position is at
+// the first data row and recording.numFloatsPerRow and recording.numSamples are set.
+bool readFileHeader(File &file, Recording &recording, uint8_t *buffer, uint32_t bufferSize);
+
 extern State getState();
 
 // this is called from the thread that owns SD card
 void loadBlock();
 
-// this should be called during GUI state managment phase
+// this should be called during GUI state managment phase,
+// it also prefetches blocks around the visible window
 void stateManagment();
 
+struct CacheStatistics {
+    uint32_t valueHits;     // getValue found the value already loaded
+    uint32_t valueMisses;   // getValue found the value not yet loaded
+    uint32_t demandLoads;   // load requests from getValue
+    uint32_t prefetchLoads; // blocks loaded by prefetcher
+    uint32_t prefetchHits;  // prefetched blocks accessed afterwards by getValue
+};
+
+extern CacheStatistics g_cacheStatistics;
+void resetCacheStatistics();
+
 Recording &getRecording();
 
 void initAxis(Recording &recording);
@@ -42,6 +42,8 @@
 
 #include <eez/modules/psu/gui/psu.h>
 #include <eez/modules/psu/gui/animations.h>
+#include <eez/modules/psu/gui/file_manager.h>
+#include <eez/modules/psu/gui/keypad.h>
 #endif
 
 using namespace eez::psu::gui;
@@ -60,6 +62,17 @@ static const char *LOG_DEBUG_INDEX_FILE_NAME   = "index1";
 static const char *LOG_INFO_INDEX_FILE_NAME    = "index2";
 static const char *LOG_WARNING_INDEX_FILE_NAME = "index3";
 static const char *LOG_ERROR_INDEX_FILE_NAME   = "index4";
+static const char *LOG_TIME_INDEX_FILE_NAME    = "tindex";
+static const char *LOG_CHANNEL_INDEX_FILE_NAME = "chindex"; // followed by channel number
+
+// one time index entry is written for every TIME_INDEX_STRIDE events
+static const uint32_t TIME_INDEX_STRIDE = 32;
+
+// severity indexes, time index and channel indexes
+static const int NUM_INDEX_FILES = EVENT_TYPE_ERROR + 1 + CH_MAX;
+
+// number of log lines indexed in one tick while index files are rebuilt
+static const int REBUILD_INDEX_LINES_PER_TICK = 32;
 
 static const char *EVENT_TYPE_NAMES[] = {
     "NONE",
@@ -113,12 +126,45 @@ static Event g_events[EVENTS_PER_PAGE];
 
 static int g_selectedEventIndex = -1;
 
+static uint32_t g_goToDateTime;
+static bool g_goToDateTimeRequested;
+
+// Sparse time index entry, positions are event counts in index1 - index4
+// at the time the event was logged. Events before positions[i] in the index i + 1
+// were logged before (or at) dateTime and events after it were logged at or after dateTime.
+struct TimeIndexEntry {
+    uint32_t dateTime;
+    uint32_t positions[EVENT_TYPE_ERROR];
+};
+
+// Per channel index entry, every event related to the channel is indexed.
+struct ChannelIndexEntry {
+    uint32_t dateTime;
+    uint32_t logOffset;
+    int16_t eventId;
+    int16_t reserved;
+};
+
+// Index files are rebuilt in the background into the temporary files, which replace
+// index files when the whole log is indexed. Until then, events are found using
+// the severity indexes only.
+static volatile bool g_rebuildingIndexFiles;
+static uint32_t g_rebuildLogOffset;
+static File g_rebuildIndexFiles[EVENT_TYPE_ERROR];
+static uint32_t g_rebuildIndexSizes[EVENT_TYPE_ERROR];
+static File g_rebuildTimeIndexFile;
+// events of the same channel are usually logged together, so one channel index file is kept open
+static File g_rebuildChannelIndexFile;
+static int g_rebuildChannelIndex = -1;
+
 ////////////////////////////////////////////////////////////////////////////////
 
 static void addEventToWriteQueue(int16_t eventId, char *message, int channelIndex);
 static bool getEventFromWriteQueue(QueueEvent *queueEvent);
 
 static void getIndexFilePath(int indexType, char *filePath);
+static void getTimeIndexFilePath(char *filePath);
+static void getChannelIndexFilePath(int channelIndex, char *filePath);
 static void getLogFilePath(char *filePath);
 
 static int getEventType(int16_t eventId);
@@ -128,7 +174,12 @@ static void setDisplayFromPosition(uint32_t position);
 static void refreshEvents();
 
 static void writeEvent(QueueEvent *event);
+static void deleteIndexFiles();
+static void checkIndexFiles();
+static void closeRebuildIndexFiles();
+static void rebuildIndexFilesStep();
 static void readEvents(uint32_t fromPosition);
+static void goToDateTime(uint32_t dateTime);
 
 static Event *getEvent(uint32_t eventIndex);
 
@@ -143,6 +194,13 @@ void tick() {
     bool isSdCardMounted = sd_card::isMounted(nullptr);
     if (isSdCardMounted != g_isSdCardMounted) {
         g_refreshEvents = true;
+        if (isSdCardMounted) {
+            // log could be deleted or changed while SD card was not used by the firmware
+            checkIndexFiles();
+        } else {
+            // rebuild is started again when SD card is mounted
+            closeRebuildIndexFiles();
+        }
     }
     g_isSdCardMounted = isSdCardMounted;
 
@@ -152,6 +210,10 @@ void tick() {
             writeEvent(&queueEvent);
             g_previousDisplayFromPosition = -1;
         }
+
+        if (g_rebuildingIndexFiles) {
+            rebuildIndexFilesStep();
+        }
     }
 
 #if OPTION_DISPLAY
@@ -160,6 +222,11 @@ void tick() {
             refreshEvents();
         } 
 
+        if (g_goToDateTimeRequested) {
+            g_goToDateTimeRequested = false;
+            goToDateTime(g_goToDateTime);
+        }
+
         auto fromPosition = g_displayFromPosition;
         if (fromPosition != g_previousDisplayFromPosition) {
             readEvents(fromPosition);
@@ -174,6 +241,8 @@ void shutdownSave() {
     while (getEventFromWriteQueue(&queueEvent)) {
         writeEvent(&queueEvent);
     }
+
+    closeRebuildIndexFiles();
 }
 
 int16_t getLastErrorEventId() {
@@ -188,6 +257,10 @@ const char *getEventTypeName(int16_t eventId) {
     return EVENT_TYPE_NAMES[getEventType(eventId)];
 }
 
+const char *getEventTypeNameFromType(int eventType) {
+    return EVENT_TYPE_NAMES[eventType];
+}
+
 const char *getEventMessage(int16_t eventId) {
     static char message[35];
 
@@ -410,6 +483,16 @@ static void getIndexFilePath(int indexType, char *filePath) {
     }
 }
 
+static void getTimeIndexFilePath(char *filePath) {
+    strcpy(filePath, LOGS_DIR);
+    strcat(filePath, PATH_SEPARATOR);
+    strcat(filePath, LOG_TIME_INDEX_FILE_NAME);
+}
+
+static void getChannelIndexFilePath(int channelIndex, char *filePath) {
+    sprintf(filePath, "%s%s%s%d", LOGS_DIR, PATH_SEPARATOR, LOG_CHANNEL_INDEX_FILE_NAME, channelIndex + 1);
+}
+
 static void getLogFilePath(char *filePath) {
     strcpy(filePath, LOGS_DIR);
     strcat(filePath, PATH_SEPARATOR);
@@ -576,47 +659,119 @@ static bool writeToLog(QueueEvent *event, uint32_t &logOffset, int &eventType) {
     return result;
 }
 
-static void writeToIndex(int indexType, uint32_t logOffset) {
+// returns position of the added log offset within the index or -1 in case of error
+static uint32_t writeToIndex(int indexType, uint32_t logOffset) {
     char filePath[MAX_PATH_LENGTH];
     getIndexFilePath(indexType, filePath);
 
+    uint32_t position = (uint32_t)-1;
+
     File file;
     if (file.open(filePath, FILE_OPEN_APPEND | FILE_WRITE)) {
-        file.write((const uint8_t *)&logOffset, sizeof(uint32_t));
+        uint32_t size = file.size();
+        if (file.write((const uint8_t *)&logOffset, sizeof(uint32_t)) == sizeof(uint32_t)) {
+            position = size / 4;
+        }
         file.close();
     }
+
+    return position;
 }
 
-static void writeEvent(QueueEvent *event) {
-    uint32_t logOffset;
-    int eventType;
-    if (!writeToLog(event, logOffset, eventType)) {
-        return;
+static uint32_t getIndexSize(int indexType) {
+    char filePath[MAX_PATH_LENGTH];
+    getIndexFilePath(indexType, filePath);
+
+    uint32_t size = 0;
+
+    File file;
+    if (file.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        size = file.size() / 4;
+        file.close();
     }
 
-    if (eventType >= g_filter) {
-        g_refreshEvents = true;
+    return size;
+}
+
+static void writeToTimeIndex(uint32_t dateTime, int eventType, uint32_t *positions) {
+    TimeIndexEntry entry;
+    entry.dateTime = dateTime;
+    for (int indexType = EVENT_TYPE_DEBUG; indexType <= EVENT_TYPE_ERROR; indexType++) {
+        // event is not added to the indexes of higher severity
+        entry.positions[indexType - 1] = indexType <= eventType ? positions[indexType - 1] : getIndexSize(indexType);
     }
 
-    writeToIndex(EVENT_TYPE_DEBUG, logOffset);
+    char filePath[MAX_PATH_LENGTH];
+    getTimeIndexFilePath(filePath);
 
-    if (eventType == EVENT_TYPE_DEBUG) {
-        return;
+    File file;
+    if (file.open(filePath, FILE_OPEN_APPEND | FILE_WRITE)) {
+        file.write((const uint8_t *)&entry, sizeof(entry));
+        file.close();
     }
+}
 
-    writeToIndex(EVENT_TYPE_INFO, logOffset);
+static void writeToChannelIndex(QueueEvent *event, uint32_t logOffset) {
+    ChannelIndexEntry entry;
+    entry.dateTime = event->dateTime;
+    entry.logOffset = logOffset;
+    entry.eventId = event->eventId;
+    entry.reserved = 0;
 
-    if (eventType == EVENT_TYPE_INFO) {
-        return;
+    char filePath[MAX_PATH_LENGTH];
+    getChannelIndexFilePath(event->channelIndex, filePath);
+
+    File file;
+    if (file.open(filePath, FILE_OPEN_APPEND | FILE_WRITE)) {
+        file.write((const uint8_t *)&entry, sizeof(entry));
+        file.close();
+    }
+}
+
+static void writeToIndexes(QueueEvent *event, int eventType, uint32_t logOffset) {
+    // event is added to the indexes of its own and all the lower severities
+    uint32_t positions[EVENT_TYPE_ERROR];
+    positions[EVENT_TYPE_DEBUG - 1] = writeToIndex(EVENT_TYPE_DEBUG, logOffset);
+    for (int indexType = EVENT_TYPE_INFO; indexType <= eventType; indexType++) {
+        positions[indexType - 1] = writeToIndex(indexType, logOffset);
     }
 
-    writeToIndex(EVENT_TYPE_WARNING, logOffset);
+    if (event->channelIndex >= 0 && event->channelIndex < CH_MAX) {
+        writeToChannelIndex(event, logOffset);
+    }
 
-    if (eventType == EVENT_TYPE_WARNING) {
+    if (positions[EVENT_TYPE_DEBUG - 1] % TIME_INDEX_STRIDE == 0) {
+        writeToTimeIndex(event->dateTime, eventType, positions);
+    }
+}
+
+static void writeEvent(QueueEvent *event) {
+    uint32_t logOffset;
+    int eventType;
+    if (!writeToLog(event, logOffset, eventType)) {
         return;
     }
 
-    writeToIndex(EVENT_TYPE_ERROR, logOffset);
+    if (logOffset == 0) {
+        // log was cleared, index files are left from the old one
+        closeRebuildIndexFiles();
+        deleteIndexFiles();
+    }
+
+#if OPTION_DISPLAY
+    // log size has changed, but most of the time Logs directory is not listed in the file manager
+    if (eez::gui::file_manager::isDirectoryCataloged(LOGS_DIR)) {
+        char filePath[MAX_PATH_LENGTH];
+        getLogFilePath(filePath);
+        eez::gui::file_manager::invalidateCatalog(filePath);
+    }
+#endif
+
+    if (eventType >= g_filter) {
+        g_refreshEvents = true;
+    }
+
+    writeToIndexes(event, eventType, logOffset);
 }
 
 static void getEventInfoText(Event *e, char *text, int count) {
@@ -652,13 +807,14 @@ static void updateIsLongMessageText(Event &event) {
     event.isLongMessageText = mcu::display::measureStr(text, -1, font) > CONF_EVENT_LINE_WIDTH_PX;
 }
 
-static bool readEvent(File &indexFile, File &logFile, int eventIndex, Event &event) {
-    indexFile.seek(4 * (g_numEvents - 1 - eventIndex));
-    uint32_t logOffset;
-    if (indexFile.read(&logOffset, sizeof(uint32_t)) != sizeof(uint32_t)) {
+static bool readLogOffset(File &indexFile, uint32_t position, uint32_t &logOffset) {
+    if (!indexFile.seek(4 * position)) {
         return false;
     }
+    return indexFile.read(&logOffset, sizeof(uint32_t)) == sizeof(uint32_t);
+}
 
+static bool readLogEvent(File &logFile, uint32_t logOffset, Event &event) {
     logFile.seek(logOffset);
     using namespace sd_card;
     BufferedFileRead bufferedFile(logFile, 64);
@@ -728,13 +884,107 @@ static bool readEvent(File &indexFile, File &logFile, int eventIndex, Event &eve
     event.eventType = eventType;
     strcpy(event.message, message);
 
+    event.logOffset = logOffset;
+
+    return true;
+}
+
+static bool readEvent(File &indexFile, File &logFile, int eventIndex, Event &event) {
+    uint32_t logOffset;
+    if (!readLogOffset(indexFile, g_numEvents - 1 - eventIndex, logOffset)) {
+        return false;
+    }
+
+    if (!readLogEvent(logFile, logOffset, event)) {
+        return false;
+    }
+
     updateIsLongMessageText(event);
 
-    event.logOffset = logOffset;
+    return true;
+}
+
+static bool readEventDateTime(File &indexFile, File &logFile, uint32_t position, uint32_t &dateTime) {
+    uint32_t logOffset;
+    if (!readLogOffset(indexFile, position, logOffset)) {
+        return false;
+    }
 
+    Event event;
+    if (!readLogEvent(logFile, logOffset, event)) {
+        return false;
+    }
+
+    dateTime = event.dateTime;
     return true;
 }
 
+static bool readTimeIndexEntry(File &timeIndexFile, uint32_t entryIndex, TimeIndexEntry &entry) {
+    if (!timeIndexFile.seek(entryIndex * sizeof(TimeIndexEntry))) {
+        return false;
+    }
+    return timeIndexFile.read(&entry, sizeof(TimeIndexEntry)) == sizeof(TimeIndexEntry);
+}
+
+// Returns position within the index of the first event logged at or after dateTime.
+// Time index narrows down the range to TIME_INDEX_STRIDE events, so only a few
+// log lines are read. Log written before time index existed, or while time index
+// is rebuilt, is binary searched as a whole.
+static uint32_t findIndexPosition(File &indexFile, File &logFile, int indexType, uint32_t numEvents, uint32_t dateTime) {
+    uint32_t low = 0;
+    uint32_t high = numEvents;
+
+    char filePath[MAX_PATH_LENGTH];
+    getTimeIndexFilePath(filePath);
+    File timeIndexFile;
+    if (!g_rebuildingIndexFiles && timeIndexFile.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        uint32_t numEntries = timeIndexFile.size() / sizeof(TimeIndexEntry);
+
+        // find first entry logged at or after dateTime
+        uint32_t entryLow = 0;
+        uint32_t entryHigh = numEntries;
+        while (entryLow < entryHigh) {
+            uint32_t entryMid = (entryLow + entryHigh) / 2;
+            TimeIndexEntry entry;
+            if (!readTimeIndexEntry(timeIndexFile, entryMid, entry)) {
+                entryLow = 0;
+                entryHigh = 0;
+                break;
+            }
+            if (entry.dateTime < dateTime) {
+                entryLow = entryMid + 1;
+            } else {
+                entryHigh = entryMid;
+            }
+        }
+
+        TimeIndexEntry entry;
+        if (entryLow > 0 && readTimeIndexEntry(timeIndexFile, entryLow - 1, entry)) {
+            low = MIN(entry.positions[indexType - 1], numEvents);
+        }
+        if (entryLow < numEntries && readTimeIndexEntry(timeIndexFile, entryLow, entry)) {
+            high = MAX(MIN(entry.positions[indexType - 1], numEvents), low);
+        }
+
+        timeIndexFile.close();
+    }
+
+    while (low < high) {
+        uint32_t mid = (low + high) / 2;
+        uint32_t midDateTime;
+        if (!readEventDateTime(indexFile, logFile, mid, midDateTime)) {
+            break;
+        }
+        if (midDateTime < dateTime) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    return low;
+}
+
 static void readEvents(uint32_t fromPosition) {
     if (g_isSdCardMounted) {
         char filePath[MAX_PATH_LENGTH];
@@ -798,6 +1048,37 @@ static void readEvents(uint32_t fromPosition) {
     }
 }
 
+static void goToDateTime(uint32_t dateTime) {
+    if (!g_isSdCardMounted) {
+        return;
+    }
+
+    char filePath[MAX_PATH_LENGTH];
+    getIndexFilePath(g_filter, filePath);
+    File indexFile;
+    if (!indexFile.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        return;
+    }
+
+    getLogFilePath(filePath);
+    File logFile;
+    if (logFile.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        uint32_t position = findIndexPosition(indexFile, logFile, g_filter, g_numEvents, dateTime);
+
+        // newest events are displayed first, so put the first event
+        // logged at or after dateTime at the bottom of the page
+        if (position + EVENTS_PER_PAGE < g_numEvents) {
+            setDisplayFromPosition(g_numEvents - position - EVENTS_PER_PAGE);
+        } else {
+            setDisplayFromPosition(0);
+        }
+
+        logFile.close();
+    }
+
+    indexFile.close();
+}
+
 static Event *getEvent(uint32_t eventIndex) {
     return &g_events[(eventIndex - g_displayFromPosition) % EVENTS_PER_PAGE];
 }
@@ -814,6 +1095,449 @@ static Event *getSelectedEvent() {
     return &g_events[g_selectedEventIndex - g_displayFromPosition];
 }
 
+static bool isChannelEventMessage(const char *message, int channelIndex) {
+    return tolower(message[0]) == 'c' && tolower(message[1]) == 'h' && message[2] == '1' + channelIndex && !isdigit(message[3]);
+}
+
+static bool findChannelEvents(uint32_t fromDateTime, uint32_t toDateTime, int eventType, int channelIndex, int maxEvents, void *param, void (*callback)(void *param, uint32_t dateTime, int eventType, const char *message), File &logFile) {
+    char filePath[MAX_PATH_LENGTH];
+    getChannelIndexFilePath(channelIndex, filePath);
+    File file;
+    if (!file.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        // nothing logged for this channel yet
+        return true;
+    }
+
+    uint32_t numEntries = file.size() / sizeof(ChannelIndexEntry);
+
+    ChannelIndexEntry entry;
+
+    // find first entry logged at or after fromDateTime
+    uint32_t low = 0;
+    uint32_t high = numEntries;
+    while (low < high) {
+        uint32_t mid = (low + high) / 2;
+        if (!file.seek(mid * sizeof(ChannelIndexEntry)) || file.read(&entry, sizeof(entry)) != sizeof(entry)) {
+            file.close();
+            return false;
+        }
+        if (entry.dateTime < fromDateTime) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    bool result = true;
+
+    if (file.seek(low * sizeof(ChannelIndexEntry))) {
+        int numEvents = 0;
+        for (uint32_t i = low; i < numEntries && numEvents < maxEvents; i++) {
+            if (file.read(&entry, sizeof(entry)) != sizeof(entry)) {
+                result = false;
+                break;
+            }
+
+            if (entry.dateTime >= toDateTime) {
+                break;
+            }
+
+            // severity is known from the event ID, so only matching events are read from the log
+            if (getEventType(entry.eventId) < eventType) {
+                continue;
+            }
+
+            Event event;
+            if (!readLogEvent(logFile, entry.logOffset, event)) {
+                result = false;
+                break;
+            }
+
+            callback(param, event.dateTime, event.eventType, event.message);
+            numEvents++;
+        }
+    } else {
+        result = false;
+    }
+
+    file.close();
+
+    return result;
+}
+
+bool findEvents(uint32_t fromDateTime, uint32_t toDateTime, int eventType, int channelIndex, int maxEvents, void *param, void (*callback)(void *param, uint32_t dateTime, int eventType, const char *message), int *err) {
+    if (!sd_card::isMounted(err)) {
+        return false;
+    }
+
+    if (eventType < EVENT_TYPE_DEBUG || eventType > EVENT_TYPE_ERROR) {
+        eventType = EVENT_TYPE_DEBUG;
+    }
+
+    char filePath[MAX_PATH_LENGTH];
+    getLogFilePath(filePath);
+    File logFile;
+    if (!logFile.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        // nothing logged yet
+        return true;
+    }
+
+    bool result = true;
+
+    if (channelIndex != -1 && !g_rebuildingIndexFiles) {
+        result = findChannelEvents(fromDateTime, toDateTime, eventType, channelIndex, maxEvents, param, callback, logFile);
+    } else {
+        getIndexFilePath(eventType, filePath);
+        File indexFile;
+        if (indexFile.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+            uint32_t numEvents = indexFile.size() / 4;
+            uint32_t position = findIndexPosition(indexFile, logFile, eventType, numEvents, fromDateTime);
+            for (int i = 0; position < numEvents && i < maxEvents; position++) {
+                uint32_t logOffset;
+                Event event;
+                if (!readLogOffset(indexFile, position, logOffset) || !readLogEvent(logFile, logOffset, event)) {
+                    result = false;
+                    break;
+                }
+
+                if (event.dateTime >= toDateTime) {
+                    break;
+                }
+
+                // channel index is being rebuilt, channel events are recognized by the message
+                if (channelIndex != -1 && !isChannelEventMessage(event.message, channelIndex)) {
+                    continue;
+                }
+
+                callback(param, event.dateTime, event.eventType, event.message);
+                i++;
+            }
+
+            indexFile.close();
+        }
+    }
+
+    logFile.close();
+
+    if (!result && err) {
+        *err = SCPI_ERROR_MASS_STORAGE_ERROR;
+    }
+
+    return result;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+// severity indexes, followed by time index and channel indexes
+static void getIndexFilePathAt(int i, char *filePath) {
+    if (i < EVENT_TYPE_ERROR) {
+        getIndexFilePath(EVENT_TYPE_DEBUG + i, filePath);
+    } else if (i == EVENT_TYPE_ERROR) {
+        getTimeIndexFilePath(filePath);
+    } else {
+        getChannelIndexFilePath(i - EVENT_TYPE_ERROR - 1, filePath);
+    }
+}
+
+static void getRebuildFilePath(const char *filePath, char *rebuildFilePath) {
+    snprintf(rebuildFilePath, MAX_PATH_LENGTH, "%s.tmp", filePath);
+}
+
+static void deleteIndexFiles() {
+    char filePath[MAX_PATH_LENGTH];
+    for (int i = 0; i < NUM_INDEX_FILES; i++) {
+        getIndexFilePathAt(i, filePath);
+        sd_card::deleteFile(filePath, nullptr);
+    }
+}
+
+// offset after the '\n' which ends the line starting at logOffset
+static bool findNextLine(File &logFile, uint32_t logOffset, uint32_t &nextLogOffset) {
+    if (!logFile.seek(logOffset)) {
+        return false;
+    }
+
+    uint8_t buffer[64];
+    while (true) {
+        size_t n = logFile.read(buffer, sizeof(buffer));
+        if (n == 0) {
+            return false;
+        }
+
+        auto p = (const uint8_t *)memchr(buffer, '\n', n);
+        if (p) {
+            nextLogOffset = logOffset + (p - buffer) + 1;
+            return true;
+        }
+
+        logOffset += n;
+    }
+}
+
+static bool isLastLineIndexed(File &logFile) {
+    char filePath[MAX_PATH_LENGTH];
+    getIndexFilePath(EVENT_TYPE_DEBUG, filePath);
+    File indexFile;
+    if (!indexFile.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        return false;
+    }
+
+    uint32_t numEvents = indexFile.size() / 4;
+    uint32_t logOffset;
+    bool result = numEvents > 0 && readLogOffset(indexFile, numEvents - 1, logOffset);
+
+    indexFile.close();
+
+    // every event is in the debug index, so its last entry must be the last line of the log
+    Event event;
+    uint32_t nextLogOffset;
+    if (!result || !readLogEvent(logFile, logOffset, event) || !findNextLine(logFile, logOffset, nextLogOffset)) {
+        return false;
+    }
+    if (nextLogOffset != logFile.size()) {
+        return false;
+    }
+
+    // one time index entry for every TIME_INDEX_STRIDE events
+    getTimeIndexFilePath(filePath);
+    File timeIndexFile;
+    if (!timeIndexFile.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        return false;
+    }
+    uint32_t numEntries = timeIndexFile.size() / sizeof(TimeIndexEntry);
+    timeIndexFile.close();
+
+    return numEntries == (numEvents + TIME_INDEX_STRIDE - 1) / TIME_INDEX_STRIDE;
+}
+
+// IDs of all the events with a message, looked up when channel indexes are rebuilt
+static const int16_t g_eventIds[] = {
+#define EVENT_SCPI_ERROR(ID, TEXT)
+#define EVENT_ERROR(NAME, ID, TEXT) EVENT_ERROR_START_ID + ID,
+#define EVENT_WARNING(NAME, ID, TEXT) EVENT_WARNING_START_ID + ID,
+#define EVENT_INFO(NAME, ID, TEXT) EVENT_INFO_START_ID + ID,
+    LIST_OF_EVENTS
+#undef EVENT_SCPI_ERROR
+#undef EVENT_INFO
+#undef EVENT_WARNING
+#undef EVENT_ERROR
+};
+
+// Channel event ID is not in the log, but its message starts with "Ch<n>",
+// so it is found by formatting each channel event message for that channel.
+static bool findChannelEventId(const char *message, int eventType, int16_t &eventId, int16_t &channelIndex) {
+    if (tolower(message[0]) != 'c' || tolower(message[1]) != 'h' || message[2] < '1' || message[2] >= '1' + CH_MAX) {
+        return false;
+    }
+
+    for (size_t i = 0; i < sizeof(g_eventIds) / sizeof(g_eventIds[0]); i++) {
+        if (getEventType(g_eventIds[i]) != eventType) {
+            continue;
+        }
+
+        const char *format = getEventMessage(g_eventIds[i]);
+        if (!format || !strstr(format, "%d")) {
+            continue;
+        }
+
+        char buffer[128];
+        snprintf(buffer, sizeof(buffer), format, message[2] - '0');
+        if (strcmp(buffer, message) == 0) {
+            eventId = g_eventIds[i];
+            channelIndex = message[2] - '1';
+            return true;
+        }
+    }
+
+    return false;
+}
+
+static void closeRebuildIndexFiles() {
+    if (!g_rebuildingIndexFiles) {
+        return;
+    }
+
+    for (int i = 0; i < EVENT_TYPE_ERROR; i++) {
+        if (g_rebuildIndexFiles[i].isOpen()) {
+            g_rebuildIndexFiles[i].close();
+        }
+    }
+
+    if (g_rebuildTimeIndexFile.isOpen()) {
+        g_rebuildTimeIndexFile.close();
+    }
+
+    if (g_rebuildChannelIndexFile.isOpen()) {
+        g_rebuildChannelIndexFile.close();
+    }
+    g_rebuildChannelIndex = -1;
+
+    g_rebuildingIndexFiles = false;
+}
+
+static void startRebuildIndexFiles() {
+    char filePath[MAX_PATH_LENGTH];
+    char rebuildFilePath[MAX_PATH_LENGTH];
+
+    // left from the rebuild which was not finished
+    for (int i = 0; i < NUM_INDEX_FILES; i++) {
+        getIndexFilePathAt(i, filePath);
+        getRebuildFilePath(filePath, rebuildFilePath);
+        sd_card::deleteFile(rebuildFilePath, nullptr);
+    }
+
+    g_rebuildingIndexFiles = true;
+    g_rebuildLogOffset = 0;
+
+    for (int indexType = EVENT_TYPE_DEBUG; indexType <= EVENT_TYPE_ERROR; indexType++) {
+        getIndexFilePath(indexType, filePath);
+        getRebuildFilePath(filePath, rebuildFilePath);
+        if (!g_rebuildIndexFiles[indexType - 1].open(rebuildFilePath, FILE_CREATE_ALWAYS | FILE_WRITE)) {
+            closeRebuildIndexFiles();
+            return;
+        }
+        g_rebuildIndexSizes[indexType - 1] = 0;
+    }
+
+    getTimeIndexFilePath(filePath);
+    getRebuildFilePath(filePath, rebuildFilePath);
+    if (!g_rebuildTimeIndexFile.open(rebuildFilePath, FILE_CREATE_ALWAYS | FILE_WRITE)) {
+        closeRebuildIndexFiles();
+    }
+}
+
+static bool rebuildChannelIndex(Event &event, uint32_t logOffset) {
+    ChannelIndexEntry entry;
+    int16_t channelIndex;
+    if (!findChannelEventId(event.message, event.eventType, entry.eventId, channelIndex)) {
+        return true;
+    }
+
+    if (channelIndex != g_rebuildChannelIndex) {
+        if (g_rebuildChannelIndexFile.isOpen()) {
+            g_rebuildChannelIndexFile.close();
+        }
+
+        char filePath[MAX_PATH_LENGTH];
+        char rebuildFilePath[MAX_PATH_LENGTH];
+        getChannelIndexFilePath(channelIndex, filePath);
+        getRebuildFilePath(filePath, rebuildFilePath);
+        if (!g_rebuildChannelIndexFile.open(rebuildFilePath, FILE_OPEN_APPEND | FILE_WRITE)) {
+            g_rebuildChannelIndex = -1;
+            return false;
+        }
+        g_rebuildChannelIndex = channelIndex;
+    }
+
+    entry.dateTime = event.dateTime;
+    entry.logOffset = logOffset;
+    entry.reserved = 0;
+    return g_rebuildChannelIndexFile.write((const uint8_t *)&entry, sizeof(entry)) == sizeof(entry);
+}
+
+static bool rebuildIndexes(Event &event, uint32_t logOffset) {
+    // positions before this event are stored in the time index entry
+    TimeIndexEntry entry;
+    entry.dateTime = event.dateTime;
+    for (int indexType = EVENT_TYPE_DEBUG; indexType <= EVENT_TYPE_ERROR; indexType++) {
+        entry.positions[indexType - 1] = g_rebuildIndexSizes[indexType - 1];
+    }
+
+    // event is added to the indexes of its own and all the lower severities
+    for (int indexType = EVENT_TYPE_DEBUG; indexType == EVENT_TYPE_DEBUG || indexType <= event.eventType; indexType++) {
+        if (g_rebuildIndexFiles[indexType - 1].write((const uint8_t *)&logOffset, sizeof(uint32_t)) != sizeof(uint32_t)) {
+            return false;
+        }
+        g_rebuildIndexSizes[indexType - 1]++;
+    }
+
+    if (entry.positions[EVENT_TYPE_DEBUG - 1] % TIME_INDEX_STRIDE == 0) {
+        if (g_rebuildTimeIndexFile.write((const uint8_t *)&entry, sizeof(entry)) != sizeof(entry)) {
+            return false;
+        }
+    }
+
+    return rebuildChannelIndex(event, logOffset);
+}
+
+static void finishRebuildIndexFiles() {
+    closeRebuildIndexFiles();
+
+    deleteIndexFiles();
+
+    char filePath[MAX_PATH_LENGTH];
+    char rebuildFilePath[MAX_PATH_LENGTH];
+    for (int i = 0; i < NUM_INDEX_FILES; i++) {
+        getIndexFilePathAt(i, filePath);
+        getRebuildFilePath(filePath, rebuildFilePath);
+        // channel index files are not created for the channels without events
+        sd_card::moveFile(rebuildFilePath, filePath, nullptr);
+    }
+
+    g_refreshEvents = true;
+}
+
+// Indexes up to REBUILD_INDEX_LINES_PER_TICK log lines, including the lines
+// logged since the rebuild was started.
+static void rebuildIndexFilesStep() {
+    char filePath[MAX_PATH_LENGTH];
+    getLogFilePath(filePath);
+
+    File logFile;
+    if (!logFile.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        closeRebuildIndexFiles();
+        return;
+    }
+
+    uint32_t logSize = logFile.size();
+    bool finished = false;
+
+    for (int i = 0; i < REBUILD_INDEX_LINES_PER_TICK; i++) {
+        uint32_t nextLogOffset;
+        if (g_rebuildLogOffset >= logSize || !findNextLine(logFile, g_rebuildLogOffset, nextLogOffset)) {
+            // whole log is indexed, last line is skipped if not complete
+            finished = true;
+            break;
+        }
+
+        Event event;
+        if (readLogEvent(logFile, g_rebuildLogOffset, event) && !rebuildIndexes(event, g_rebuildLogOffset)) {
+            logFile.close();
+            closeRebuildIndexFiles();
+            return;
+        }
+
+        g_rebuildLogOffset = nextLogOffset;
+    }
+
+    logFile.close();
+
+    if (finished) {
+        finishRebuildIndexFiles();
+    }
+}
+
+// Index files are rebuilt from the log if they don't cover it up to the last line,
+// e.g. when the log was deleted or replaced in the USB mass storage mode.
+static void checkIndexFiles() {
+    char filePath[MAX_PATH_LENGTH];
+    getLogFilePath(filePath);
+
+    File logFile;
+    if (!logFile.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        deleteIndexFiles();
+        return;
+    }
+
+    if (logFile.size() == 0) {
+        deleteIndexFiles();
+    } else if (!isLastLineIndexed(logFile)) {
+        startRebuildIndexFiles();
+    }
+
+    logFile.close();
+}
+
 } // namespace event_queue
 } // namespace psu
 
@@ -969,13 +1693,50 @@ void data_event_queue_event_long_message_overlay(DataOperationEnum operation, Cu
     }
 }
 
+static const uint16_t EVENT_QUEUE_GO_TO_DATE = 100;
+
+static EnumItem g_eventQueueFilterMenuEnumDefinition[] = {
+    { EVENT_TYPE_DEBUG, "Debug" },
+    { EVENT_TYPE_INFO, "Info" },
+    { EVENT_TYPE_WARNING, "Warning" },
+    { EVENT_TYPE_ERROR, "Error" },
+    { EVENT_QUEUE_GO_TO_DATE, "Go to date" },
+    { 0, 0 }
+};
+
+static void onSetGoToDate(char *value) {
+    uint32_t dateTime;
+    if (!datetime::parseDateTime(value, dateTime)) {
+        errorMessage("Invalid date!");
+        return;
+    }
+
+    popPage();
+
+    // index is searched in the low priority thread
+    event_queue::g_goToDateTime = dateTime;
+    event_queue::g_goToDateTimeRequested = true;
+}
+
 void onSetEventQueueFilter(uint16_t value) {
     popPage();
+
+    if (value == EVENT_QUEUE_GO_TO_DATE) {
+        int year, month, day, hour, minute, second;
+        datetime::breakTime(datetime::now(), year, month, day, hour, minute, second);
+
+        char text[20];
+        sprintf(text, "%04d-%02d-%02d", year, month, day);
+
+        Keypad::startPush("YYYY-MM-DD [HH:MM]: ", text, 0, 19, false, onSetGoToDate, popPage);
+        return;
+    }
+
     event_queue::setFilter((int)value);
 }
 
 void action_event_queue_filter() {
-    pushSelectFromEnumPage(ENUM_DEFINITION_QUEUE_FILTER, (uint16_t)event_queue::getFilter(), NULL, onSetEventQueueFilter);
+    pushSelectFromEnumPage(g_eventQueueFilterMenuEnumDefinition, (uint16_t)event_queue::getFilter(), NULL, onSetEventQueueFilter);
 }
 
 void action_event_queue_select_event() {
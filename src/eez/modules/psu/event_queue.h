@@ -208,6 +208,7 @@ int16_t getLastErrorEventId();
 int16_t getLastErrorEventChannelIndex();
 
 const char *getEventTypeName(int16_t eventId);
+const char *getEventTypeNameFromType(int eventType);
 const char *getEventMessage(int16_t eventId);
 
 void setFilter(int filter);
@@ -222,6 +223,12 @@ void moveToTop();
 
 void onEncoder(int couter);
 
+// Finds events logged within [fromDateTime, toDateTime) (local time) of at least given severity,
+// for the given channel or all events if channelIndex is -1. Events are passed to callback
+// in chronological order, at most maxEvents of them. Only the log lines of the found events
+// are read, starting position is found using time or channel index.
+bool findEvents(uint32_t fromDateTime, uint32_t toDateTime, int eventType, int channelIndex, int maxEvents, void *param, void (*callback)(void *param, uint32_t dateTime, int eventType, const char *message), int *err);
+
 } // namespace event_queue
 } // namespace psu
 } // namespace eez
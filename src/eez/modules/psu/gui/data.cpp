@@ -4773,7 +4773,9 @@ void data_channel_history_values(DataOperationEnum operation, Cursor cursor, Val
     if (operation == DATA_OPERATION_YT_DATA_GET_GET_VALUE_FUNC) {
         value = ChannelHistory::getChannelHistoryValueFuncs(cursor);
     } else if (operation == DATA_OPERATION_YT_DATA_GET_REFRESH_COUNTER) {
-        value = Value(0, VALUE_TYPE_UINT32);
+        // redraw everything when switched to another history level
+        int iChannel = cursor >= 0 ? cursor : (g_channel ? g_channel->channelIndex : 0);
+        value = Value(Channel::get(iChannel).getHistoryViewLevel(), VALUE_TYPE_UINT32);
     } else if (operation == DATA_OPERATION_YT_DATA_GET_SIZE) {
         value = Value(CHANNEL_HISTORY_SIZE, VALUE_TYPE_UINT32);
     } else if (operation == DATA_OPERATION_YT_DATA_GET_POSITION) {
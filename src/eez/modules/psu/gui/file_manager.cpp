@@ -47,6 +47,7 @@
 #include <eez/modules/psu/gui/animations.h>
 #include <eez/modules/psu/gui/file_manager.h>
 #include <eez/modules/psu/gui/keypad.h>
+#include <eez/modules/psu/gui/thumbnail_cache.h>
 
 #include <eez/libs/sd_fat/sd_fat.h>
 
@@ -72,6 +73,7 @@ struct FileItem {
     uint32_t size;
     uint32_t dateTime;
     const char *description;
+    bool descriptionLoaded; // script descriptions are loaded only for the visible rows
 };
 
 static uint8_t *g_frontBufferPosition;
@@ -95,6 +97,245 @@ static void (*g_fileBrowserOnFileSelected)(const char *filePath);
 
 static ListViewOption g_rootDirectoryListViewOption = LIST_VIEW_LARGE_ICONS;
 static ListViewOption g_scriptsDirectoryListViewOption = LIST_VIEW_SCRIPTS;
+static ListViewOption g_screenshotsDirectoryListViewOption = LIST_VIEW_LARGE_ICONS;
+
+static volatile bool g_loadDescriptionsRequested;
+
+////////////////////////////////////////////////////////////////////////////////
+// Catalog cache
+//
+// Catalog is loaded into FILE_MANAGER_MEMORY: FileItem's from the start, strings from the end.
+// When another directory is loaded, current catalog is copied into CATALOG_CACHE_MEMORY
+// and, on the next visit, copied back to the same addresses, so pointers inside
+// FileItem's remain valid.
+//
+// FAT doesn't update directory modification time when its content changes,
+// so catalog is invalidated by the firmware's own file writes (see onSdCardFileChangeHook)
+// and everything is dropped when SD card is mounted or unmounted, which includes
+// switching to the USB mass storage mode.
+
+static const int MAX_CACHED_CATALOGS = 16;
+
+struct CatalogKey {
+    uint32_t pathHash;
+    ListViewOption listViewOption;
+    bool fileBrowserMode;
+    FileType fileBrowserFileType;
+};
+
+struct CachedCatalog {
+    CatalogKey key;
+    volatile bool valid;
+    bool used;
+    uint32_t lastUsed;
+    uint32_t offset; // directory path, FileItem's and strings, all stored at this offset in CATALOG_CACHE_MEMORY
+    uint32_t pathSize;
+    uint32_t itemsSize;
+    uint32_t stringsSize;
+};
+
+static CachedCatalog g_cachedCatalogs[MAX_CACHED_CATALOGS];
+static uint32_t g_catalogCacheUsedSize;
+static uint32_t g_catalogCacheLastUsed;
+
+// catalog currently loaded in FILE_MANAGER_MEMORY
+static char g_loadedDirectory[MAX_PATH_LENGTH + 1];
+static CatalogKey g_loadedCatalogKey;
+static volatile bool g_loadedCatalogValid;
+
+static uint32_t getPathHash(const char *path) {
+    return crc32((const uint8_t *)path, strlen(path));
+}
+
+static void getCatalogKey(const char *dirPath, CatalogKey &key) {
+    key.pathHash = getPathHash(dirPath);
+    key.listViewOption = getListViewOption();
+    key.fileBrowserMode = g_fileBrowserMode;
+    key.fileBrowserFileType = g_fileBrowserMode ? g_fileBrowserFileType : FILE_TYPE_NONE;
+}
+
+static bool isSameCatalogKey(const CatalogKey &key1, const CatalogKey &key2) {
+    return key1.pathHash == key2.pathHash &&
+        key1.listViewOption == key2.listViewOption &&
+        key1.fileBrowserMode == key2.fileBrowserMode &&
+        key1.fileBrowserFileType == key2.fileBrowserFileType;
+}
+
+static uint32_t getCachedCatalogSize(CachedCatalog &cachedCatalog) {
+    return cachedCatalog.pathSize + cachedCatalog.itemsSize + cachedCatalog.stringsSize;
+}
+
+static CachedCatalog *findCachedCatalog(const char *dirPath, const CatalogKey &key) {
+    for (int i = 0; i < MAX_CACHED_CATALOGS; i++) {
+        auto &cachedCatalog = g_cachedCatalogs[i];
+        if (
+            cachedCatalog.used && cachedCatalog.valid &&
+            isSameCatalogKey(cachedCatalog.key, key) &&
+            strcmp((const char *)CATALOG_CACHE_MEMORY + cachedCatalog.offset, dirPath) == 0
+        ) {
+            return &cachedCatalog;
+        }
+    }
+    return nullptr;
+}
+
+static void removeCachedCatalog(CachedCatalog &removedCatalog) {
+    uint32_t offset = removedCatalog.offset;
+    uint32_t size = getCachedCatalogSize(removedCatalog);
+
+    memmove(CATALOG_CACHE_MEMORY + offset, CATALOG_CACHE_MEMORY + offset + size, g_catalogCacheUsedSize - offset - size);
+    g_catalogCacheUsedSize -= size;
+
+    for (int i = 0; i < MAX_CACHED_CATALOGS; i++) {
+        auto &cachedCatalog = g_cachedCatalogs[i];
+        if (cachedCatalog.used && cachedCatalog.offset > offset) {
+            cachedCatalog.offset -= size;
+        }
+    }
+
+    removedCatalog.used = false;
+}
+
+static CachedCatalog *allocCachedCatalog(uint32_t size) {
+    if (size > CATALOG_CACHE_MEMORY_SIZE) {
+        return nullptr;
+    }
+
+    for (int i = 0; i < MAX_CACHED_CATALOGS; i++) {
+        auto &cachedCatalog = g_cachedCatalogs[i];
+        if (cachedCatalog.used && !cachedCatalog.valid) {
+            removeCachedCatalog(cachedCatalog);
+        }
+    }
+
+    while (true) {
+        CachedCatalog *freeCatalog = nullptr;
+        CachedCatalog *leastRecentlyUsedCatalog = nullptr;
+
+        for (int i = 0; i < MAX_CACHED_CATALOGS; i++) {
+            auto &cachedCatalog = g_cachedCatalogs[i];
+            if (!cachedCatalog.used) {
+                if (!freeCatalog) {
+                    freeCatalog = &cachedCatalog;
+                }
+            } else if (!leastRecentlyUsedCatalog || cachedCatalog.lastUsed < leastRecentlyUsedCatalog->lastUsed) {
+                leastRecentlyUsedCatalog = &cachedCatalog;
+            }
+        }
+
+        if (freeCatalog && g_catalogCacheUsedSize + size <= CATALOG_CACHE_MEMORY_SIZE) {
+            freeCatalog->offset = g_catalogCacheUsedSize;
+            g_catalogCacheUsedSize += size;
+            return freeCatalog;
+        }
+
+        removeCachedCatalog(*leastRecentlyUsedCatalog);
+    }
+}
+
+static void saveLoadedCatalog() {
+    if (!g_loadedCatalogValid) {
+        return;
+    }
+
+    auto cachedCatalog = findCachedCatalog(g_loadedDirectory, g_loadedCatalogKey);
+    if (cachedCatalog) {
+        removeCachedCatalog(*cachedCatalog);
+    }
+
+    uint32_t pathSize = 4 * ((strlen(g_loadedDirectory) + 1 + 3) / 4);
+    uint32_t itemsSize = g_frontBufferPosition - FILE_MANAGER_MEMORY;
+    uint32_t stringsSize = FILE_MANAGER_MEMORY + FILE_MANAGER_MEMORY_SIZE - g_backBufferPosition;
+
+    cachedCatalog = allocCachedCatalog(pathSize + itemsSize + stringsSize);
+    if (!cachedCatalog) {
+        return;
+    }
+
+    cachedCatalog->key = g_loadedCatalogKey;
+    cachedCatalog->pathSize = pathSize;
+    cachedCatalog->itemsSize = itemsSize;
+    cachedCatalog->stringsSize = stringsSize;
+    cachedCatalog->lastUsed = ++g_catalogCacheLastUsed;
+
+    uint8_t *p = CATALOG_CACHE_MEMORY + cachedCatalog->offset;
+    strcpy((char *)p, g_loadedDirectory);
+    p += pathSize;
+    memcpy(p, FILE_MANAGER_MEMORY, itemsSize);
+    p += itemsSize;
+    memcpy(p, g_backBufferPosition, stringsSize);
+
+    cachedCatalog->used = true;
+    // directory could be changed (by some other thread) while catalog was copied
+    cachedCatalog->valid = g_loadedCatalogValid;
+}
+
+static bool restoreCachedCatalog(CachedCatalog &cachedCatalog) {
+    uint8_t *p = CATALOG_CACHE_MEMORY + cachedCatalog.offset + cachedCatalog.pathSize;
+
+    g_frontBufferPosition = FILE_MANAGER_MEMORY + cachedCatalog.itemsSize;
+    g_backBufferPosition = FILE_MANAGER_MEMORY + FILE_MANAGER_MEMORY_SIZE - cachedCatalog.stringsSize;
+
+    memcpy(FILE_MANAGER_MEMORY, p, cachedCatalog.itemsSize);
+    p += cachedCatalog.itemsSize;
+    memcpy(g_backBufferPosition, p, cachedCatalog.stringsSize);
+
+    g_filesCount = cachedCatalog.itemsSize / sizeof(FileItem);
+
+    cachedCatalog.lastUsed = ++g_catalogCacheLastUsed;
+
+    return cachedCatalog.valid;
+}
+
+static void invalidateCatalogs(const char *dirPath) {
+    uint32_t pathHash = getPathHash(dirPath);
+
+    for (int i = 0; i < MAX_CACHED_CATALOGS; i++) {
+        auto &cachedCatalog = g_cachedCatalogs[i];
+        if (cachedCatalog.key.pathHash == pathHash) {
+            cachedCatalog.valid = false;
+        }
+    }
+
+    if (g_loadedCatalogKey.pathHash == pathHash) {
+        g_loadedCatalogValid = false;
+    }
+}
+
+bool isDirectoryCataloged(const char *dirPath) {
+    if (g_loadedCatalogValid && strcmp(g_loadedDirectory, dirPath) == 0) {
+        return true;
+    }
+
+    uint32_t pathHash = getPathHash(dirPath);
+
+    for (int i = 0; i < MAX_CACHED_CATALOGS; i++) {
+        auto &cachedCatalog = g_cachedCatalogs[i];
+        if (cachedCatalog.used && cachedCatalog.valid && cachedCatalog.key.pathHash == pathHash) {
+            return true;
+        }
+    }
+
+    return false;
+}
+
+void invalidateCatalog(const char *filePath) {
+    char parentDirPath[MAX_PATH_LENGTH + 1];
+    getParentDir(filePath, parentDirPath);
+    invalidateCatalogs(parentDirPath);
+
+    // in case filePath is a directory
+    invalidateCatalogs(filePath);
+}
+
+static void clearCatalogCache() {
+    for (int i = 0; i < MAX_CACHED_CATALOGS; i++) {
+        g_cachedCatalogs[i].valid = false;
+    }
+    g_loadedCatalogValid = false;
+}
+
+////////////////////////////////////////////////////////////////////////////////
 
 void catalogCallback(void *param, const char *name, FileType type, size_t size, bool isHiddenOrSystemFile) {
     if (isHiddenOrSystemFile || name[0] == '.' || (g_fileBrowserMode && type != FILE_TYPE_DIRECTORY && type != g_fileBrowserFileType)) {
@@ -105,39 +346,15 @@ void catalogCallback(void *param, const char *name, FileType type, size_t size,
  
     char fileNameWithoutExtension[MAX_PATH_LENGTH + 1];
 
-    char description[MAX_FILE_DESCRIPTION_LENGTH + 1];
-    size_t descriptionLen = 0;
+    bool descriptionLoaded = true;
 
     if (isScriptsDirectory() && (getListViewOption() == LIST_VIEW_SCRIPTS || getListViewOption() == LIST_VIEW_LARGE_ICONS)) {
         if (type != FILE_TYPE_MICROPYTHON) {
             return;
         }
 
-        description[0] = 0;
-
         if (getListViewOption() == LIST_VIEW_SCRIPTS) {
-            char filePath[MAX_PATH_LENGTH + 1];
-            strcpy(filePath, g_currentDirectory);
-            strcat(filePath, "/");
-            strcat(filePath, name);
-            File file;
-            if (file.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
-                psu::sd_card::BufferedFileRead bufferedFile(file);
-
-                psu::sd_card::matchZeroOrMoreSpaces(bufferedFile);
-                if (psu::sd_card::match(bufferedFile, '#')) {
-                    psu::sd_card::matchZeroOrMoreSpaces(bufferedFile);
-                    psu::sd_card::matchUntil(bufferedFile, '\n', description, MAX_FILE_DESCRIPTION_LENGTH);
-                    description[MAX_FILE_DESCRIPTION_LENGTH] = 0;
-                }
-
-                file.close();
-            }
-        }
-
-        descriptionLen = strlen(description);
-        if (descriptionLen > 0) {
-            descriptionLen = 4 * ((descriptionLen + 1 + 3) / 4);
+            descriptionLoaded = false;
         }
 
         const char *str = strrchr(name, '.');
@@ -151,7 +368,7 @@ void catalogCallback(void *param, const char *name, FileType type, size_t size,
 
     size_t nameLen = 4 * ((strlen(name) + 1 + 3) / 4);
 
-    if (g_frontBufferPosition + sizeof(FileItem) > g_backBufferPosition - nameLen - descriptionLen) {
+    if (g_frontBufferPosition + sizeof(FileItem) > g_backBufferPosition - nameLen) {
         return;
     }
 
@@ -164,13 +381,8 @@ void catalogCallback(void *param, const char *name, FileType type, size_t size,
     strcpy((char *)g_backBufferPosition, name);
     fileItem->name = (const char *)g_backBufferPosition;
 
-    if (descriptionLen > 0) {
-        g_backBufferPosition -= descriptionLen;
-        strcpy((char *)g_backBufferPosition, description);
-        fileItem->description = (const char *)g_backBufferPosition;
-    } else {
-        fileItem->description = nullptr;
-    }
+    fileItem->description = nullptr;
+    fileItem->descriptionLoaded = descriptionLoaded;
 
     fileItem->size = size;
 
@@ -315,22 +527,97 @@ void doLoadDirectory() {
         return;
     }
 
-    g_frontBufferPosition = FILE_MANAGER_MEMORY;
-    g_backBufferPosition = FILE_MANAGER_MEMORY + FILE_MANAGER_MEMORY_SIZE;
+    saveLoadedCatalog();
 
-    int numFiles;
-    int err;
-    if (psu::sd_card::catalog(g_currentDirectory, 0, catalogCallback, &numFiles, &err)) {
-        sort();
-        setFilesStartPosition(g_savedFilesStartPosition);
-        g_state = STATE_READY;
-    } else {
-    	g_state = STATE_NOT_PRESENT;
+    CatalogKey key;
+    getCatalogKey(g_currentDirectory, key);
+
+    g_loadedCatalogValid = false;
+    strcpy(g_loadedDirectory, g_currentDirectory);
+    g_loadedCatalogKey = key;
+    g_loadedCatalogValid = true;
+
+    auto cachedCatalog = findCachedCatalog(g_currentDirectory, key);
+    if (!cachedCatalog || !restoreCachedCatalog(*cachedCatalog)) {
+        g_frontBufferPosition = FILE_MANAGER_MEMORY;
+        g_backBufferPosition = FILE_MANAGER_MEMORY + FILE_MANAGER_MEMORY_SIZE;
+        g_filesCount = 0;
+
+        int numFiles;
+        int err;
+        if (!psu::sd_card::catalog(g_currentDirectory, 0, catalogCallback, &numFiles, &err)) {
+            g_loadedCatalogValid = false;
+            g_state = STATE_NOT_PRESENT;
+            return;
+        }
+    }
+
+    sort();
+    setFilesStartPosition(g_savedFilesStartPosition);
+    g_state = STATE_READY;
+}
+
+static void loadDescription(FileItem *fileItem) {
+    char description[MAX_FILE_DESCRIPTION_LENGTH + 1];
+    description[0] = 0;
+
+    // name is without ".py" extension
+    if (strlen(g_loadedDirectory) + 1 + strlen(fileItem->name) + 3 <= MAX_PATH_LENGTH) {
+        char filePath[MAX_PATH_LENGTH + 1];
+        strcpy(filePath, g_loadedDirectory);
+        strcat(filePath, "/");
+        strcat(filePath, fileItem->name);
+        strcat(filePath, ".py");
+
+        File file;
+        if (file.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+            psu::sd_card::BufferedFileRead bufferedFile(file);
+
+            psu::sd_card::matchZeroOrMoreSpaces(bufferedFile);
+            if (psu::sd_card::match(bufferedFile, '#')) {
+                psu::sd_card::matchZeroOrMoreSpaces(bufferedFile);
+                psu::sd_card::matchUntil(bufferedFile, '\n', description, MAX_FILE_DESCRIPTION_LENGTH);
+                description[MAX_FILE_DESCRIPTION_LENGTH] = 0;
+            }
+
+            file.close();
+        }
+    }
+
+    size_t descriptionLen = strlen(description);
+    if (descriptionLen > 0) {
+        descriptionLen = 4 * ((descriptionLen + 1 + 3) / 4);
+        if (g_frontBufferPosition <= g_backBufferPosition - descriptionLen) {
+            g_backBufferPosition -= descriptionLen;
+            strcpy((char *)g_backBufferPosition, description);
+            fileItem->description = (const char *)g_backBufferPosition;
+        }
     }
 
+    fileItem->descriptionLoaded = true;
+}
+
+void doLoadDescriptions() {
+    g_loadDescriptionsRequested = false;
+
+    uint32_t endPosition = g_filesStartPosition + getFilesPageSize();
+    for (uint32_t fileIndex = g_filesStartPosition; fileIndex < endPosition; fileIndex++) {
+        // stop if directory is changed in the meantime
+        if (g_state != STATE_READY || fileIndex >= g_filesCount) {
+            return;
+        }
+
+        auto fileItem = (FileItem *)(FILE_MANAGER_MEMORY + fileIndex * sizeof(FileItem));
+        if (!fileItem->descriptionLoaded) {
+            loadDescription(fileItem);
+        }
+    }
 }
 
 void onSdCardMountedChange() {
+    clearCatalogCache();
+    thumbnail_cache::clear();
+
 	if (psu::sd_card::isMounted(nullptr)) {
 		g_state = STATE_STARTING;
 	} else {
@@ -339,7 +626,7 @@ void onSdCardMountedChange() {
 }
 
 bool isListViewOptionAvailable() {
-    return isRootDirectory() || isScriptsDirectory();
+    return isRootDirectory() || isScriptsDirectory() || isScreenshotsDirectory();
 }
 
 ListViewOption getListViewOption() {
@@ -352,6 +639,9 @@ ListViewOption getListViewOption() {
     if (isScriptsDirectory()) {
         return g_scriptsDirectoryListViewOption;
     }
+    if (isScreenshotsDirectory()) {
+        return g_screenshotsDirectoryListViewOption;
+    }
     return LIST_VIEW_DETAILS;
 }
 
@@ -372,6 +662,12 @@ void toggleListViewOption() {
         } else {
             g_rootDirectoryListViewOption = LIST_VIEW_DETAILS;
         }
+    } else if (isScreenshotsDirectory()) {
+        if (g_screenshotsDirectoryListViewOption == LIST_VIEW_DETAILS) {
+            g_screenshotsDirectoryListViewOption = LIST_VIEW_LARGE_ICONS;
+        } else {
+            g_screenshotsDirectoryListViewOption = LIST_VIEW_DETAILS;
+        }
     } else {
         // if (g_scriptsDirectoryListViewOption == LIST_VIEW_DETAILS) {
         //     g_scriptsDirectoryListViewOption = LIST_VIEW_SCRIPTS;
@@ -398,13 +694,10 @@ SortFilesOption getSortFilesOption() {
 void setSortFilesOption(SortFilesOption sortFilesOption) {
     psu::persist_conf::setSortFilesOption(sortFilesOption);
 
-    sort();
-
+    // Descriptions are written into the loaded catalog by the low priority thread,
+    // so catalog is sorted there, after it is restored from the cache.
     g_filesStartPosition = 0;
-
-    if (!g_fileBrowserMode) {
-        g_selectedFileIndex = -1;
-    }
+    loadDirectory();
 }
 
 const char *getCurrentDirectory() {
@@ -447,6 +740,10 @@ bool isScriptsDirectory() {
     return strcmp(g_currentDirectory, SCRIPTS_DIR) == 0;
 }
 
+bool isScreenshotsDirectory() {
+    return strcmp(g_currentDirectory, SCREENSHOTS_DIR) == 0;
+}
+
 void goToParentDirectory() {
     if (g_state != STATE_READY) {
         return;
@@ -571,6 +868,33 @@ const char *getFileIcon(uint32_t fileIndex) {
 
     return getFileTypeLargeIcon(fileType);
 }
+Image *getFileThumbnail(uint32_t fileIndex, uint16_t &version) {
+    if (getListViewOption() != LIST_VIEW_LARGE_ICONS) {
+        return nullptr;
+    }
+
+    auto fileItem = getFileItem(fileIndex);
+    if (!fileItem || fileItem->type != FILE_TYPE_IMAGE) {
+        return nullptr;
+    }
+
+    // thumbnails are loaded only for the visible window
+    if (fileIndex < g_filesStartPosition || fileIndex >= g_filesStartPosition + getFilesPageSize()) {
+        return nullptr;
+    }
+
+    if (strlen(g_currentDirectory) + 1 + strlen(fileItem->name) > MAX_PATH_LENGTH) {
+        return nullptr;
+    }
+
+    char filePath[MAX_PATH_LENGTH + 1];
+    strcpy(filePath, g_currentDirectory);
+    strcat(filePath, "/");
+    strcat(filePath, fileItem->name);
+
+    return thumbnail_cache::getThumbnail(filePath, fileItem->size, fileItem->dateTime, version);
+}
+
 const char *getFileName(uint32_t fileIndex) {
     auto fileItem = getFileItem(fileIndex);
     return fileItem ? fileItem->name : "";
@@ -588,7 +912,24 @@ const uint32_t getFileDataTime(uint32_t fileIndex) {
 
 const char *getFileDescription(uint32_t fileIndex) {
     auto fileItem = getFileItem(fileIndex);
-    return fileItem && fileItem->description ? fileItem->description : "";
+    if (!fileItem) {
+        return "";
+    }
+
+    if (!fileItem->descriptionLoaded) {
+        // request loading only for the rows in the visible window
+        if (
+            !g_loadDescriptionsRequested &&
+            fileIndex >= g_filesStartPosition && fileIndex < g_filesStartPosition + getFilesPageSize()
+        ) {
+            g_loadDescriptionsRequested = true;
+            using namespace scpi;
+            sendMessageToLowPriorityThread(THREAD_MESSAGE_FILE_MANAGER_LOAD_DESCRIPTIONS);
+        }
+        return "";
+    }
+
+    return fileItem->description ? fileItem->description : "";
 }
 
 bool isFileSelected(uint32_t fileIndex) {
@@ -908,6 +1249,11 @@ void deleteFile() {
     int err;
     if (!psu::sd_card::deleteFile(filePath, &err)) {
         errorMessage(Value(err, VALUE_TYPE_SCPI_ERROR));
+        return;
+    }
+
+    if (fileItem->type == FILE_TYPE_IMAGE) {
+        thumbnail_cache::deleteThumbnailFile(filePath);
     }
 }
 
@@ -1085,7 +1431,13 @@ void data_file_manager_file_type(DataOperationEnum operation, Cursor cursor, Val
 
 void data_file_manager_file_icon(DataOperationEnum operation, Cursor cursor, Value &value) {
     if (operation == DATA_OPERATION_GET) {
-        value = getFileIcon(cursor);
+        uint16_t version;
+        auto thumbnail = getFileThumbnail(cursor, version);
+        if (thumbnail) {
+            value = Value(thumbnail, VALUE_TYPE_IMAGE, version);
+        } else {
+            value = getFileIcon(cursor);
+        }
     }
 }
 
@@ -1293,7 +1645,24 @@ void action_file_manager_new_file() {
 
 using namespace gui::file_manager;
 
+// names starting with '.' are not shown (see catalogCallback)
+static bool isHiddenFilePath(const char *filePath) {
+    return filePath[0] == '.' || strstr(filePath, "/.") != nullptr;
+}
+
 void onSdCardFileChangeHook(const char *filePath1, const char *filePath2) {
+    if (isHiddenFilePath(filePath1)) {
+        if (filePath2) {
+            onSdCardFileChangeHook(filePath2);
+        }
+        return;
+    }
+
+    invalidateCatalog(filePath1);
+    if (filePath2) {
+        invalidateCatalog(filePath2);
+    }
+
     if (!isPageOnStack(PAGE_ID_FILE_MANAGER) && !isPageOnStack(PAGE_ID_FILE_BROWSER)) {
         return;
     }
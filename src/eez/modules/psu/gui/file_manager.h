@@ -45,6 +45,7 @@ const char *getCurrentDirectory();
 State getState();
 bool isRootDirectory();
 bool isScriptsDirectory();
+bool isScreenshotsDirectory();
 void goToParentDirectory();
 uint32_t getFilesCount();
 uint32_t getFilesStartPosition();
@@ -55,6 +56,7 @@ bool isDirectory(uint32_t fileIndex);
 FileType getFileType(uint32_t fileIndex);
 RootDirectoryType getRootDirectoryType(uint32_t fileIndex);
 const char *getFileIcon(uint32_t fileIndex);
+Image *getFileThumbnail(uint32_t fileIndex, uint16_t &version);
 const char *getFileName(uint32_t fileIndex);
 const uint32_t getFileSize(uint32_t fileIndex);
 const uint32_t getFileDataTime(uint32_t fileIndex);
@@ -98,6 +100,11 @@ bool isSaveDialog();
 void newFile();
 
 void doLoadDirectory();
+void doLoadDescriptions();
+// Marks cached catalog of the file's directory as stale, without reloading the file manager.
+void invalidateCatalog(const char *filePath);
+// Returns false if directory is neither loaded nor cached, i.e. there is nothing to invalidate.
+bool isDirectoryCataloged(const char *dirPath);
 void doRenameFile();
 void onSdCardMountedChange();
 
@@ -0,0 +1,319 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <eez/modules/psu/psu.h>
+
+#include <string.h>
+
+#include <eez/memory.h>
+#include <eez/mp.h>
+#include <eez/tasks.h>
+#include <eez/util.h>
+
+#include <eez/libs/sd_fat/sd_fat.h>
+#include <eez/libs/image/image.h>
+
+#include <eez/modules/psu/sd_card.h>
+#include <eez/modules/psu/gui/thumbnail_cache.h>
+
+namespace eez {
+namespace gui {
+namespace thumbnail_cache {
+
+// names starting with '.' are not shown in the file manager
+#define THUMBNAILS_DIR_NAME ".thumbs"
+#define THUMBNAIL_FILE_EXTENSION ".thb"
+
+static const uint32_t THUMBNAIL_FILE_MAGIC = 0x42485445; // "ETHB"
+static const uint16_t THUMBNAIL_FILE_VERSION = 1;
+
+struct ThumbnailFileHeader {
+    uint32_t magic;
+    uint16_t version;
+    uint16_t reserved;
+    uint16_t width;
+    uint16_t height;
+    // thumbnail is valid only if image file is not changed
+    uint32_t imageFileSize;
+    uint32_t imageFileDateTime;
+};
+
+static const int NUM_THUMBNAILS = 16;
+
+static const uint32_t FILE_PATH_SIZE = 4 * ((MAX_PATH_LENGTH + 1 + 3) / 4);
+static const uint32_t PIXELS_SIZE = MAX_THUMBNAIL_WIDTH * MAX_THUMBNAIL_HEIGHT * 2;
+static const uint32_t SLOT_SIZE = FILE_PATH_SIZE + PIXELS_SIZE;
+
+static_assert(NUM_THUMBNAILS * SLOT_SIZE <= THUMBNAIL_CACHE_MEMORY_SIZE, "THUMBNAIL_CACHE_MEMORY_SIZE too small");
+
+enum ThumbnailState {
+    THUMBNAIL_STATE_EMPTY,
+    THUMBNAIL_STATE_REQUESTED,
+    THUMBNAIL_STATE_READY,
+    THUMBNAIL_STATE_FAILED
+};
+
+struct Thumbnail {
+    volatile ThumbnailState state;
+    uint32_t filePathHash;
+    uint32_t imageFileSize;
+    uint32_t imageFileDateTime;
+    uint32_t lastUsed;
+    uint16_t version;
+    Image image;
+};
+
+static Thumbnail g_thumbnails[NUM_THUMBNAILS];
+static uint32_t g_lastUsed;
+static uint16_t g_version;
+static volatile bool g_loadRequested;
+
+static char *getFilePath(int thumbnailIndex) {
+    return (char *)(THUMBNAIL_CACHE_MEMORY + thumbnailIndex * SLOT_SIZE);
+}
+
+static uint8_t *getPixels(int thumbnailIndex) {
+    return THUMBNAIL_CACHE_MEMORY + thumbnailIndex * SLOT_SIZE + FILE_PATH_SIZE;
+}
+
+static uint32_t getFilePathHash(const char *filePath) {
+    return crc32((const uint8_t *)filePath, strlen(filePath));
+}
+
+// for "/Screenshots/image.jpg" it is "/Screenshots/.thumbs/image.jpg.thb"
+static bool getThumbnailFilePath(const char *filePath, char *thumbnailFilePath) {
+    const char *fileName = strrchr(filePath, '/');
+    if (!fileName) {
+        return false;
+    }
+    fileName++;
+
+    size_t dirPathLength = fileName - filePath;
+    if (dirPathLength + sizeof(THUMBNAILS_DIR_NAME "/") - 1 + strlen(fileName) + sizeof(THUMBNAIL_FILE_EXTENSION) - 1 > MAX_PATH_LENGTH) {
+        return false;
+    }
+
+    strncpy(thumbnailFilePath, filePath, dirPathLength);
+    thumbnailFilePath[dirPathLength] = 0;
+    strcat(thumbnailFilePath, THUMBNAILS_DIR_NAME "/");
+    strcat(thumbnailFilePath, fileName);
+    strcat(thumbnailFilePath, THUMBNAIL_FILE_EXTENSION);
+
+    return true;
+}
+
+static bool readThumbnailFile(const char *thumbnailFilePath, Thumbnail &thumbnail, uint8_t *pixels) {
+    File file;
+    if (!file.open(thumbnailFilePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        return false;
+    }
+
+    ThumbnailFileHeader header;
+    bool result = file.read(&header, sizeof(header)) == sizeof(header) &&
+        header.magic == THUMBNAIL_FILE_MAGIC &&
+        header.version == THUMBNAIL_FILE_VERSION &&
+        header.width <= MAX_THUMBNAIL_WIDTH &&
+        header.height <= MAX_THUMBNAIL_HEIGHT &&
+        header.imageFileSize == thumbnail.imageFileSize &&
+        header.imageFileDateTime == thumbnail.imageFileDateTime;
+
+    if (result) {
+        uint32_t pixelsSize = header.width * header.height * 2;
+        result = file.read(pixels, pixelsSize) == pixelsSize;
+    }
+
+    file.close();
+
+    if (result) {
+        thumbnail.image.width = header.width;
+        thumbnail.image.height = header.height;
+    }
+
+    return result;
+}
+
+static void writeThumbnailFile(const char *thumbnailFilePath, Thumbnail &thumbnail) {
+    if (!psu::sd_card::makeParentDir(thumbnailFilePath, nullptr)) {
+        return;
+    }
+
+    File file;
+    if (!file.open(thumbnailFilePath, FILE_CREATE_ALWAYS | FILE_WRITE)) {
+        return;
+    }
+
+    ThumbnailFileHeader header;
+    header.magic = THUMBNAIL_FILE_MAGIC;
+    header.version = THUMBNAIL_FILE_VERSION;
+    header.reserved = 0;
+    header.width = (uint16_t)thumbnail.image.width;
+    header.height = (uint16_t)thumbnail.image.height;
+    header.imageFileSize = thumbnail.imageFileSize;
+    header.imageFileDateTime = thumbnail.imageFileDateTime;
+
+    uint32_t pixelsSize = thumbnail.image.width * thumbnail.image.height * 2;
+
+    bool result = file.write((const uint8_t *)&header, sizeof(header)) == sizeof(header) &&
+        file.write(thumbnail.image.pixels, pixelsSize) == pixelsSize;
+
+    file.close();
+
+    if (!result) {
+        // don't leave partially written file
+        psu::sd_card::deleteFile(thumbnailFilePath, nullptr);
+    }
+}
+
+static bool decodeThumbnail(const char *filePath, Thumbnail &thumbnail, uint8_t *pixels) {
+    // FILE_VIEW_BUFFER, where image is decoded, is also used for the external assets of the running script
+    if (!mp::isIdle()) {
+        return false;
+    }
+
+    Image image;
+    if (!imageDecode(filePath, &image)) {
+        return false;
+    }
+
+    // use the smallest scale down for which thumbnail fits
+    int scale = 1;
+    while (scale < 8 && (image.width / scale > MAX_THUMBNAIL_WIDTH || image.height / scale > MAX_THUMBNAIL_HEIGHT)) {
+        scale *= 2;
+    }
+
+    imageScaleDown(&image, scale);
+
+    if (image.width == 0 || image.height == 0 || image.width > MAX_THUMBNAIL_WIDTH || image.height > MAX_THUMBNAIL_HEIGHT) {
+        return false;
+    }
+
+    memcpy(pixels, image.pixels, image.width * image.height * 2);
+
+    thumbnail.image.width = image.width;
+    thumbnail.image.height = image.height;
+
+    return true;
+}
+
+static bool loadThumbnail(int thumbnailIndex) {
+    auto &thumbnail = g_thumbnails[thumbnailIndex];
+    const char *filePath = getFilePath(thumbnailIndex);
+    uint8_t *pixels = getPixels(thumbnailIndex);
+
+    char thumbnailFilePath[MAX_PATH_LENGTH + 1];
+    bool hasThumbnailFilePath = getThumbnailFilePath(filePath, thumbnailFilePath);
+
+    bool fromFile = hasThumbnailFilePath && readThumbnailFile(thumbnailFilePath, thumbnail, pixels);
+    if (!fromFile && !decodeThumbnail(filePath, thumbnail, pixels)) {
+        return false;
+    }
+
+    thumbnail.image.bpp = 16;
+    thumbnail.image.lineOffset = 0;
+    thumbnail.image.pixels = pixels;
+    thumbnail.version = ++g_version;
+
+    if (!fromFile && hasThumbnailFilePath) {
+        writeThumbnailFile(thumbnailFilePath, thumbnail);
+    }
+
+    return true;
+}
+
+Image *getThumbnail(const char *filePath, uint32_t imageFileSize, uint32_t imageFileDateTime, uint16_t &version) {
+    uint32_t filePathHash = getFilePathHash(filePath);
+
+    int freeThumbnailIndex = -1;
+
+    for (int i = 0; i < NUM_THUMBNAILS; i++) {
+        auto &thumbnail = g_thumbnails[i];
+
+        if (
+            thumbnail.state != THUMBNAIL_STATE_EMPTY &&
+            thumbnail.filePathHash == filePathHash &&
+            thumbnail.imageFileSize == imageFileSize &&
+            thumbnail.imageFileDateTime == imageFileDateTime &&
+            strcmp(getFilePath(i), filePath) == 0
+        ) {
+            thumbnail.lastUsed = ++g_lastUsed;
+            if (thumbnail.state == THUMBNAIL_STATE_READY) {
+                version = thumbnail.version;
+                return &thumbnail.image;
+            }
+            return nullptr;
+        }
+
+        // thumbnail which is being loaded is never reused
+        if (thumbnail.state != THUMBNAIL_STATE_REQUESTED) {
+            if (freeThumbnailIndex == -1 || thumbnail.lastUsed < g_thumbnails[freeThumbnailIndex].lastUsed) {
+                freeThumbnailIndex = i;
+            }
+        }
+    }
+
+    if (freeThumbnailIndex == -1) {
+        return nullptr;
+    }
+
+    auto &thumbnail = g_thumbnails[freeThumbnailIndex];
+    strcpy(getFilePath(freeThumbnailIndex), filePath);
+    thumbnail.filePathHash = filePathHash;
+    thumbnail.imageFileSize = imageFileSize;
+    thumbnail.imageFileDateTime = imageFileDateTime;
+    thumbnail.lastUsed = ++g_lastUsed;
+    thumbnail.state = THUMBNAIL_STATE_REQUESTED;
+
+    if (!g_loadRequested) {
+        g_loadRequested = true;
+        sendMessageToLowPriorityThread(THREAD_MESSAGE_FILE_MANAGER_LOAD_THUMBNAILS);
+    }
+
+    return nullptr;
+}
+
+void doLoadThumbnails() {
+    g_loadRequested = false;
+
+    for (int i = 0; i < NUM_THUMBNAILS; i++) {
+        auto &thumbnail = g_thumbnails[i];
+        if (thumbnail.state == THUMBNAIL_STATE_REQUESTED) {
+            thumbnail.state = loadThumbnail(i) ? THUMBNAIL_STATE_READY : THUMBNAIL_STATE_FAILED;
+        }
+    }
+}
+
+void deleteThumbnailFile(const char *filePath) {
+    char thumbnailFilePath[MAX_PATH_LENGTH + 1];
+    if (getThumbnailFilePath(filePath, thumbnailFilePath) && psu::sd_card::exists(thumbnailFilePath, nullptr)) {
+        psu::sd_card::deleteFile(thumbnailFilePath, nullptr);
+    }
+}
+
+void clear() {
+    for (int i = 0; i < NUM_THUMBNAILS; i++) {
+        auto &thumbnail = g_thumbnails[i];
+        if (thumbnail.state != THUMBNAIL_STATE_REQUESTED) {
+            thumbnail.state = THUMBNAIL_STATE_EMPTY;
+            thumbnail.lastUsed = 0;
+        }
+    }
+}
+
+} // namespace thumbnail_cache
+} // namespace gui
+} // namespace eez
@@ -0,0 +1,49 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#pragma once
+
+#include <stdint.h>
+
+#include <eez/libs/image/image.h>
+
+namespace eez {
+namespace gui {
+namespace thumbnail_cache {
+
+// 480x272 screenshot scaled down to 1/8
+static const uint32_t MAX_THUMBNAIL_WIDTH = 60;
+static const uint32_t MAX_THUMBNAIL_HEIGHT = 34;
+
+// Returns RGB565 thumbnail of the image file or nullptr if it is not loaded yet.
+// Missing thumbnail is loaded in the low priority thread, from the thumbnail file
+// stored in the hidden ".thumbs" subdirectory or, if there is no valid one, by decoding
+// the image (which then also creates the thumbnail file).
+// Version is changed every time thumbnail pixels are changed.
+// Called from the GUI thread.
+Image *getThumbnail(const char *filePath, uint32_t imageFileSize, uint32_t imageFileDateTime, uint16_t &version);
+
+void doLoadThumbnails();
+
+void deleteThumbnailFile(const char *filePath);
+
+void clear();
+
+} // namespace thumbnail_cache
+} // namespace gui
+} // namespace eez
@@ -26,6 +26,7 @@
 
 #include <eez/firmware.h>
 #include <eez/system.h>
+#include <eez/tasks.h>
 
 #include <eez/modules/psu/psu.h>
 
@@ -59,6 +60,12 @@ static uint32_t g_toutputPulseStartTickCount;
 
 static bool g_pinState[NUM_IO_PINS] = { false, false, false, false };
 
+// Trigger edges on input pins are captured (and timestamped) by the pin interrupt,
+// so trigger latency doesn't depend on the tick period and short pulses are not missed.
+static bool g_edgeCaptureEnabled[2];
+static volatile bool g_edgePending[2];
+static volatile uint32_t g_edgeTimeUsec[2];
+
 static float g_pwmFrequency[NUM_IO_PINS - DOUT1] = { PWM_DEFAULT_FREQUENCY, PWM_DEFAULT_FREQUENCY };
 static float g_pwmDuty[NUM_IO_PINS - DOUT1] = { PWM_DEFAULT_DUTY, PWM_DEFAULT_DUTY };
 static uint32_t g_pwmPeriodInt[NUM_IO_PINS - DOUT1];
@@ -107,15 +114,70 @@ void ioPinWrite(int pin, int state) {
 
 static int g_pins[NUM_IO_PINS];
 
+static void captureEdge(int pin, uint32_t timeUsec);
+
 int ioPinRead(int pin) {
     return g_pins[pin];
 }
 
 void ioPinWrite(int pin, int state) {
+    if (pin == EXT_TRIG1 || pin == EXT_TRIG2) {
+        // emulate pin interrupt
+        bool active = g_ioPins[pin].polarity == io_pins::POLARITY_POSITIVE ? state != 0 : state == 0;
+        bool wasActive = g_ioPins[pin].polarity == io_pins::POLARITY_POSITIVE ? g_pins[pin] != 0 : g_pins[pin] == 0;
+        g_pins[pin] = state;
+        if (active && !wasActive) {
+            captureEdge(pin, micros());
+        }
+        return;
+    }
+
 	g_pins[pin] = state;
 }
 
+void injectInputPinPulse(int pin, uint32_t timeUsec) {
+    // pulse is too short to be seen by the pin polling, so only the pin interrupt can catch it
+    captureEdge(pin, timeUsec);
+}
+
+#endif
+
+static bool isTriggerFunction(unsigned function) {
+    return function == io_pins::FUNCTION_SYSTRIG || function == io_pins::FUNCTION_DLOGTRIG;
+}
+
+static bool isEdgeCaptureSupported(int pin) {
+#if defined EEZ_PLATFORM_STM32
+#ifdef MASTER_MCU_REVISION_R3B3_OR_NEWER
+    return pin == 1 || !bp3c::flash_slave::g_bootloaderMode;
+#else
+    // EXTI line of the DIN1 pin is used by the encoder
+    return pin == 1;
+#endif
+#else
+    return true;
 #endif
+}
+
+static void captureEdge(int pin, uint32_t timeUsec) {
+    if (g_edgeCaptureEnabled[pin] && !g_edgePending[pin]) {
+        g_edgeTimeUsec[pin] = timeUsec;
+        g_edgePending[pin] = true;
+        sendMessageToPsu(PSU_MESSAGE_IO_PIN_EDGE, pin, 0);
+    }
+}
+
+void onInputPinInterrupt(int pin) {
+    captureEdge(pin, micros());
+}
+
+void onInputPinEdge(int pin) {
+    if (g_edgePending[pin]) {
+        uint32_t timeUsec = g_edgeTimeUsec[pin];
+        g_edgePending[pin] = false;
+        trigger::generateTriggerAt(pin == 0 ? trigger::SOURCE_PIN1 : trigger::SOURCE_PIN2, timeUsec);
+    }
+}
 
 uint8_t isOutputFault() {
 #if OPTION_FAN
@@ -146,17 +208,29 @@ uint8_t isOutputEnabled() {
 }
 
 void initInputPin(int pin) {
+    const IOPin &ioPin = g_ioPins[pin];
+
+    g_edgeCaptureEnabled[pin] = isEdgeCaptureSupported(pin) && isTriggerFunction(ioPin.function);
+    g_edgePending[pin] = false;
+
 #if defined EEZ_PLATFORM_STM32
     if (!bp3c::flash_slave::g_bootloaderMode || pin != 0) {
         GPIO_InitTypeDef GPIO_InitStruct = { 0 };
 
-        const IOPin &ioPin = g_ioPins[pin];
-
         GPIO_InitStruct.Pin = pin == 0 ? UART_RX_DIN1_Pin : DIN2_Pin;
-        GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+        if (g_edgeCaptureEnabled[pin]) {
+            GPIO_InitStruct.Mode = ioPin.polarity == io_pins::POLARITY_POSITIVE ? GPIO_MODE_IT_RISING : GPIO_MODE_IT_FALLING;
+        } else {
+            GPIO_InitStruct.Mode = GPIO_MODE_INPUT;
+        }
         GPIO_InitStruct.Pull = ioPin.polarity == io_pins::POLARITY_POSITIVE ? GPIO_PULLDOWN : GPIO_PULLUP;
         GPIO_InitStruct.Speed = GPIO_SPEED_FREQ_LOW;
         HAL_GPIO_Init(pin == 0 ? UART_RX_DIN1_GPIO_Port : DIN2_GPIO_Port, &GPIO_InitStruct);
+
+        if (isEdgeCaptureSupported(pin) && !g_edgeCaptureEnabled[pin]) {
+            // HAL_GPIO_Init leaves EXTI line as it is in input mode
+            EXTI->IMR &= ~GPIO_InitStruct.Pin;
+        }
     }
 #endif
 }
@@ -314,11 +388,16 @@ void tick(uint32_t tickCount) {
         Channel::onInhibitedChanged(inhibited);
     }
 
-    if ((inputPin1.function == io_pins::FUNCTION_SYSTRIG || inputPin1.function == io_pins::FUNCTION_DLOGTRIG) && inputPin1State && !g_pinState[0]) {
+    if (g_edgeCaptureEnabled[0]) {
+        // in case PSU message was lost
+        onInputPinEdge(0);
+    } else if (isTriggerFunction(inputPin1.function) && inputPin1State && !g_pinState[0]) {
         trigger::generateTrigger(trigger::SOURCE_PIN1);
     }
 
-    if ((inputPin2.function == io_pins::FUNCTION_SYSTRIG || inputPin2.function == io_pins::FUNCTION_DLOGTRIG) && inputPin2State && !g_pinState[1]) {
+    if (g_edgeCaptureEnabled[1]) {
+        onInputPinEdge(1);
+    } else if (isTriggerFunction(inputPin2.function) && inputPin2State && !g_pinState[1]) {
         trigger::generateTrigger(trigger::SOURCE_PIN2);
     }
 
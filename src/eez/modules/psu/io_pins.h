@@ -58,6 +58,16 @@ void tick(uint32_t tickCount);
 void onTrigger();
 void refresh();
 
+// Called from the EXTI interrupt on the active edge of the input pin (0 or 1).
+void onInputPinInterrupt(int pin);
+// Called in PSU thread to generate trigger from the captured edge.
+void onInputPinEdge(int pin);
+
+#if defined EEZ_PLATFORM_SIMULATOR
+// Simulates short pulse on input pin with active edge at given time (in micros() units).
+void injectInputPinPulse(int pin, uint32_t timeUsec);
+#endif
+
 // When PSU is in inhibited state all outputs are disabled and execution of LIST on channels is stopped.
 bool isInhibited();
 
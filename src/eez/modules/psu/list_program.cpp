@@ -24,8 +24,11 @@
 
 #include <eez/system.h>
 #include <eez/firmware.h>
+#include <eez/memory.h>
+#include <eez/tasks.h>
 
 #include <eez/modules/psu/psu.h>
+#include <eez/modules/psu/calibration.h>
 #include <eez/modules/psu/channel_dispatcher.h>
 #include <eez/modules/psu/list_program.h>
 #include <eez/modules/psu/trigger.h>
@@ -57,6 +60,8 @@ static struct {
     uint16_t currentListLength;
 
     uint16_t count;
+
+    uint8_t timing;
 } g_channelsLists[CH_MAX];
 
 static struct {
@@ -66,14 +71,90 @@ static struct {
     int32_t currentRemainingDwellTime;
     float currentTotalDwellTime;
     uint32_t lastTickCount;
+    bool hardwareTimed;
 } g_execution[CH_MAX];
 
 static bool g_active;
 
+// Result of checkLimits is cached, so re-initiating trigger doesn't go through all
+// the list values again. Cache is invalidated when list is changed, everything else
+// the result depends on (limits, coupling, tracking, ...) is part of the cache key.
+static struct {
+    bool valid;
+    int err;
+    float uLimit;
+    float iLimit;
+    float pLimit;
+    uint8_t couplingType;
+    uint8_t trackingChannels;
+    uint8_t currentRangeSelectionMode;
+    bool calibrationEnabled;
+} g_checkLimitsCache[CH_MAX];
+
+static uint32_t g_checkLimitsCacheHits;
+static uint32_t g_checkLimitsCacheMisses;
+
+// In hardware timed execution list values are rounded and checked against the limits
+// when list is started, so each step only sets already prepared values. Step times are
+// absolute (each step is scheduled from the previous step time, not from the time it
+// was actually executed), so timing errors don't accumulate over the list.
+struct StagedStep {
+    float voltage;
+    float current;
+    uint64_t dwellUsec;
+};
+
+static StagedStep (* const g_stagedSteps)[MAX_LIST_LENGTH] = (StagedStep (*)[MAX_LIST_LENGTH])LIST_STAGED_STEPS_MEMORY;
+
+static_assert(CH_MAX * MAX_LIST_LENGTH * sizeof(StagedStep) <= LIST_STAGED_STEPS_MEMORY_SIZE, "LIST_STAGED_STEPS_MEMORY_SIZE too small");
+
+static struct {
+    // limits at the time values were staged
+    float uLimit;
+    float iLimit;
+    float pLimit;
+
+    uint64_t nextStepTimeUsec;
+    uint64_t lastTimeUsec;
+
+    uint32_t numSteps;
+    uint32_t maxErrorUsec;
+    uint64_t sumErrorUsec;
+} g_hardwareTimedExecution[CH_MAX];
+
+// micros() extended to 64-bit, lower 32 bits are the same as micros()
+static uint64_t g_timeUsec;
+static uint32_t g_lastMicros;
+
+// Step timer: PSU_IncTick (or, in simulator, list timer thread) checks if next hardware
+// timed step is due and posts PSU_MESSAGE_LIST_STEP to the PSU thread.
+static volatile bool g_timerArmed;
+static volatile bool g_timerMessagePending;
+static volatile uint32_t g_timerNextStepUsec;
+
+#if defined(EEZ_PLATFORM_SIMULATOR) && !defined(__EMSCRIPTEN__)
+
+void timerThreadMainLoop(const void *);
+
+osThreadDef(g_listTimerThread, timerThreadMainLoop, osPriorityAboveNormal, 0, 1024);
+
+void timerThreadMainLoop(const void *) {
+    while (1) {
+        osDelay(1);
+        postHardwareTimedStepIfDue();
+    }
+}
+
+#endif
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void init() {
     reset();
+
+#if defined(EEZ_PLATFORM_SIMULATOR) && !defined(__EMSCRIPTEN__)
+    osThreadCreate(osThread(g_listTimerThread), nullptr);
+#endif
 }
 
 void resetChannelList(Channel &channel) {
@@ -85,7 +166,11 @@ void resetChannelList(Channel &channel) {
 
     g_channelsLists[i].count = 1;
 
+    g_channelsLists[i].timing = LIST_TIMING_SOFTWARE;
+
     g_execution[i].counter = -1;
+
+    g_checkLimitsCache[i].valid = false;
 }
 
 void reset() {
@@ -97,6 +182,7 @@ void reset() {
 void setDwellList(Channel &channel, float *list, uint16_t listLength) {
     memcpy(g_channelsLists[channel.channelIndex].dwellList, list, listLength * sizeof(float));
     g_channelsLists[channel.channelIndex].dwellListLength = listLength;
+    g_checkLimitsCache[channel.channelIndex].valid = false;
 }
 
 float *getDwellList(Channel &channel, uint16_t *listLength) {
@@ -107,6 +193,7 @@ float *getDwellList(Channel &channel, uint16_t *listLength) {
 void setVoltageList(Channel &channel, float *list, uint16_t listLength) {
     memcpy(g_channelsLists[channel.channelIndex].voltageList, list, listLength * sizeof(float));
     g_channelsLists[channel.channelIndex].voltageListLength = listLength;
+    g_checkLimitsCache[channel.channelIndex].valid = false;
 }
 
 float *getVoltageList(Channel &channel, uint16_t *listLength) {
@@ -117,6 +204,7 @@ float *getVoltageList(Channel &channel, uint16_t *listLength) {
 void setCurrentList(Channel &channel, float *list, uint16_t listLength) {
     memcpy(g_channelsLists[channel.channelIndex].currentList, list, listLength * sizeof(float));
     g_channelsLists[channel.channelIndex].currentListLength = listLength;
+    g_checkLimitsCache[channel.channelIndex].valid = false;
 }
 
 float *getCurrentList(Channel &channel, uint16_t *listLength) {
@@ -132,6 +220,14 @@ void setListCount(Channel &channel, uint16_t value) {
     g_channelsLists[channel.channelIndex].count = value;
 }
 
+ListTiming getTiming(Channel &channel) {
+    return (ListTiming)g_channelsLists[channel.channelIndex].timing;
+}
+
+void setTiming(Channel &channel, ListTiming timing) {
+    g_channelsLists[channel.channelIndex].timing = timing;
+}
+
 bool isListEmpty(Channel &channel) {
     return g_channelsLists[channel.channelIndex].dwellListLength == 0 &&
            g_channelsLists[channel.channelIndex].voltageListLength == 0 &&
@@ -169,7 +265,7 @@ bool areVoltageAndCurrentListLengthsEquivalent(Channel &channel) {
                                     g_channelsLists[channel.channelIndex].currentListLength);
 }
 
-int checkLimits(int iChannel) {
+static int doCheckLimits(int iChannel) {
     Channel &channel = Channel::get(iChannel);
 
     uint16_t voltageListLength = g_channelsLists[iChannel].voltageListLength;
@@ -219,6 +315,65 @@ int checkLimits(int iChannel) {
     return 0;
 }
 
+int checkLimits(int iChannel) {
+    Channel &channel = Channel::get(iChannel);
+    auto &cache = g_checkLimitsCache[iChannel];
+
+    float uLimit = channel_dispatcher::getULimit(channel);
+    float iLimit = channel_dispatcher::getILimit(channel);
+    float pLimit = channel_dispatcher::getPowerLimit(channel);
+    uint8_t couplingType = channel_dispatcher::getCouplingType();
+    uint8_t trackingChannels = 0;
+    for (int i = 0; i < CH_NUM; i++) {
+        if (Channel::get(i).flags.trackingEnabled) {
+            trackingChannels |= 1 << i;
+        }
+    }
+    uint8_t currentRangeSelectionMode = channel.flags.currentRangeSelectionMode;
+    bool calibrationEnabled = calibration::g_editor.isEnabled();
+
+    if (
+        cache.valid &&
+        cache.uLimit == uLimit &&
+        cache.iLimit == iLimit &&
+        cache.pLimit == pLimit &&
+        cache.couplingType == couplingType &&
+        cache.trackingChannels == trackingChannels &&
+        cache.currentRangeSelectionMode == currentRangeSelectionMode &&
+        cache.calibrationEnabled == calibrationEnabled
+    ) {
+        g_checkLimitsCacheHits++;
+        if (cache.err && cache.err != SCPI_ERROR_CANNOT_SET_LIST_VALUE) {
+            g_errorChannelIndex = channel.channelIndex;
+        }
+        return cache.err;
+    }
+
+    g_checkLimitsCacheMisses++;
+
+    cache.err = doCheckLimits(iChannel);
+    cache.uLimit = uLimit;
+    cache.iLimit = iLimit;
+    cache.pLimit = pLimit;
+    cache.couplingType = couplingType;
+    cache.trackingChannels = trackingChannels;
+    cache.currentRangeSelectionMode = currentRangeSelectionMode;
+    cache.calibrationEnabled = calibrationEnabled;
+    cache.valid = true;
+
+    return cache.err;
+}
+
+void getCheckLimitsCacheStatistics(uint32_t &hits, uint32_t &misses) {
+    hits = g_checkLimitsCacheHits;
+    misses = g_checkLimitsCacheMisses;
+}
+
+void clearCheckLimitsCacheStatistics() {
+    g_checkLimitsCacheHits = 0;
+    g_checkLimitsCacheMisses = 0;
+}
+
 bool loadList(
     sd_card::BufferedFileRead &file,
     float *dwellList, uint16_t &dwellListLength,
@@ -520,9 +675,16 @@ void setActive(bool active, bool forceUpdate = false) {
     }
 }
 
+static void stageList(Channel &channel);
+
 void executionStart(Channel &channel) {
     g_execution[channel.channelIndex].it = -1;
     g_execution[channel.channelIndex].counter = g_channelsLists[channel.channelIndex].count;
+    g_execution[channel.channelIndex].hardwareTimed = g_channelsLists[channel.channelIndex].timing == LIST_TIMING_HARDWARE;
+    if (g_execution[channel.channelIndex].hardwareTimed) {
+        stageList(channel);
+        g_timerMessagePending = false;
+    }
     channel_dispatcher::setVoltage(channel, 0);
     channel_dispatcher::setCurrent(channel, 0);
     setActive(true, true);
@@ -546,6 +708,19 @@ int maxListsSize(Channel &channel) {
     return maxSize;
 }
 
+static void setChannelValues(Channel &channel, float voltage, float current) {
+    bool setVoltage = channel_dispatcher::getUSet(channel) != voltage;
+    bool setCurrent = channel_dispatcher::getISet(channel) != current;
+
+    if (setVoltage && setCurrent) {
+        channel_dispatcher::setVoltageAndCurrent(channel, voltage, current);
+    } else if (setVoltage) {
+        channel_dispatcher::setVoltage(channel, voltage);
+    } else if (setCurrent) {
+        channel_dispatcher::setCurrent(channel, current);
+    }
+}
+
 bool setListValue(Channel &channel, int16_t it, int *err) {
     float voltage = channel_dispatcher::roundChannelValue(channel, UNIT_VOLT, g_channelsLists[channel.channelIndex].voltageList[it % g_channelsLists[channel.channelIndex].voltageListLength]);
     if (channel.isVoltageLimitExceeded(voltage)) {
@@ -566,18 +741,190 @@ bool setListValue(Channel &channel, int16_t it, int *err) {
         return false;
     }
 
-    if (channel_dispatcher::getUSet(channel) != voltage) {
-        channel_dispatcher::setVoltage(channel, voltage);
+    setChannelValues(channel, voltage, current);
+
+    return true;
+}
+
+static uint64_t getTimeUsec() {
+    uint32_t now = micros();
+    g_timeUsec += (uint32_t)(now - g_lastMicros);
+    g_lastMicros = now;
+    return g_timeUsec;
+}
+
+static void stageList(Channel &channel) {
+    int i = channel.channelIndex;
+    auto &lists = g_channelsLists[i];
+    auto &hardwareTimedExecution = g_hardwareTimedExecution[i];
+
+    // list values are already checked by checkLimits before list is started
+    int size = maxListsSize(channel);
+    for (int it = 0; it < size; it++) {
+        StagedStep &step = g_stagedSteps[i][it];
+        step.voltage = channel_dispatcher::roundChannelValue(channel, UNIT_VOLT, lists.voltageList[it % lists.voltageListLength]);
+        step.current = channel_dispatcher::roundChannelValue(channel, UNIT_AMPER, lists.currentList[it % lists.currentListLength]);
+        step.dwellUsec = (uint64_t)round(lists.dwellList[it % lists.dwellListLength] * 1000000.0);
     }
 
-    if (channel_dispatcher::getISet(channel) != current) {
-        channel_dispatcher::setCurrent(channel, current);
+    hardwareTimedExecution.uLimit = channel_dispatcher::getULimit(channel);
+    hardwareTimedExecution.iLimit = channel_dispatcher::getILimit(channel);
+    hardwareTimedExecution.pLimit = channel_dispatcher::getPowerLimit(channel);
+
+    hardwareTimedExecution.numSteps = 0;
+    hardwareTimedExecution.maxErrorUsec = 0;
+    hardwareTimedExecution.sumErrorUsec = 0;
+}
+
+static bool setStagedListValue(Channel &channel, int16_t it, int *err) {
+    auto &hardwareTimedExecution = g_hardwareTimedExecution[channel.channelIndex];
+
+    if (
+        hardwareTimedExecution.uLimit != channel_dispatcher::getULimit(channel) ||
+        hardwareTimedExecution.iLimit != channel_dispatcher::getILimit(channel) ||
+        hardwareTimedExecution.pLimit != channel_dispatcher::getPowerLimit(channel)
+    ) {
+        // limits changed during execution, staged values must be checked again
+        return setListValue(channel, it, err);
     }
 
+    StagedStep &step = g_stagedSteps[channel.channelIndex][it];
+
+    setChannelValues(channel, step.voltage, step.current);
+
     return true;
 }
 
+static void setRemainingDwellTime(int i, uint64_t remainingUsec) {
+    if (g_execution[i].currentTotalDwellTime > CONF_COUNTER_THRESHOLD_IN_SECONDS) {
+        g_execution[i].currentRemainingDwellTime = (int32_t)(remainingUsec / 1000);
+    } else {
+        g_execution[i].currentRemainingDwellTime = (int32_t)remainingUsec;
+    }
+}
+
+// returns false if tick should stop processing other channels
+static bool tickHardwareTimed(Channel &channel) {
+    int i = channel.channelIndex;
+    auto &execution = g_execution[i];
+    auto &hardwareTimedExecution = g_hardwareTimedExecution[i];
+
+    uint64_t timeUsec = getTimeUsec();
+
+    if (io_pins::isInhibited()) {
+        if (execution.it != -1) {
+            hardwareTimedExecution.nextStepTimeUsec += timeUsec - hardwareTimedExecution.lastTimeUsec;
+        }
+        hardwareTimedExecution.lastTimeUsec = timeUsec;
+        return true;
+    }
+
+    hardwareTimedExecution.lastTimeUsec = timeUsec;
+
+    if (execution.it == -1) {
+        hardwareTimedExecution.nextStepTimeUsec = timeUsec;
+    } else {
+        if (timeUsec < hardwareTimedExecution.nextStepTimeUsec) {
+            setRemainingDwellTime(i, hardwareTimedExecution.nextStepTimeUsec - timeUsec);
+            return true;
+        }
+
+        uint64_t errorUsec = timeUsec - hardwareTimedExecution.nextStepTimeUsec;
+        if (errorUsec > 0xFFFFFFFF) {
+            errorUsec = 0xFFFFFFFF;
+        }
+        hardwareTimedExecution.numSteps++;
+        if (errorUsec > hardwareTimedExecution.maxErrorUsec) {
+            hardwareTimedExecution.maxErrorUsec = (uint32_t)errorUsec;
+        }
+        hardwareTimedExecution.sumErrorUsec += errorUsec;
+    }
+
+    if (++execution.it == maxListsSize(channel)) {
+        if (execution.counter > 0) {
+            if (--execution.counter == 0) {
+                execution.counter = -1;
+                trigger::setTriggerFinished(channel);
+                return false;
+            }
+        }
+
+        execution.it = 0;
+    }
+
+    int err;
+    if (!setStagedListValue(channel, execution.it, &err)) {
+        generateError(err);
+        setActive(false);
+        trigger::abort();
+        return false;
+    }
+
+    execution.currentTotalDwellTime = g_channelsLists[i].dwellList[execution.it % g_channelsLists[i].dwellListLength];
+
+    hardwareTimedExecution.nextStepTimeUsec += g_stagedSteps[i][execution.it].dwellUsec;
+    setRemainingDwellTime(i, hardwareTimedExecution.nextStepTimeUsec > timeUsec ? hardwareTimedExecution.nextStepTimeUsec - timeUsec : 0);
+
+    return true;
+}
+
+static void updateTimer() {
+    bool armed = false;
+    uint64_t nextStepTimeUsec = 0;
+
+    for (int i = 0; i < CH_NUM; ++i) {
+        if (g_execution[i].counter >= 0 && g_execution[i].hardwareTimed && g_execution[i].it != -1) {
+            if (!armed || g_hardwareTimedExecution[i].nextStepTimeUsec < nextStepTimeUsec) {
+                nextStepTimeUsec = g_hardwareTimedExecution[i].nextStepTimeUsec;
+                armed = true;
+            }
+        }
+    }
+
+    // step which is more then 1 second away is handled by the regular tick,
+    // so the 32-bit timer compare doesn't wrap around
+    if (armed && nextStepTimeUsec > g_timeUsec && nextStepTimeUsec - g_timeUsec > 1000000) {
+        armed = false;
+    }
+
+    g_timerArmed = false;
+    g_timerNextStepUsec = (uint32_t)nextStepTimeUsec;
+    g_timerArmed = armed;
+}
+
+static void doTick();
+
 void tick(uint32_t tick_usec) {
+    doTick();
+    updateTimer();
+}
+
+void postHardwareTimedStepIfDue() {
+    if (g_timerArmed && !g_timerMessagePending && (int32_t)(micros() - g_timerNextStepUsec) >= 0) {
+        g_timerMessagePending = true;
+        if (!postMessageToPsu(PSU_MESSAGE_LIST_STEP)) {
+            // PSU message queue is full, try again on the next tick
+            g_timerMessagePending = false;
+        }
+    }
+}
+
+void onHardwareTimedStep() {
+    g_timerMessagePending = false;
+    tick(micros());
+}
+
+int getFirstTrackingChannel();
+
+void getTimingStatistics(Channel &channel, uint32_t &numSteps, uint32_t &maxErrorUsec, uint32_t &avgErrorUsec) {
+    int i = channel.flags.trackingEnabled ? getFirstTrackingChannel() : channel.channelIndex;
+    auto &hardwareTimedExecution = g_hardwareTimedExecution[i];
+    numSteps = hardwareTimedExecution.numSteps;
+    maxErrorUsec = hardwareTimedExecution.maxErrorUsec;
+    avgErrorUsec = numSteps > 0 ? (uint32_t)(hardwareTimedExecution.sumErrorUsec / numSteps) : 0;
+}
+
+static void doTick() {
     bool active = false;
 
     for (int i = 0; i < CH_NUM; ++i) {
@@ -592,6 +939,13 @@ void tick(uint32_t tick_usec) {
 
             active = true;
 
+            if (g_execution[i].hardwareTimed) {
+                if (!tickHardwareTimed(channel)) {
+                    return;
+                }
+                continue;
+            }
+
             uint32_t tickCount;
             bool tickCountInMillis = g_execution[i].currentTotalDwellTime > CONF_COUNTER_THRESHOLD_IN_SECONDS;
             if (tickCountInMillis) {
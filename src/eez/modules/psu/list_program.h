@@ -35,6 +35,11 @@ class BufferedFileWrite;
 
 namespace list {
 
+enum ListTiming {
+    LIST_TIMING_SOFTWARE,
+    LIST_TIMING_HARDWARE
+};
+
 void init();
 
 void resetChannelList(Channel &channel);
@@ -52,6 +57,9 @@ float *getCurrentList(Channel &channel, uint16_t *listLength);
 uint16_t getListCount(Channel &channel);
 void setListCount(Channel &channel, uint16_t value);
 
+ListTiming getTiming(Channel &channel);
+void setTiming(Channel &channel, ListTiming timing);
+
 bool isListEmpty(Channel &channel);
 
 bool areListLengthsEquivalent(uint16_t size1, uint16_t size2);
@@ -62,6 +70,8 @@ bool areCurrentAndDwellListLengthsEquivalent(Channel &channel);
 bool areVoltageAndCurrentListLengthsEquivalent(Channel &channel);
 
 int checkLimits(int iChannel);
+void getCheckLimitsCacheStatistics(uint32_t &hits, uint32_t &misses);
+void clearCheckLimitsCacheStatistics();
 
 bool loadList(
     sd_card::BufferedFileRead &file,
@@ -107,6 +117,12 @@ bool setListValue(Channel &channel, int16_t it, int *err);
 
 void tick(uint32_t tick_usec);
 
+// Called from PSU_IncTick interrupt, posts PSU_MESSAGE_LIST_STEP (only once per step) when the next step is due.
+void postHardwareTimedStepIfDue();
+void onHardwareTimedStep();
+
+void getTimingStatistics(Channel &channel, uint32_t &numSteps, uint32_t &maxErrorUsec, uint32_t &avgErrorUsec);
+
 bool isActive();
 bool isActive(Channel &channel);
 
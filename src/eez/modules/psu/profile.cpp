@@ -16,10 +16,13 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 
+#include <stddef.h>
 #include <stdio.h>
 
 #include <eez/file_type.h>
 #include <eez/hmi.h>
+#include <eez/system.h>
+#include <eez/util.h>
 
 #include <eez/modules/psu/psu.h>
 #include <eez/modules/psu/channel_dispatcher.h>
@@ -56,7 +59,38 @@ struct List {
     uint16_t currentListLength;
 };
 
-   
+// Profile locations are stored in binary format: header, followed by Parameters
+// struct as is and list lengths and values for each channel with valid parameters.
+// Text format copy is appended at the end, it is used when profile was saved
+// by firmware with different Parameters layout and when location is exported.
+static const uint32_t BINARY_PROFILE_MAGIC = 0x46525045; // "EPRF"
+static const uint16_t BINARY_PROFILE_VERSION = 1;
+// Increment when Parameters layout or layout of the module specific parameters
+// changes without changing the size of any of the structs or the field offsets
+// hashed into layoutId.
+static const uint32_t BINARY_PROFILE_LAYOUT_VERSION = 2;
+
+struct BinaryProfileSlot {
+    uint16_t moduleType;
+    uint16_t moduleRevision;
+    uint8_t parametersAreValid;
+};
+
+struct BinaryProfileHeader {
+    // these fields must be at the same place in all versions
+    uint32_t magic;
+    uint16_t version;
+    uint16_t headerSize;
+    uint32_t layoutId;
+    uint32_t textOffset;
+
+    // everything needed to display profile in the list without reading whole file
+    uint8_t isValid;
+    uint8_t powerIsUp;
+    char name[PROFILE_NAME_MAX_LENGTH + 1];
+    BinaryProfileSlot slots[NUM_SLOTS];
+};
+
 static uint32_t g_lastAutoSaveTime;
 static bool g_freeze;
 static profile::Parameters g_profilesCache[NUM_PROFILE_LOCATIONS];
@@ -75,11 +109,12 @@ static void resetProfileToDefaults(Parameters &profile);
 static void saveState(Parameters &profile, List *lists);
 static bool recallState(Parameters &profile, List *lists, int recallOptions, int *err);
 
-static bool saveProfileToFile(const char *filePath, Parameters &profile, List *lists, bool showProgress, int *err);
+static bool saveProfileToFile(const char *filePath, Parameters &profile, List *lists, bool binary, bool showProgress, int *err);
 static void saveStateToProfile0(bool merge);
 
 enum {
-    LOAD_PROFILE_FROM_FILE_OPTION_ONLY_NAME = 0x01
+    LOAD_PROFILE_FROM_FILE_OPTION_ONLY_NAME = 0x01,
+    LOAD_PROFILE_FROM_FILE_OPTION_ONLY_TEXT = 0x02
 };
 static bool loadProfileFromFile(const char *filePath, Parameters &profile, List *lists, int options, bool showProgress, int *err);
 
@@ -223,7 +258,7 @@ bool saveToLocation(int location, const char *name, bool showProgress, int *err)
         strcpy(profile.name, name);
     }
 
-    if (!saveProfileToFile(filePath, profile, nullptr, showProgress, err)) {
+    if (!saveProfileToFile(filePath, profile, nullptr, true, showProgress, err)) {
         return false;
     }
 
@@ -237,7 +272,7 @@ bool saveToFile(const char *filePath, bool showProgress, int *err) {
     Parameters profile;
     memset(&profile, 0, sizeof(Parameters));
     saveState(profile, nullptr);
-    return saveProfileToFile(filePath, profile, nullptr, showProgress, err);
+    return saveProfileToFile(filePath, profile, nullptr, false, showProgress, err);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -245,17 +280,32 @@ bool saveToFile(const char *filePath, bool showProgress, int *err) {
 bool importFileToLocation(const char *filePath, int location, bool showProgress, int *err) {
     char profileFilePath[MAX_PATH_LENGTH];
     getProfileFilePath(location, profileFilePath);
-    if (sd_card::copyFile(filePath, profileFilePath, true, err)) {
-        loadProfileParametersToCache(location);
-        return true;
+
+    Parameters profile;
+    resetProfileToDefaults(profile);
+    if (!loadProfileFromFile(filePath, profile, g_listsProfile0, 0, showProgress, err)) {
+        return false;
     }
-    return false;
+
+    if (!saveProfileToFile(profileFilePath, profile, g_listsProfile0, true, showProgress, err)) {
+        return false;
+    }
+
+    loadProfileParametersToCache(location);
+    return true;
 }
 
 bool exportLocationToFile(int location, const char *filePath, bool showProgress, int *err) {
     char profileFilePath[MAX_PATH_LENGTH];
     getProfileFilePath(location, profileFilePath);
-    return sd_card::copyFile(profileFilePath, filePath, true, err);
+
+    Parameters profile;
+    resetProfileToDefaults(profile);
+    if (!loadProfileFromFile(profileFilePath, profile, g_listsProfile0, 0, showProgress, err)) {
+        return false;
+    }
+
+    return saveProfileToFile(filePath, profile, g_listsProfile0, false, showProgress, err);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -352,7 +402,7 @@ bool setName(int location, const char *name, bool showProgress, int *err) {
                 strcpy(profile.name, name);
             }
 
-            if (!saveProfileToFile(filePath, profile, g_listsProfile10, showProgress, err)) {
+            if (!saveProfileToFile(filePath, profile, g_listsProfile10, true, showProgress, err)) {
                 return false;
             }
 
@@ -1053,7 +1103,129 @@ static bool profileWrite(WriteContext &ctx, const Parameters &parameters, List *
     return true;
 }
 
-static bool saveProfileToFile(const char *filePath, Parameters &profile, List *lists, bool showProgress, int *err) {
+static uint32_t getBinaryProfileLayoutId() {
+    static uint32_t g_layoutId;
+
+    if (!g_layoutId) {
+        uint32_t layout[] = {
+            BINARY_PROFILE_LAYOUT_VERSION,
+            sizeof(Parameters),
+            sizeof(ChannelParameters),
+            sizeof(SlotParameters),
+            sizeof(List),
+            CH_MAX,
+            NUM_SLOTS,
+            MAX_LIST_LENGTH,
+
+            // power channel parameters are stored inside ChannelParameters::parameters,
+            // so their layout doesn't change the size of any of the structs above
+            sizeof(PowerChannelProfileParameters),
+            offsetof(PowerChannelProfileParameters, u_set),
+            offsetof(PowerChannelProfileParameters, u_step),
+            offsetof(PowerChannelProfileParameters, u_limit),
+            offsetof(PowerChannelProfileParameters, u_delay),
+            offsetof(PowerChannelProfileParameters, u_level),
+            offsetof(PowerChannelProfileParameters, i_set),
+            offsetof(PowerChannelProfileParameters, i_step),
+            offsetof(PowerChannelProfileParameters, i_limit),
+            offsetof(PowerChannelProfileParameters, i_delay),
+            offsetof(PowerChannelProfileParameters, p_limit),
+            offsetof(PowerChannelProfileParameters, p_delay),
+            offsetof(PowerChannelProfileParameters, p_level),
+            offsetof(PowerChannelProfileParameters, ytViewRate),
+            offsetof(PowerChannelProfileParameters, u_triggerValue),
+            offsetof(PowerChannelProfileParameters, i_triggerValue),
+            offsetof(PowerChannelProfileParameters, listCount),
+            offsetof(PowerChannelProfileParameters, u_rampDuration),
+            offsetof(PowerChannelProfileParameters, i_rampDuration),
+            offsetof(PowerChannelProfileParameters, u_rampShape),
+            offsetof(PowerChannelProfileParameters, i_rampShape),
+            offsetof(PowerChannelProfileParameters, outputDelayDuration),
+            offsetof(PowerChannelProfileParameters, label),
+            offsetof(PowerChannelProfileParameters, color)
+        };
+        g_layoutId = crc32((const uint8_t *)layout, sizeof(layout));
+    }
+
+    return g_layoutId;
+}
+
+static void getChannelLists(int channelIndex, List *lists, float **listValues, uint16_t *listLengths) {
+    if (lists) {
+        auto &list = lists[channelIndex];
+        listValues[0] = list.dwellList;
+        listLengths[0] = list.dwellListLength;
+        listValues[1] = list.voltageList;
+        listLengths[1] = list.voltageListLength;
+        listValues[2] = list.currentList;
+        listLengths[2] = list.currentListLength;
+    } else {
+        auto &channel = Channel::get(channelIndex);
+        listValues[0] = list::getDwellList(channel, &listLengths[0]);
+        listValues[1] = list::getVoltageList(channel, &listLengths[1]);
+        listValues[2] = list::getCurrentList(channel, &listLengths[2]);
+    }
+}
+
+static bool profileWriteBinary(File &file, const Parameters &parameters, List *lists) {
+    float *listValues[CH_MAX][3];
+    uint16_t listLengths[CH_MAX][3];
+
+    uint32_t textOffset = sizeof(BinaryProfileHeader) + sizeof(Parameters);
+
+    for (int channelIndex = 0; channelIndex < CH_MAX; channelIndex++) {
+        if (parameters.channels[channelIndex].parametersAreValid) {
+            getChannelLists(channelIndex, lists, listValues[channelIndex], listLengths[channelIndex]);
+            textOffset += sizeof(listLengths[channelIndex]);
+            for (int i = 0; i < 3; i++) {
+                textOffset += listLengths[channelIndex][i] * sizeof(float);
+            }
+        }
+    }
+
+    BinaryProfileHeader header;
+    memset(&header, 0, sizeof(header));
+    header.magic = BINARY_PROFILE_MAGIC;
+    header.version = BINARY_PROFILE_VERSION;
+    header.headerSize = sizeof(BinaryProfileHeader);
+    header.layoutId = getBinaryProfileLayoutId();
+    header.textOffset = textOffset;
+    header.isValid = parameters.flags.isValid;
+    header.powerIsUp = parameters.flags.powerIsUp;
+    strcpy(header.name, parameters.name);
+    for (int i = 0; i < NUM_SLOTS; i++) {
+        header.slots[i].moduleType = parameters.slots[i].moduleType;
+        header.slots[i].moduleRevision = parameters.slots[i].moduleRevision;
+        header.slots[i].parametersAreValid = parameters.slots[i].parametersAreValid;
+    }
+
+    if (file.write(&header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+
+    if (file.write(&parameters, sizeof(Parameters)) != sizeof(Parameters)) {
+        return false;
+    }
+
+    for (int channelIndex = 0; channelIndex < CH_MAX; channelIndex++) {
+        if (parameters.channels[channelIndex].parametersAreValid) {
+            if (file.write(listLengths[channelIndex], sizeof(listLengths[channelIndex])) != sizeof(listLengths[channelIndex])) {
+                return false;
+            }
+
+            for (int i = 0; i < 3; i++) {
+                size_t size = listLengths[channelIndex][i] * sizeof(float);
+                if (size > 0 && file.write(listValues[channelIndex][i], size) != size) {
+                    return false;
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
+static bool saveProfileToFile(const char *filePath, Parameters &profile, List *lists, bool binary, bool showProgress, int *err) {
     if (!sd_card::isMounted(err)) {
         if (err) {
             *err = SCPI_ERROR_MISSING_MASS_MEDIA;
@@ -1073,13 +1245,15 @@ static bool saveProfileToFile(const char *filePath, Parameters &profile, List *l
         File file;
 
         if (file.open(filePath, FILE_CREATE_ALWAYS | FILE_WRITE)) {
-            WriteContext ctx(file);
-
-            if (profileWrite(ctx, profile, lists, showProgress)) {
-                if (ctx.flush()) {
-                    file.close();
-                    onSdCardFileChangeHook(filePath);
-                    return true;
+            if (!binary || profileWriteBinary(file, profile, lists)) {
+                WriteContext ctx(file);
+
+                if (profileWrite(ctx, profile, lists, showProgress)) {
+                    if (ctx.flush()) {
+                        file.close();
+                        onSdCardFileChangeHook(filePath);
+                        return true;
+                    }
                 }
             }
         }
@@ -1105,7 +1279,7 @@ static void saveStateToProfile0(bool merge) {
     saveState(g_profilesCache[0], g_listsProfile0);
 
     int err;
-    if (!saveProfileToFile(filePath, g_profilesCache[0], g_listsProfile0, false, &err)) {
+    if (!saveProfileToFile(filePath, g_profilesCache[0], g_listsProfile0, true, false, &err)) {
         generateError(err);
         return;
     }
@@ -1384,6 +1558,70 @@ static bool profileRead(ReadContext &ctx, Parameters &parameters, List *lists, i
     return ctx.doRead(profileReadCallback, parameters, lists, options, showProgress);
 }
 
+static bool readBinaryProfileHeader(File &file, BinaryProfileHeader &header) {
+    if (file.read(&header, sizeof(header)) != sizeof(header)) {
+        return false;
+    }
+    return header.magic == BINARY_PROFILE_MAGIC;
+}
+
+static void profileReadBinaryHeader(const BinaryProfileHeader &header, Parameters &parameters) {
+    parameters.flags.isValid = header.isValid;
+    parameters.flags.powerIsUp = header.powerIsUp;
+
+    strncpy(parameters.name, header.name, PROFILE_NAME_MAX_LENGTH);
+    parameters.name[PROFILE_NAME_MAX_LENGTH] = 0;
+
+    for (int i = 0; i < NUM_SLOTS; i++) {
+        parameters.slots[i].moduleType = header.slots[i].moduleType;
+        parameters.slots[i].moduleRevision = header.slots[i].moduleRevision;
+        parameters.slots[i].parametersAreValid = header.slots[i].parametersAreValid;
+    }
+}
+
+static bool profileReadBinary(File &file, Parameters &parameters, List *lists) {
+    LoadStatus loadStatus = parameters.loadStatus;
+    bool result = file.read(&parameters, sizeof(Parameters)) == sizeof(Parameters);
+    parameters.loadStatus = loadStatus;
+
+    if (result && lists) {
+        for (int channelIndex = 0; channelIndex < CH_MAX && result; channelIndex++) {
+            if (!parameters.channels[channelIndex].parametersAreValid) {
+                continue;
+            }
+
+            auto &list = lists[channelIndex];
+            float *listValues[3] = { list.dwellList, list.voltageList, list.currentList };
+
+            uint16_t listLengths[3];
+            if (file.read(listLengths, sizeof(listLengths)) != sizeof(listLengths)) {
+                result = false;
+                break;
+            }
+
+            for (int i = 0; i < 3; i++) {
+                size_t size = listLengths[i] * sizeof(float);
+                if (listLengths[i] > MAX_LIST_LENGTH || (size > 0 && file.read(listValues[i], size) != size)) {
+                    result = false;
+                    break;
+                }
+            }
+
+            if (!result) {
+                break;
+            }
+
+            list.dwellListLength = listLengths[0];
+            list.voltageListLength = listLengths[1];
+            list.currentListLength = listLengths[2];
+        }
+    }
+
+    parameters.flags.isValid = result;
+
+    return result;
+}
+
 static bool loadProfileFromFile(const char *filePath, Parameters &profile, List *lists, int options, bool showProgress, int *err) {
     if (!sd_card::isMounted(err)) {
         if (err) {
@@ -1408,9 +1646,26 @@ static bool loadProfileFromFile(const char *filePath, Parameters &profile, List
         return false;
     }
 
-    ReadContext ctx(file);
+    bool result;
 
-    bool result = profileRead(ctx, profile, lists, options, showProgress);
+    BinaryProfileHeader header;
+    if (readBinaryProfileHeader(file, header)) {
+        bool sameVersion = header.version == BINARY_PROFILE_VERSION && header.headerSize == sizeof(BinaryProfileHeader);
+        if (sameVersion && (options & LOAD_PROFILE_FROM_FILE_OPTION_ONLY_NAME)) {
+            profileReadBinaryHeader(header, profile);
+            result = true;
+        } else if (sameVersion && header.layoutId == getBinaryProfileLayoutId() && !(options & LOAD_PROFILE_FROM_FILE_OPTION_ONLY_TEXT)) {
+            result = profileReadBinary(file, profile, lists);
+        } else {
+            file.seek(header.textOffset);
+            ReadContext ctx(file);
+            result = profileRead(ctx, profile, lists, options, showProgress);
+        }
+    } else {
+        file.seek(0);
+        ReadContext ctx(file);
+        result = profileRead(ctx, profile, lists, options, showProgress);
+    }
 
     file.close();
 
@@ -1482,6 +1737,61 @@ static bool isProfile0Dirty() {
     return false;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+
+bool runRecallBenchmark(int location, int numIterations, RecallBenchmarkResult &result, int *err) {
+    if (location < 0 || location >= NUM_PROFILE_LOCATIONS - 1) {
+        if (err) {
+            *err = SCPI_ERROR_DATA_OUT_OF_RANGE;
+        }
+        return false;
+    }
+
+    char filePath[MAX_PATH_LENGTH];
+    getProfileFilePath(location, filePath);
+
+    File file;
+    if (!file.open(filePath, FILE_OPEN_EXISTING | FILE_READ)) {
+        if (err) {
+            *err = SCPI_ERROR_FILE_NOT_FOUND;
+        }
+        return false;
+    }
+    BinaryProfileHeader header;
+    result.binary = readBinaryProfileHeader(file, header) && header.layoutId == getBinaryProfileLayoutId();
+    file.close();
+
+    static const int options[] = { 0, LOAD_PROFILE_FROM_FILE_OPTION_ONLY_TEXT };
+    float *loadTimes[] = { &result.binaryLoadTimeMs, &result.textLoadTimeMs };
+
+    Parameters profile;
+
+    for (int i = 0; i < 2; i++) {
+        uint32_t start = micros();
+
+        for (int j = 0; j < numIterations; j++) {
+            resetProfileToDefaults(profile);
+            if (!loadProfileFromFile(filePath, profile, g_listsProfile0, options[i], false, err)) {
+                return false;
+            }
+        }
+
+        *loadTimes[i] = (micros() - start) / 1000.0f / numIterations;
+    }
+
+    uint32_t start = micros();
+    if (!recallFromLocation(location, 0, false, err)) {
+        return false;
+    }
+    result.recallTimeMs = (micros() - start) / 1000.0f;
+
+    return true;
+}
+
+#endif
+
 } // namespace profile
 } // namespace psu
 } // namespace eez
@@ -120,6 +120,18 @@ void setFreezeState(bool value);
 
 void loadProfileParametersToCache(int location);
 
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+struct RecallBenchmarkResult {
+    bool binary; // false if location is still in text format
+    float binaryLoadTimeMs;
+    float textLoadTimeMs;
+    float recallTimeMs; // *RCL, i.e. load from file and apply to the instrument
+};
+
+// Loads profile from location numIterations times in each format, then recalls it once.
+bool runRecallBenchmark(int location, int numIterations, RecallBenchmarkResult &result, int *err);
+#endif
+
 class WriteContext {
 public:
     WriteContext(File &file_);
@@ -37,6 +37,7 @@
 #include <eez/modules/psu/ethernet.h>
 #include <eez/modules/psu/ntp.h>
 #endif
+#include <eez/modules/psu/adc_replay.h>
 #include <eez/modules/psu/board.h>
 #include <eez/modules/psu/datetime.h>
 #include <eez/modules/psu/persist_conf.h>
@@ -178,6 +179,8 @@ extern "C" void PSU_IncTick() {
     if (ramp::isActive() || eez::dcp405::isDacRampActive()) {
         sendMessageToPsu(PSU_MESSAGE_TICK, 0, 0);
     }
+
+    list::postHardwareTimedStepIfDue();
 }
 
 #endif
@@ -313,6 +316,8 @@ void PsuModule::resetPowerChannelProfileToDefaults(int channelIndex, uint8_t *bu
 
     parameters->u_rampDuration = RAMP_DURATION_DEF_VALUE_U;
     parameters->i_rampDuration = RAMP_DURATION_DEF_VALUE_I;
+    parameters->u_rampShape = ramp::RAMP_SHAPE_LINEAR;
+    parameters->i_rampShape = ramp::RAMP_SHAPE_LINEAR;
 
     parameters->outputDelayDuration = 0;
     
@@ -382,6 +387,8 @@ void PsuModule::getPowerChannelProfileParameters(int channelIndex, uint8_t *buff
 
     parameters->u_rampDuration = channel.u.rampDuration;
     parameters->i_rampDuration = channel.i.rampDuration;
+    parameters->u_rampShape = channel.u.rampShape;
+    parameters->i_rampShape = channel.i.rampShape;
 
     parameters->outputDelayDuration = channel.outputDelayDuration;
 
@@ -464,11 +471,15 @@ void PsuModule::setPowerChannelProfileParameters(int channelIndex, uint8_t *buff
         channel.u.rampDuration = channel.params.U_RAMP_DURATION_MIN_VALUE;
     }
     channel.i.rampDuration = parameters->i_rampDuration;
+    channel.u.rampShape = parameters->u_rampShape;
+    channel.i.rampShape = parameters->i_rampShape;
 
     channel.outputDelayDuration = parameters->outputDelayDuration;
 
     strcpy(channel.label, parameters->label);
     channel.color = parameters->color;
+
+    Channel::updateAllProtectionThresholds();
 }
 
 bool PsuModule::writePowerChannelProfileProperties(profile::WriteContext &ctx, const uint8_t *buffer) {
@@ -511,6 +522,8 @@ bool PsuModule::writePowerChannelProfileProperties(profile::WriteContext &ctx, c
 
     WRITE_PROPERTY("u_rampDuration", parameters->u_rampDuration);
     WRITE_PROPERTY("i_rampDuration", parameters->i_rampDuration);
+    WRITE_PROPERTY("u_rampShape", parameters->u_rampShape);
+    WRITE_PROPERTY("i_rampShape", parameters->i_rampShape);
 
     WRITE_PROPERTY("outputDelayDuration", parameters->outputDelayDuration);
 
@@ -566,6 +579,8 @@ bool PsuModule::readPowerChannelProfileProperties(profile::ReadContext &ctx, uin
 
     READ_PROPERTY("u_rampDuration", parameters->u_rampDuration);
     READ_PROPERTY("i_rampDuration", parameters->i_rampDuration);
+    READ_PROPERTY("u_rampShape", parameters->u_rampShape);
+    READ_PROPERTY("i_rampShape", parameters->i_rampShape);
 
     READ_PROPERTY("outputDelayDuration", parameters->outputDelayDuration);
 
@@ -743,6 +758,8 @@ void onThreadMessage(uint8_t type, uint32_t param) {
         channel_dispatcher::setVoltageInPsuThread((int)param);
     } else if (type == PSU_MESSAGE_SET_CURRENT) {
         channel_dispatcher::setCurrentInPsuThread((int)param);
+    } else if (type == PSU_MESSAGE_SET_VOLTAGE_AND_CURRENT) {
+        channel_dispatcher::setVoltageAndCurrentInPsuThread((int)param);
     } else if (type == PSU_MESSAGE_FLASH_SLAVE_START) {
         bp3c::flash_slave::doStart();
     } else if (type == PSU_MESSAGE_FLASH_SLAVE_LEAVE_BOOTLOADER_MODE) {
@@ -768,6 +785,26 @@ void onThreadMessage(uint8_t type, uint32_t param) {
         channel.setDprogState((DprogState)(param & 0xFF));
     } else if (type == PSU_MESSAGE_SAVE_SERIAL_NO) {
         persist_conf::saveSerialNo(param);
+    } else if (type == PSU_MESSAGE_IO_PIN_EDGE) {
+        io_pins::onInputPinEdge(param);
+    } else if (type == PSU_MESSAGE_LIST_STEP) {
+        list::onHardwareTimedStep();
+    } else if (type == PSU_MESSAGE_TEMPERATURE_PROTECTION_ENTER) {
+        temperature::TempSensorTemperature::protection_enter(temperature::sensors[param]);
+#if OPTION_FAN
+    } else if (type == PSU_MESSAGE_FAN_TICK) {
+        aux_ps::fan::tick(param);
+    } else if (type == PSU_MESSAGE_READ_AUX_TEMPERATURE) {
+        aux_ps::fan::readTemperature();
+#endif
+    } else if (type == PSU_MESSAGE_LIMIT_MAX_CURRENT) {
+        int channelIndex = param >> 8;
+        MaxCurrentLimitCause cause = (MaxCurrentLimitCause)(param & 0xFF);
+        if (channelIndex == 0xFF) {
+            limitMaxCurrent(cause);
+        } else {
+            Channel::get(channelIndex).limitMaxCurrent(cause);
+        }
     } else if (calibration::onHighPriorityThreadMessage(type, param)) {
         // handled
     } else if (type >= PSU_MESSAGE_MODULE_SPECIFIC) {
@@ -1191,24 +1228,84 @@ void onProtectionTripped() {
 ////////////////////////////////////////////////////////////////////////////////
 
 typedef void (*TickFunc)(uint32_t tickCount);
+// temperature and fan control are not here, they have their own task (see temperature::startThread)
 static TickFunc g_tickFuncs[] = {
-    temperature::tick,
-#if OPTION_FAN
-    aux_ps::fan::tick,
-#endif
     datetime::tick
 };
 static const int NUM_TICK_FUNCS = sizeof(g_tickFuncs) / sizeof(TickFunc);
 static int g_tickFuncIndex = 0;
 
+static struct {
+    uint32_t lastTickCount;
+    uint32_t numTicks;
+    uint32_t minIntervalUsec;
+    uint32_t maxIntervalUsec;
+    uint64_t sumIntervalUsec;
+    uint32_t maxDurationUsec;
+} g_tickStatistics;
+
+static volatile bool g_resetTickStatistics = true;
+
+static void updateTickStatistics(uint32_t tickStart) {
+    uint32_t duration = micros() - tickStart;
+
+    if (g_resetTickStatistics) {
+        g_resetTickStatistics = false;
+        g_tickStatistics.numTicks = 0;
+        g_tickStatistics.minIntervalUsec = 0xFFFFFFFF;
+        g_tickStatistics.maxIntervalUsec = 0;
+        g_tickStatistics.sumIntervalUsec = 0;
+        g_tickStatistics.maxDurationUsec = 0;
+    } else {
+        uint32_t interval = tickStart - g_tickStatistics.lastTickCount;
+
+        g_tickStatistics.numTicks++;
+        if (interval < g_tickStatistics.minIntervalUsec) {
+            g_tickStatistics.minIntervalUsec = interval;
+        }
+        if (interval > g_tickStatistics.maxIntervalUsec) {
+            g_tickStatistics.maxIntervalUsec = interval;
+        }
+        g_tickStatistics.sumIntervalUsec += interval;
+        if (duration > g_tickStatistics.maxDurationUsec) {
+            g_tickStatistics.maxDurationUsec = duration;
+        }
+    }
+
+    g_tickStatistics.lastTickCount = tickStart;
+}
+
+void getTickStatistics(TickStatistics &statistics) {
+    statistics.numTicks = g_tickStatistics.numTicks;
+    if (statistics.numTicks > 0) {
+        statistics.minIntervalUsec = g_tickStatistics.minIntervalUsec;
+        statistics.avgIntervalUsec = (uint32_t)(g_tickStatistics.sumIntervalUsec / statistics.numTicks);
+        statistics.maxIntervalUsec = g_tickStatistics.maxIntervalUsec;
+        statistics.maxDurationUsec = g_tickStatistics.maxDurationUsec;
+    } else {
+        statistics.minIntervalUsec = 0;
+        statistics.avgIntervalUsec = 0;
+        statistics.maxIntervalUsec = 0;
+        statistics.maxDurationUsec = 0;
+    }
+
+    // statistics are reset in the PSU thread, on the next tick
+    g_resetTickStatistics = true;
+}
+
 void tick() {
-    uint32_t tickCount = micros();
+    uint32_t tickStart = micros();
+    uint32_t tickCount = tickStart;
 
     trigger::tick(tickCount);
     tickCount = micros();
     list::tick(tickCount);
     ramp::tick(tickCount);
 
+#if defined(EEZ_PLATFORM_SIMULATOR)
+    adc_replay::tick(tickCount);
+#endif
+
     for (int i = 0; i < CH_NUM; ++i) {
         Channel::get(i).tick(tickCount);
     }
@@ -1224,6 +1321,8 @@ void tick() {
         g_diagCallback();
         g_diagCallback = NULL;
     }
+
+    updateTickStatistics(tickStart);
 }
 
 ////////////////////////////////////////////////////////////////////////////////
@@ -1244,6 +1343,12 @@ bool isMaxCurrentLimited() {
 
 void limitMaxCurrent(MaxCurrentLimitCause cause) {
     if (g_maxCurrentLimitCause != cause) {
+        if (!isPsuThread()) {
+            // current limit is set through DAC, that must be done from the PSU thread
+            sendMessageToPsu(PSU_MESSAGE_LIMIT_MAX_CURRENT, (0xFF << 8) | cause);
+            return;
+        }
+
         g_maxCurrentLimitCause = cause;
 
         if (isMaxCurrentLimited()) {
@@ -138,6 +138,8 @@ struct PowerChannelProfileParameters {
     uint16_t listCount;
     float u_rampDuration;
     float i_rampDuration;
+    uint8_t u_rampShape;
+    uint8_t i_rampShape;
     float outputDelayDuration;
     char label[Channel::CHANNEL_LABEL_MAX_LENGTH + 1];
     uint8_t color;
@@ -173,6 +175,17 @@ void onProtectionTripped();
 
 void tick();
 
+/// PSU tick timing since the previous call to getTickStatistics.
+struct TickStatistics {
+    uint32_t numTicks;
+    uint32_t minIntervalUsec;
+    uint32_t avgIntervalUsec;
+    uint32_t maxIntervalUsec;
+    uint32_t maxDurationUsec;
+};
+
+void getTickStatistics(TickStatistics &statistics);
+
 void setQuesBits(int bit_mask, bool on);
 void setOperBits(int bit_mask, bool on);
 
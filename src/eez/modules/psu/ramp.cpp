@@ -29,14 +29,34 @@ namespace eez {
 namespace psu {
 namespace ramp {
 
+// Time is kept in 64-bit microseconds (extended from 32-bit micros()), so ramp timing
+// doesn't lose resolution with uptime and survives micros() wrap around.
+// DAC is updated only when ramp value has moved by one resolution step,
+// time of the next update is calculated from the inverse of the ramp shape.
+
+static const float EXPONENTIAL_SHAPE_RATE = 5.0f; // number of time constants within ramp duration
+
+struct RampValue {
+    float target;
+    float resolution;
+    uint8_t shape;
+    uint64_t durationUsec;
+    uint64_t nextUpdateUsec; // relative to the ramp start
+    bool done;
+};
+
 static struct {
     int state;
-    float startTime;
-    float currentTime;
-    bool voltageRampDone;
-    bool currentRampDone;
+    uint64_t startTime;
+    uint64_t currentTime;
+    uint64_t delayUsec;
+    RampValue u;
+    RampValue i;
 } g_execution[CH_MAX];
 
+static uint64_t g_tickUsec;
+static uint32_t g_lastTickUsec;
+
 int g_numChannelsWithVisibleCounters;
 int g_channelsWithVisibleCounters[CH_MAX];
 
@@ -44,73 +64,136 @@ static bool g_active;
 
 static void setActive(bool active, bool forceUpdate = false);
 
-void executionStart(Channel &channel) {
-    g_execution[channel.channelIndex].state = 1;
+static uint64_t secondsToUsec(float seconds) {
+    return (uint64_t)roundf(seconds * 1000000.0f);
+}
 
-    if (channel.outputDelayDuration < OUTPUT_DELAY_DURATION_MIN_VALUE && channel.u.rampDuration < channel.params.U_RAMP_DURATION_MIN_VALUE) {
-        channel_dispatcher::setVoltage(channel, channel.u.triggerLevel);
-        g_execution[channel.channelIndex].voltageRampDone = true;
-    } else {
-        channel_dispatcher::setVoltage(channel, 0);
-        g_execution[channel.channelIndex].voltageRampDone = false;
+static float getShapeValue(uint8_t shape, float x) {
+    if (shape == RAMP_SHAPE_EXPONENTIAL) {
+        return (1.0f - expf(-EXPONENTIAL_SHAPE_RATE * x)) / (1.0f - expf(-EXPONENTIAL_SHAPE_RATE));
+    }
+    if (shape == RAMP_SHAPE_S_CURVE) {
+        return (1.0f - cosf((float)M_PI * x)) / 2.0f;
+    }
+    return x;
+}
+
+static float getShapeInverse(uint8_t shape, float y) {
+    if (shape == RAMP_SHAPE_EXPONENTIAL) {
+        return -logf(1.0f - y * (1.0f - expf(-EXPONENTIAL_SHAPE_RATE))) / EXPONENTIAL_SHAPE_RATE;
+    }
+    if (shape == RAMP_SHAPE_S_CURVE) {
+        return acosf(1.0f - 2.0f * y) / (float)M_PI;
+    }
+    return y;
+}
+
+static void initRampValue(RampValue &ramp, float target, float resolution, uint8_t shape, float duration, bool done) {
+    ramp.target = target;
+    ramp.resolution = resolution;
+    ramp.shape = shape;
+    ramp.durationUsec = secondsToUsec(duration);
+    ramp.nextUpdateUsec = 0;
+    ramp.done = done;
+}
+
+// Returns true if value should be set.
+static bool tickRampValue(RampValue &ramp, uint64_t elapsedUsec, float &value) {
+    if (ramp.done) {
+        return false;
     }
 
-    if (channel.outputDelayDuration < OUTPUT_DELAY_DURATION_MIN_VALUE && channel.i.rampDuration < RAMP_DURATION_MIN_VALUE) {
-        channel_dispatcher::setCurrent(channel, channel.i.triggerLevel);
-        g_execution[channel.channelIndex].currentRampDone = true;
+    if (elapsedUsec >= ramp.durationUsec) {
+        value = ramp.target;
+        ramp.done = true;
+        return true;
+    }
+
+    if (elapsedUsec < ramp.nextUpdateUsec) {
+        return false;
+    }
+
+    float y = getShapeValue(ramp.shape, (float)elapsedUsec / ramp.durationUsec);
+    value = ramp.target * y;
+
+    // schedule next update for when value moves by one resolution step
+    float yNext = ramp.target > 0 ? y + ramp.resolution / ramp.target : 1.0f;
+    if (yNext < 1.0f) {
+        uint64_t nextUpdateUsec = (uint64_t)(getShapeInverse(ramp.shape, yNext) * ramp.durationUsec);
+        ramp.nextUpdateUsec = MAX(nextUpdateUsec, elapsedUsec + 1);
     } else {
-        channel_dispatcher::setCurrent(channel, 0);
-        g_execution[channel.channelIndex].currentRampDone = false;
+        ramp.nextUpdateUsec = ramp.durationUsec;
     }
 
+    return true;
+}
+
+void executionStart(Channel &channel) {
+    auto &execution = g_execution[channel.channelIndex];
+
+    execution.state = 1;
+
+    bool voltageRampDone = channel.outputDelayDuration < OUTPUT_DELAY_DURATION_MIN_VALUE && channel.u.rampDuration < channel.params.U_RAMP_DURATION_MIN_VALUE;
+    channel_dispatcher::setVoltage(channel, voltageRampDone ? channel.u.triggerLevel : 0);
+    initRampValue(execution.u, channel.u.triggerLevel, channel.getVoltageResolution(), channel.u.rampShape, channel.u.rampDuration, voltageRampDone);
+
+    bool currentRampDone = channel.outputDelayDuration < OUTPUT_DELAY_DURATION_MIN_VALUE && channel.i.rampDuration < RAMP_DURATION_MIN_VALUE;
+    channel_dispatcher::setCurrent(channel, currentRampDone ? channel.i.triggerLevel : 0);
+    initRampValue(execution.i, channel.i.triggerLevel, channel.getCurrentResolution(channel.i.triggerLevel), channel.i.rampShape, channel.i.rampDuration, currentRampDone);
+
+    execution.delayUsec = secondsToUsec(channel.outputDelayDuration);
+
     setActive(true, true);
 }
 
 void tick(uint32_t tickUsec) {
-    bool active = false;
+    // extend to 64-bit, works across micros() wrap around
+    g_tickUsec += (uint32_t)(tickUsec - g_lastTickUsec);
+    g_lastTickUsec = tickUsec;
 
-    float tick = tickUsec / 1000000.0f;
+    if (!g_active) {
+        return;
+    }
+
+    bool active = false;
 
     for (int i = 0; i < CH_NUM; i++) {
-        if (g_execution[i].state) {
+        auto &execution = g_execution[i];
+        if (execution.state) {
             auto &channel = Channel::get(i);
             if (channel.isOutputEnabled()) {
-                g_execution[i].currentTime = tick;
+                execution.currentTime = g_tickUsec;
 
-                if (g_execution[i].state == 1) {
-                    g_execution[i].startTime = tick;
-                    g_execution[i].state = 2;
+                if (execution.state == 1) {
+                    execution.startTime = g_tickUsec;
+                    execution.state = 2;
                 }
 
-                if (g_execution[i].state == 2) {
-                    if (tick >= g_execution[i].startTime + channel.outputDelayDuration) {
-                        g_execution[i].state = 3;
+                if (execution.state == 2) {
+                    if (g_tickUsec - execution.startTime >= execution.delayUsec) {
+                        execution.state = 3;
                     }
                 }
 
-                if (g_execution[i].state == 3) {
-                    if (tick < g_execution[i].startTime + channel.outputDelayDuration + channel.u.rampDuration) {
-                        channel_dispatcher::setVoltage(channel, channel.u.triggerLevel * (tick - g_execution[i].startTime - channel.outputDelayDuration) / channel.u.rampDuration);
-                    } else if (!g_execution[i].voltageRampDone) {
-                        channel_dispatcher::setVoltage(channel, channel.u.triggerLevel);
-                        g_execution[i].voltageRampDone = true;
-                    }
+                if (execution.state == 3) {
+                    uint64_t elapsedUsec = g_tickUsec - execution.startTime - execution.delayUsec;
 
-                    if (tick < g_execution[i].startTime + channel.outputDelayDuration + channel.i.rampDuration) {
-                        channel_dispatcher::setCurrent(channel, channel.i.triggerLevel * (tick - g_execution[i].startTime - channel.outputDelayDuration) / channel.i.rampDuration);
-                    } else if (!g_execution[i].currentRampDone) {
-                        channel_dispatcher::setCurrent(channel, channel.i.triggerLevel);
-                        g_execution[i].currentRampDone = true;
+                    float value;
+                    if (tickRampValue(execution.u, elapsedUsec, value)) {
+                        channel_dispatcher::setVoltage(channel, value);
+                    }
+                    if (tickRampValue(execution.i, elapsedUsec, value)) {
+                        channel_dispatcher::setCurrent(channel, value);
                     }
-                    
-                    if (g_execution[i].voltageRampDone && g_execution[i].currentRampDone) {
+
+                    if (execution.u.done && execution.i.done) {
                         trigger::setTriggerFinished(channel);
-                        g_execution[i].state = 0;
+                        execution.state = 0;
                     }
                 }
             }
 
-            if (g_execution[i].state) {
+            if (execution.state) {
                 active = true;
             }
         }
@@ -141,15 +224,15 @@ void abort() {
 
 void getCountdownTime(int channelIndex, uint32_t &remaining, uint32_t &total) {
     if (g_execution[channelIndex].state) {
-        auto &channel = Channel::get(channelIndex);
-        float duration = channel.outputDelayDuration + MAX(channel.u.rampDuration, channel.i.rampDuration);
-        total = (uint32_t)roundf(duration);
-        if (g_execution[channelIndex].state == 1) {
+        auto &execution = g_execution[channelIndex];
+        uint64_t durationUsec = execution.delayUsec + MAX(execution.u.durationUsec, execution.i.durationUsec);
+        total = (uint32_t)((durationUsec + 500000) / 1000000);
+        if (execution.state == 1) {
             remaining = total;
         } else {
-            int32_t aux = (int32_t)roundf(g_execution[channelIndex].startTime + duration - g_execution[channelIndex].currentTime);
-            if (aux > 0) {
-                remaining = aux;
+            uint64_t elapsedUsec = execution.currentTime - execution.startTime;
+            if (elapsedUsec < durationUsec) {
+                remaining = (uint32_t)((durationUsec - elapsedUsec + 500000) / 1000000);
             } else {
                 remaining = 0;
             }
@@ -183,6 +266,49 @@ static void setActive(bool active, bool forceUpdate) {
     }
 }
 
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+
+static const uint32_t SHAPE_TEST_TICK_USEC = 100;
+// simulated ramp is repeated, so time per tick can be measured with micros()
+static const int SHAPE_TEST_NUM_REPEATS = 10;
+
+void runShapeTest(float target, float resolution, float duration, ShapeTestResult *results) {
+    for (int shape = 0; shape < NUM_RAMP_SHAPES; shape++) {
+        auto &result = results[shape];
+
+        uint32_t numTicks = 0;
+        uint32_t start = micros();
+
+        for (int i = 0; i < SHAPE_TEST_NUM_REPEATS; i++) {
+            RampValue ramp;
+            initRampValue(ramp, target, resolution, shape, duration, false);
+
+            result.firstValue = NAN;
+            result.lastValue = NAN;
+            result.monotonic = true;
+            result.numUpdates = 0;
+
+            for (uint64_t elapsedUsec = 0; !ramp.done; elapsedUsec += SHAPE_TEST_TICK_USEC) {
+                float value;
+                if (tickRampValue(ramp, elapsedUsec, value)) {
+                    if (result.numUpdates == 0) {
+                        result.firstValue = value;
+                    } else if (value < result.lastValue) {
+                        result.monotonic = false;
+                    }
+                    result.lastValue = value;
+                    result.numUpdates++;
+                }
+                numTicks++;
+            }
+        }
+
+        result.usecPerTick = 1.0f * (micros() - start) / numTicks;
+    }
+}
+
+#endif
+
 }
 }
 } // namespace eez::psu::ramp
@@ -22,6 +22,12 @@ namespace eez {
 namespace psu {
 namespace ramp {
 
+enum RampShape {
+    RAMP_SHAPE_LINEAR,
+    RAMP_SHAPE_EXPONENTIAL, // fast at the start, then approaches the level
+    RAMP_SHAPE_S_CURVE // slow at the start and at the end (half cosine)
+};
+
 void executionStart(Channel &channel);
 void tick(uint32_t tickUsec);
 
@@ -34,6 +40,21 @@ extern int g_numChannelsWithVisibleCounters;
 extern int g_channelsWithVisibleCounters[CH_MAX];
 void getCountdownTime(int channelIndex, uint32_t &remaining, uint32_t &total);
 
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+static const int NUM_RAMP_SHAPES = RAMP_SHAPE_S_CURVE + 1;
+
+struct ShapeTestResult {
+    float firstValue;
+    float lastValue;
+    bool monotonic; // value never went backwards
+    uint32_t numUpdates; // number of times value was set during the ramp
+    float usecPerTick;
+};
+
+// Runs ramp value scheduling for each shape on a simulated time line, channel is not touched.
+void runShapeTest(float target, float resolution, float duration, ShapeTestResult *results);
+#endif
+
 }
 }
 } // namespace eez::psu::ramp
\ No newline at end of file
@@ -31,16 +31,25 @@
 #endif
 
 #include <eez/modules/psu/psu.h>
+#include <eez/modules/psu/channel_dispatcher.h>
+#include <eez/modules/psu/dlog_export.h>
+#include <eez/modules/psu/dlog_view.h>
 #include <eez/modules/psu/serial_psu.h>
 #include <eez/modules/psu/temperature.h>
 #include <eez/modules/psu/ontime.h>
 #include <eez/modules/psu/scpi/psu.h>
 #include <eez/modules/psu/event_queue.h>
+#include <eez/modules/psu/profile.h>
+#include <eez/modules/psu/ramp.h>
 #if OPTION_DISPLAY
 #include <eez/modules/psu/gui/psu.h>
 #endif
 
 #include <eez/modules/mcu/eeprom.h>
+#if OPTION_DISPLAY
+#include <eez/modules/mcu/display.h>
+#include <eez/modules/mcu/text_cache.h>
+#endif
 
 #include <eez/modules/bp3c/flash_slave.h>
 #include <eez/modules/bp3c/io_exp.h>
@@ -504,7 +513,15 @@ scpi_result_t scpi_cmd_debugDownloadFirmware(scpi_t *context) {
         return SCPI_RES_ERR;
     }
 
-    bp3c::flash_slave::start(slotIndex - 1, hexFilePath);
+    bool skipIfIdentical;
+    if (!SCPI_ParamBool(context, &skipIfIdentical, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        skipIfIdentical = false;
+    }
+
+    bp3c::flash_slave::start(slotIndex - 1, hexFilePath, skipIfIdentical);
 
     return SCPI_RES_OK;
 #else
@@ -524,6 +541,389 @@ scpi_result_t scpi_cmd_debugEvent(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_debugDisplayBenchmarkQ(scpi_t *context) {
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR) && OPTION_DISPLAY
+    int32_t numFrames;
+    if (!SCPI_ParamInt32(context, &numFrames, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        numFrames = 100;
+    }
+
+    if (numFrames < 1 || numFrames > 10000) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    mcu::display::RenderBenchmarkResult results[4];
+    int numResults = mcu::display::runRenderBenchmark(numFrames, results, 4);
+    if (numResults == 0) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    char buffer[256] = { 0 };
+    char *p = buffer;
+
+    for (int i = 0; i < numResults; ++i) {
+        sprintf(p, "%s: %.1f fps\n", results[i].name, results[i].fps);
+        p += strlen(p);
+    }
+
+    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_debugDisplayTextCacheQ(scpi_t *context) {
+#if defined(DEBUG) && OPTION_DISPLAY
+    using namespace mcu::display::text_cache;
+
+    char buffer[256] = { 0 };
+
+    sprintf(buffer,
+        "Run hits: %u\n"
+        "Run misses: %u\n"
+        "Run evictions: %u\n"
+        "Width hits: %u\n"
+        "Width misses: %u\n",
+        (unsigned)g_statistics.runHits,
+        (unsigned)g_statistics.runMisses,
+        (unsigned)g_statistics.runEvictions,
+        (unsigned)g_statistics.widthHits,
+        (unsigned)g_statistics.widthMisses);
+
+    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_debugFpgaJtagTestQ(scpi_t *context) {
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+    fpga::JtagTestResult results[3];
+    int numResults = fpga::testJtag(results, 3);
+
+    char buffer[256] = { 0 };
+    char *p = buffer;
+
+    for (int i = 0; i < numResults; ++i) {
+        sprintf(p, "%s: %s, %.1f KB/s\n", results[i].name, results[i].passed ? "OK" : "FAILED", results[i].kbPerSecond);
+        p += strlen(p);
+    }
+
+    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_debugDispatcherBenchmarkQ(scpi_t *context) {
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+    int32_t numIterations;
+    if (!SCPI_ParamInt32(context, &numIterations, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        numIterations = 10000;
+    }
+
+    if (numIterations < 1 || numIterations > 1000000) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    channel_dispatcher::BenchmarkResult result;
+    int err;
+    if (!channel_dispatcher::runBenchmark(numIterations, result, &err)) {
+        SCPI_ErrorPush(context, err);
+        return SCPI_RES_ERR;
+    }
+
+    char buffer[256] = { 0 };
+
+    sprintf(buffer,
+        "Get uncoupled: %.0f calls/s\n"
+        "Get series: %.0f calls/s\n"
+        "Get parallel: %.0f calls/s\n"
+        "Set U and I: %.0f calls/s\n"
+        "Set U and I batch: %.0f calls/s\n",
+        result.getCallsPerSecond[0],
+        result.getCallsPerSecond[1],
+        result.getCallsPerSecond[2],
+        result.setCallsPerSecond,
+        result.setBatchCallsPerSecond);
+
+    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_debugProfileBenchmarkQ(scpi_t *context) {
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+    int location;
+    if (!get_profile_location_param(context, location, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    int32_t numIterations;
+    if (!SCPI_ParamInt32(context, &numIterations, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        numIterations = 10;
+    }
+
+    if (numIterations < 1 || numIterations > 1000) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    profile::RecallBenchmarkResult result;
+    int err;
+    if (!profile::runRecallBenchmark(location, numIterations, result, &err)) {
+        SCPI_ErrorPush(context, err);
+        return SCPI_RES_ERR;
+    }
+
+    char buffer[256] = { 0 };
+
+    sprintf(buffer,
+        "Format: %s\n"
+        "Binary load: %.3f ms\n"
+        "Text load: %.3f ms\n"
+        "Recall: %.3f ms\n",
+        result.binary ? "binary" : "text",
+        result.binaryLoadTimeMs,
+        result.textLoadTimeMs,
+        result.recallTimeMs);
+
+    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_debugDlogExportBenchmarkQ(scpi_t *context) {
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+    int32_t sizeMB;
+    if (!SCPI_ParamInt32(context, &sizeMB, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        sizeMB = 200;
+    }
+
+    if (sizeMB < 1 || sizeMB > 2000) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    int32_t decimation;
+    if (!SCPI_ParamInt32(context, &decimation, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        decimation = 1;
+    }
+
+    if (decimation < 1) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    dlog_export::BenchmarkResult result;
+    int err;
+    if (!dlog_export::runBenchmark(sizeMB, decimation, result, &err)) {
+        SCPI_ErrorPush(context, err);
+        return SCPI_RES_ERR;
+    }
+
+    char buffer[256] = { 0 };
+
+    sprintf(buffer,
+        "Rows: %u\n"
+        "DLOG size: %u bytes\n"
+        "CSV size: %u bytes\n"
+        "Generate: %u ms\n"
+        "Export: %u ms (%.2f MB/s)\n",
+        (unsigned)result.numRows,
+        (unsigned)result.dlogFileSize,
+        (unsigned)result.csvFileSize,
+        (unsigned)result.generateTimeMs,
+        (unsigned)result.exportTimeMs,
+        result.exportTimeMs > 0 ? result.dlogFileSize / (1024.0 * 1024.0) / (result.exportTimeMs / 1000.0) : 0.0);
+
+    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_debugDlogViewCacheQ(scpi_t *context) {
+#if defined(DEBUG) && OPTION_DISPLAY
+    using dlog_view::g_cacheStatistics;
+
+    uint32_t numValues = g_cacheStatistics.valueHits + g_cacheStatistics.valueMisses;
+
+    char buffer[256] = { 0 };
+
+    sprintf(buffer,
+        "Value hits: %u\n"
+        "Value misses: %u\n"
+        "Hit rate: %.1f%%\n"
+        "Demand loads: %u\n"
+        "Prefetch loads: %u\n"
+        "Prefetch hits: %u\n",
+        (unsigned)g_cacheStatistics.valueHits,
+        (unsigned)g_cacheStatistics.valueMisses,
+        numValues > 0 ? 100.0 * g_cacheStatistics.valueHits / numValues : 0.0,
+        (unsigned)g_cacheStatistics.demandLoads,
+        (unsigned)g_cacheStatistics.prefetchLoads,
+        (unsigned)g_cacheStatistics.prefetchHits);
+
+    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_debugDlogViewCacheReset(scpi_t *context) {
+#if defined(DEBUG) && OPTION_DISPLAY
+    dlog_view::resetCacheStatistics();
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_debugDisplayTextCacheReset(scpi_t *context) {
+#if defined(DEBUG) && OPTION_DISPLAY
+    mcu::display::text_cache::resetStatistics();
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_debugSerialBenchmarkQ(scpi_t *context) {
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+    int32_t size;
+    if (!SCPI_ParamInt32(context, &size, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        size = 1024;
+    }
+
+    // size of the script in KB
+    if (size < 1 || size > 65536) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    serial::InputBenchmarkResult result;
+    serial::runInputBenchmark(size * 1024, result);
+
+    char buffer[256] = { 0 };
+
+    sprintf(buffer,
+        "Bytes: %u\n"
+        "Commands: %u\n"
+        "Errors: %u\n"
+        "Duration: %.3f ms\n"
+        "Throughput: %.0f bytes/s\n",
+        (unsigned)result.numBytes,
+        (unsigned)result.numCommands,
+        (unsigned)result.numErrors,
+        result.durationMs,
+        result.bytesPerSecond);
+
+    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_debugRampShapeTestQ(scpi_t *context) {
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+    Channel *channel = getSelectedPowerChannel(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    float duration = 1.0f;
+    scpi_number_t param;
+    if (SCPI_ParamNumber(context, scpi_special_numbers_def, &param, false)) {
+        if (!get_duration_from_param(context, param, duration, RAMP_DURATION_MIN_VALUE, RAMP_DURATION_MAX_VALUE, 1.0f)) {
+            return SCPI_RES_ERR;
+        }
+    } else {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+    }
+
+    // full scale voltage ramp of the selected channel
+    float target = channel->params.U_MAX;
+    ramp::ShapeTestResult results[ramp::NUM_RAMP_SHAPES];
+    ramp::runShapeTest(target, channel->getVoltageResolution(), duration, results);
+
+    static const char *SHAPE_NAMES[ramp::NUM_RAMP_SHAPES] = { "Linear", "Exponential", "S-curve" };
+
+    char buffer[512] = { 0 };
+    for (int shape = 0; shape < ramp::NUM_RAMP_SHAPES; shape++) {
+        auto &result = results[shape];
+        bool passed = result.firstValue == 0 && result.lastValue == target && result.monotonic;
+        sprintf(buffer + strlen(buffer),
+            "%s: %s, first %g V, last %g V, %s, %u updates, %.3f us/tick\n",
+            SHAPE_NAMES[shape],
+            passed ? "PASS" : "FAIL",
+            result.firstValue,
+            result.lastValue,
+            result.monotonic ? "monotonic" : "not monotonic",
+            (unsigned)result.numUpdates,
+            result.usecPerTick);
+    }
+
+    SCPI_ResultCharacters(context, buffer, strlen(buffer));
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
 } // namespace scpi
 } // namespace psu
 } // namespace eez
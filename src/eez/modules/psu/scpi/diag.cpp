@@ -139,6 +139,25 @@ scpi_result_t scpi_cmd_diagnosticInformationAdcQ(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_diagnosticInformationAdcStatisticsQ(scpi_t *context) {
+    Channel *channel = getPowerChannelFromParam(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    float samplesPerSecond;
+    float spiTransactionsPerSecond;
+    if (!channel->getAdcStatistics(samplesPerSecond, spiTransactionsPerSecond)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultFloat(context, samplesPerSecond);
+    SCPI_ResultFloat(context, spiTransactionsPerSecond);
+
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_diagnosticInformationCalibrationQ(scpi_t *context) {
     SlotAndSubchannelIndex slotAndSubchannelIndex;
     if (!getChannelFromParam(context, slotAndSubchannelIndex)) {
@@ -267,6 +286,19 @@ scpi_result_t scpi_cmd_diagnosticInformationProtectionQ(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_diagnosticInformationTickQ(scpi_t *context) {
+    TickStatistics statistics;
+    getTickStatistics(statistics);
+
+    SCPI_ResultUInt32(context, statistics.numTicks);
+    SCPI_ResultUInt32(context, statistics.minIntervalUsec);
+    SCPI_ResultUInt32(context, statistics.avgIntervalUsec);
+    SCPI_ResultUInt32(context, statistics.maxIntervalUsec);
+    SCPI_ResultUInt32(context, statistics.maxDurationUsec);
+
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_diagnosticInformationTestQ(scpi_t *context) {
     int32_t deviceId = -1;
     if (!SCPI_ParamChoice(context, devices::g_deviceChoice, &deviceId, false)) {
@@ -31,6 +31,7 @@
 #include <eez/modules/psu/dlog_view.h>
 
 #include <eez/libs/image/jpeg.h>
+#include <eez/libs/image/delta.h>
 
 namespace eez {
 namespace psu {
@@ -166,6 +167,23 @@ scpi_result_t scpi_cmd_displayWindowTextClear(scpi_t *context) {
 #endif
 }
 
+#if OPTION_DISPLAY
+static void resultImageData(scpi_t *context, unsigned char *imageData, size_t imageDataSize) {
+    SCPI_ResultArbitraryBlockHeader(context, imageDataSize);
+
+    static const size_t CHUNK_SIZE = 1024;
+
+    while (imageDataSize > 0) {
+        WATCHDOG_RESET(WATCHDOG_LONG_OPERATION);
+
+        size_t n = MIN(imageDataSize, CHUNK_SIZE);
+        SCPI_ResultArbitraryBlockData(context, imageData, n);
+        imageData += n;
+        imageDataSize -= n;
+    }
+}
+#endif
+
 scpi_result_t scpi_cmd_displayDataQ(scpi_t *context) {
 #if OPTION_DISPLAY
     const uint8_t *screenshotPixels = mcu::display::takeScreenshot();
@@ -178,19 +196,37 @@ scpi_result_t scpi_cmd_displayDataQ(scpi_t *context) {
     	return SCPI_RES_ERR;
     }
 
-    SCPI_ResultArbitraryBlockHeader(context, imageDataSize);
+    resultImageData(context, imageData, imageDataSize);
 
-    static const size_t CHUNK_SIZE = 1024;
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
 
-    while (imageDataSize > 0) {
-        WATCHDOG_RESET(WATCHDOG_LONG_OPERATION);
+scpi_result_t scpi_cmd_displayDataDeltaQ(scpi_t *context) {
+#if OPTION_DISPLAY
+    bool keyframe;
+    if (!SCPI_ParamBool(context, &keyframe, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        keyframe = false;
+    }
 
-        size_t n = MIN(imageDataSize, CHUNK_SIZE);
-        SCPI_ResultArbitraryBlockData(context, imageData, n);
-        imageData += n;
-        imageDataSize -= n;
+    const uint16_t *screenshotPixels = mcu::display::takeScreenshotRGB565();
+
+    unsigned char* imageData;
+    size_t imageDataSize;
+
+    if (deltaEncode(screenshotPixels, keyframe, &imageData, &imageDataSize)) {
+    	SCPI_ErrorPush(context, SCPI_ERROR_OUT_OF_MEMORY_FOR_REQ_OP);
+    	return SCPI_RES_ERR;
     }
 
+    resultImageData(context, imageData, imageDataSize);
+
     return SCPI_RES_OK;
 #else
     SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
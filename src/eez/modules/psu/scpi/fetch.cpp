@@ -0,0 +1,341 @@
+/*
+ * EEZ Modular Firmware
+ * Copyright (C) 2015-present, Envox d.o.o.
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation, either version 3 of the License, or
+ * (at your option) any later version.
+
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+
+ * You should have received a copy of the GNU General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+
+#include <math.h>
+#include <string.h>
+
+#include <eez/modules/psu/psu.h>
+
+#include <eez/system.h>
+
+#include <eez/modules/psu/dlog_record.h>
+#include <eez/modules/psu/ethernet.h>
+#include <eez/modules/psu/serial_psu.h>
+#include <eez/modules/psu/scpi/psu.h>
+
+namespace eez {
+namespace psu {
+namespace scpi {
+
+// Blocks returned by FETCh:HISTory? and FETCh:DLOG?, and pushed by the streams,
+// are little-endian:
+//
+//   uint32_t sequence    // history position or DLOG row index of the first record
+//   uint32_t numRecords
+//   float    period      // time between two records in seconds
+//   uint32_t numValues   // number of values in each record, timestamp not included
+//
+// followed by numRecords of:
+//
+//   float    timestamp   // (sequence + recordIndex) * period
+//   float    values[numValues]
+//
+// History values are uMin, uMax, uAvg, iMin, iMax, iAvg, pMin, pMax and pAvg. DLOG values are in the
+// order of Y axes, digital inputs are 0 or 1 and missing samples are NAN.
+// Pass sequence + numRecords to the next query to get only the new records.
+struct FetchBlockHeader {
+    uint32_t sequence;
+    uint32_t numRecords;
+    float period;
+    uint32_t numValues;
+};
+
+static const uint32_t HISTORY_NUM_VALUES = sizeof(ChannelHistory::Sample) / sizeof(float);
+
+static const size_t CHUNK_SIZE = 1024;
+
+// stream is not pushed more often than this
+static const uint32_t FETCH_STREAM_PERIOD_MS = 100;
+
+static scpi_choice_def_t historyLevelChoice[] = {
+    { "VIEW", ChannelHistory::LEVEL_VIEW },
+    { "SECond", ChannelHistory::LEVEL_SECONDS },
+    { "MINute", ChannelHistory::LEVEL_MINUTES },
+    { "HOUR", ChannelHistory::LEVEL_HOURS },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+////////////////////////////////////////////////////////////////////////////////
+
+static ChannelHistory::Level getHistoryLevel(ChannelHistory &channelHistory, int level) {
+    // VIEW is whatever is displayed in the YT view
+    if (level == ChannelHistory::LEVEL_VIEW) {
+        return channelHistory.getViewLevel();
+    }
+    return (ChannelHistory::Level)level;
+}
+
+static uint32_t getFirstRecord(uint32_t sequence, uint32_t firstAvailable, uint32_t end) {
+    // sequence after the end means history or recording is restarted in the meantime
+    if (sequence < firstAvailable || sequence > end) {
+        return firstAvailable;
+    }
+    return sequence;
+}
+
+static void resultBlockHeader(scpi_t *context, const FetchBlockHeader &header) {
+    SCPI_ResultArbitraryBlockHeader(context, sizeof(FetchBlockHeader) + header.numRecords * (1 + header.numValues) * sizeof(float));
+    SCPI_ResultArbitraryBlockData(context, &header, sizeof(FetchBlockHeader));
+}
+
+static uint32_t resultHistoryBlock(scpi_t *context, ChannelHistory &channelHistory, ChannelHistory::Level level, uint32_t sequence) {
+    uint32_t end = channelHistory.getPosition(level);
+
+    FetchBlockHeader header;
+    header.sequence = getFirstRecord(sequence, channelHistory.getFirstPosition(level), end);
+    header.numRecords = end - header.sequence;
+    header.period = channelHistory.getPeriod(level);
+    header.numValues = HISTORY_NUM_VALUES;
+
+    resultBlockHeader(context, header);
+
+    float chunk[CHUNK_SIZE / sizeof(float)];
+    static const uint32_t RECORDS_PER_CHUNK = sizeof(chunk) / ((1 + HISTORY_NUM_VALUES) * sizeof(float));
+
+    uint32_t position = header.sequence;
+    while (position < end) {
+        WATCHDOG_RESET(WATCHDOG_LONG_OPERATION);
+
+        float *p = chunk;
+        for (uint32_t i = 0; i < RECORDS_PER_CHUNK && position < end; i++, position++) {
+            *p++ = position * header.period;
+            memcpy(p, &channelHistory.getSample(level, position), sizeof(ChannelHistory::Sample));
+            p += HISTORY_NUM_VALUES;
+        }
+
+        SCPI_ResultArbitraryBlockData(context, chunk, (p - chunk) * sizeof(float));
+    }
+
+    return end;
+}
+
+static uint32_t resultDlogBlock(scpi_t *context, uint32_t sequence) {
+    uint32_t end = dlog_record::g_recording.size;
+
+    FetchBlockHeader header;
+    header.sequence = getFirstRecord(sequence, dlog_record::getFirstAvailableRow(), end);
+    header.numRecords = end - header.sequence;
+    header.period = dlog_record::g_recording.parameters.period;
+    header.numValues = dlog_record::g_recording.parameters.numYAxes;
+
+    resultBlockHeader(context, header);
+
+    float chunk[CHUNK_SIZE / sizeof(float)];
+    uint32_t recordsPerChunk = sizeof(chunk) / ((1 + header.numValues) * sizeof(float));
+
+    uint32_t rowIndex = header.sequence;
+    while (rowIndex < end) {
+        WATCHDOG_RESET(WATCHDOG_LONG_OPERATION);
+
+        float *p = chunk;
+        for (uint32_t i = 0; i < recordsPerChunk && rowIndex < end; i++, rowIndex++) {
+            *p++ = rowIndex * header.period;
+            if (!dlog_record::readRows(rowIndex, 1, p)) {
+                // row is overwritten while sending
+                for (uint32_t j = 0; j < header.numValues; j++) {
+                    p[j] = NAN;
+                }
+            }
+            p += header.numValues;
+        }
+
+        SCPI_ResultArbitraryBlockData(context, chunk, (p - chunk) * sizeof(float));
+    }
+
+    return end;
+}
+
+static void pushFetchStream(scpi_t &context) {
+    scpi_psu_t *psuContext = (scpi_psu_t *)context.user_context;
+    FetchStream &fetchStream = psuContext->fetchStream;
+
+    if (fetchStream.source == FETCH_STREAM_NONE || millis() - fetchStream.lastPushTime < FETCH_STREAM_PERIOD_MS) {
+        return;
+    }
+
+    fetchStream.lastPushTime = millis();
+
+    if (fetchStream.source == FETCH_STREAM_HISTORY) {
+        ChannelHistory *channelHistory = Channel::get(fetchStream.channelIndex).getHistory();
+        if (!channelHistory) {
+            return;
+        }
+
+        ChannelHistory::Level level = getHistoryLevel(*channelHistory, fetchStream.level);
+        if (channelHistory->getPosition(level) == fetchStream.sequence) {
+            return;
+        }
+
+        fetchStream.sequence = resultHistoryBlock(&context, *channelHistory, level, fetchStream.sequence);
+    } else {
+        if (dlog_record::g_recording.size == fetchStream.sequence) {
+            return;
+        }
+
+        fetchStream.sequence = resultDlogBlock(&context, fetchStream.sequence);
+    }
+
+    // pushed block is terminated the same way as the query response
+    context.interface->write(&context, SCPI_LINE_ENDING, strlen(SCPI_LINE_ENDING));
+    context.interface->flush(&context);
+    context.output_count = 0;
+}
+
+void fetchStreamTick() {
+    if (ethernet::isConnected()) {
+        pushFetchStream(ethernet::g_scpiContext);
+    }
+
+    if (serial::isConnected()) {
+        pushFetchStream(serial::g_scpiContext);
+    }
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
+scpi_result_t scpi_cmd_fetchHistoryQ(scpi_t *context) {
+    Channel *channel = getPowerChannelFromParam(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    ChannelHistory *channelHistory = channel->getHistory();
+    if (!channelHistory) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    int32_t level;
+    if (!SCPI_ParamChoice(context, historyLevelChoice, &level, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        level = ChannelHistory::LEVEL_VIEW;
+    }
+
+    uint32_t sequence;
+    if (!SCPI_ParamUInt32(context, &sequence, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        sequence = 0;
+    }
+
+    resultHistoryBlock(context, *channelHistory, getHistoryLevel(*channelHistory, level), sequence);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_fetchHistoryStream(scpi_t *context) {
+    scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
+    FetchStream &fetchStream = psuContext->fetchStream;
+
+    bool enable;
+    if (!SCPI_ParamBool(context, &enable, TRUE)) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!enable) {
+        if (fetchStream.source == FETCH_STREAM_HISTORY) {
+            fetchStream.source = FETCH_STREAM_NONE;
+        }
+        return SCPI_RES_OK;
+    }
+
+    Channel *channel = getPowerChannelFromParam(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    ChannelHistory *channelHistory = channel->getHistory();
+    if (!channelHistory) {
+        SCPI_ErrorPush(context, SCPI_ERROR_EXECUTION_ERROR);
+        return SCPI_RES_ERR;
+    }
+
+    int32_t level;
+    if (!SCPI_ParamChoice(context, historyLevelChoice, &level, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        level = ChannelHistory::LEVEL_VIEW;
+    }
+
+    // only the samples taken from now on are pushed
+    fetchStream.source = FETCH_STREAM_HISTORY;
+    fetchStream.channelIndex = channel->channelIndex;
+    fetchStream.level = level;
+    fetchStream.sequence = channelHistory->getPosition(getHistoryLevel(*channelHistory, level));
+    fetchStream.lastPushTime = millis();
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_fetchHistoryStreamQ(scpi_t *context) {
+    scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
+    SCPI_ResultBool(context, psuContext->fetchStream.source == FETCH_STREAM_HISTORY);
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_fetchDlogQ(scpi_t *context) {
+    uint32_t sequence;
+    if (!SCPI_ParamUInt32(context, &sequence, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        sequence = 0;
+    }
+
+    resultDlogBlock(context, sequence);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_fetchDlogStream(scpi_t *context) {
+    scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
+    FetchStream &fetchStream = psuContext->fetchStream;
+
+    bool enable;
+    if (!SCPI_ParamBool(context, &enable, TRUE)) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!enable) {
+        if (fetchStream.source == FETCH_STREAM_DLOG) {
+            fetchStream.source = FETCH_STREAM_NONE;
+        }
+        return SCPI_RES_OK;
+    }
+
+    // only the rows logged from now on are pushed, next recording is pushed from its first row
+    fetchStream.source = FETCH_STREAM_DLOG;
+    fetchStream.sequence = dlog_record::g_recording.size;
+    fetchStream.lastPushTime = millis();
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_fetchDlogStreamQ(scpi_t *context) {
+    scpi_psu_t *psuContext = (scpi_psu_t *)context->user_context;
+    SCPI_ResultBool(context, psuContext->fetchStream.source == FETCH_STREAM_DLOG);
+    return SCPI_RES_OK;
+}
+
+} // namespace scpi
+} // namespace psu
+} // namespace eez
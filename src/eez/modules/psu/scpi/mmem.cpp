@@ -22,6 +22,8 @@
 
 #include <eez/modules/psu/psu.h>
 
+#include <eez/modules/psu/dlog_export.h>
+#include <eez/modules/psu/dlog_view.h>
 #include <eez/modules/psu/event_queue.h>
 #include <eez/modules/psu/list_program.h>
 #include <eez/modules/psu/profile.h>
@@ -641,6 +643,72 @@ scpi_result_t scpi_cmd_mmemoryStoreProfile(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+scpi_result_t scpi_cmd_mmemoryExportCsv(scpi_t *context) {
+    if (persist_conf::isSdLocked()) {
+        SCPI_ErrorPush(context, SCPI_ERROR_MEDIA_PROTECTED);
+        return SCPI_RES_ERR;
+    }
+
+    char dlogFilePath[MAX_PATH_LENGTH + 1];
+    if (!getFilePath(context, dlogFilePath, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    char csvFilePath[MAX_PATH_LENGTH + 1];
+    if (!getFilePath(context, csvFilePath, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    int32_t decimation;
+    if (!SCPI_ParamInt32(context, &decimation, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        decimation = 1;
+    } else if (decimation < 1) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    uint32_t columns = 0;
+    int32_t column;
+    while (SCPI_ParamInt32(context, &column, false)) {
+        if (column < 1 || column > dlog_view::MAX_NUM_OF_Y_AXES) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return SCPI_RES_ERR;
+        }
+        columns |= 1 << (column - 1);
+    }
+    if (SCPI_ParamErrorOccurred(context)) {
+        return SCPI_RES_ERR;
+    }
+
+    int err;
+    if (!dlog_export::start(dlogFilePath, csvFilePath, decimation, columns, &err)) {
+        SCPI_ErrorPush(context, err);
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_mmemoryExportProgressQ(scpi_t *context) {
+    SCPI_ResultFloat(context, dlog_export::getProgress());
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_mmemoryExportStateQ(scpi_t *context) {
+    SCPI_ResultBool(context, dlog_export::isExporting());
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_mmemoryExportAbort(scpi_t *context) {
+    dlog_export::abort();
+    return SCPI_RES_OK;
+}
+
 } // namespace scpi
 } // namespace psu
 } // namespace eez
@@ -31,6 +31,21 @@ namespace scpi {
 extern bool g_messageAvailable;
 extern bool g_stbQueryExecuted;
 
+enum FetchStreamSource {
+    FETCH_STREAM_NONE,
+    FETCH_STREAM_HISTORY,
+    FETCH_STREAM_DLOG
+};
+
+/// State of the FETCh:HISTory:STReam or FETCh:DLOG:STReam, only one can be active per connection.
+struct FetchStream {
+    uint8_t source;
+    uint8_t channelIndex;
+    uint8_t level;
+    uint32_t sequence; // next history position or DLOG row to send
+    uint32_t lastPushTime;
+};
+
 /// EEZ PSU specific SCPI parser context data.
 struct scpi_psu_t {
     scpi_reg_val_t *registers;
@@ -38,6 +53,7 @@ struct scpi_psu_t {
     char currentDirectory[MAX_PATH_LENGTH + 1];
     bool isBufferOverrun;
     uint32_t bufferOverrunTime;
+    FetchStream fetchStream;
 };
 
 void init(scpi_t &scpi_context, scpi_psu_t &scpi_psu_context, scpi_interface_t *interface,
@@ -53,6 +69,9 @@ void resultChoiceName(scpi_t *context, scpi_choice_def_t *choice, int tag);
 
 void abortDownloading();
 
+/// Pushes new samples to the connections with active fetch stream, called from the SCPI thread.
+void fetchStreamTick();
+
 bool mmemUpload(const char *filePath, scpi_t *context, int *err);
 
 struct OutputBufferWriter {
@@ -22,6 +22,7 @@
 
 #ifdef EEZ_PLATFORM_SIMULATOR
 
+#include <eez/modules/psu/adc_replay.h>
 #include <eez/modules/psu/channel_dispatcher.h>
 #include <eez/modules/psu/io_pins.h>
 
@@ -371,6 +372,40 @@ scpi_result_t scpi_cmd_simulatorPin2Q(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+static scpi_result_t injectPinPulse(scpi_t *context, int pin) {
+    // optional parameter is how long ago (in seconds) the pulse happened
+    uint32_t timeUsec = micros();
+
+    scpi_number_t param;
+    if (SCPI_ParamNumber(context, 0, &param, false)) {
+        if (param.unit != SCPI_UNIT_NONE && param.unit != SCPI_UNIT_SECOND) {
+            SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
+            return SCPI_RES_ERR;
+        }
+
+        if (param.content.value < 0 || param.content.value > 60) {
+            SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+            return SCPI_RES_ERR;
+        }
+
+        timeUsec -= (uint32_t)(param.content.value * 1000000);
+    } else if (SCPI_ParamErrorOccurred(context)) {
+        return SCPI_RES_ERR;
+    }
+
+    io_pins::injectInputPinPulse(pin, timeUsec);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorPin1Pulse(scpi_t *context) {
+    return injectPinPulse(context, EXT_TRIG1);
+}
+
+scpi_result_t scpi_cmd_simulatorPin2Pulse(scpi_t *context) {
+    return injectPinPulse(context, EXT_TRIG2);
+}
+
 scpi_result_t scpi_cmd_simulatorDigitalDataByte(scpi_t *context) {
 	SlotAndSubchannelIndex slotAndSubchannelIndex;
 	if (!getChannelFromParam(context, slotAndSubchannelIndex)) {
@@ -396,6 +431,102 @@ scpi_result_t scpi_cmd_simulatorDigitalDataByte(scpi_t *context) {
 	return SCPI_RES_OK;
 }
 
+static scpi_choice_def_t adcReplayModeChoice[] = {
+    { "FAST", adc_replay::REPLAY_MODE_FULL_SPEED },
+    { "REALtime", adc_replay::REPLAY_MODE_REAL_TIME },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+static scpi_choice_def_t adcReplayStateChoice[] = {
+    { "IDLE", adc_replay::STATE_IDLE },
+    { "RECord", adc_replay::STATE_RECORDING },
+    { "REPLay", adc_replay::STATE_REPLAYING },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+scpi_result_t scpi_cmd_simulatorAdcRecord(scpi_t *context) {
+    char filePath[MAX_PATH_LENGTH + 1];
+    if (!getFilePath(context, filePath, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    int err = adc_replay::startRecording(filePath);
+    if (err != SCPI_RES_OK) {
+        SCPI_ErrorPush(context, err);
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorAdcReplay(scpi_t *context) {
+    char filePath[MAX_PATH_LENGTH + 1];
+    if (!getFilePath(context, filePath, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    int32_t mode;
+    if (!SCPI_ParamChoice(context, adcReplayModeChoice, &mode, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        mode = adc_replay::REPLAY_MODE_FULL_SPEED;
+    }
+
+    int err = adc_replay::startReplay(filePath, (adc_replay::ReplayMode)mode);
+    if (err != SCPI_RES_OK) {
+        SCPI_ErrorPush(context, err);
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorAdcStop(scpi_t *context) {
+    adc_replay::stop();
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorAdcStateQ(scpi_t *context) {
+    resultChoiceName(context, adcReplayStateChoice, adc_replay::getState());
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorAdcStatisticsQ(scpi_t *context) {
+    uint32_t numSamples = adc_replay::g_statistics.numSamples;
+    uint32_t duration = adc_replay::g_statistics.duration;
+
+    // number of samples, duration in seconds and samples per second
+    SCPI_ResultUInt32(context, numSamples);
+    SCPI_ResultFloat(context, duration / 1000000.0f);
+    SCPI_ResultFloat(context, duration > 0 ? numSamples * 1000000.0f / duration : 0.0f);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_simulatorAdcProtectionQ(scpi_t *context) {
+    char filePath[MAX_PATH_LENGTH + 1];
+    if (!getFilePath(context, filePath, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    adc_replay::ProtectionBenchmarkResult result;
+    int err = adc_replay::runProtectionBenchmark(filePath, result);
+    if (err != SCPI_RES_OK) {
+        SCPI_ErrorPush(context, err);
+        return SCPI_RES_ERR;
+    }
+
+    // number of samples, cost per sample in seconds, number of trips, max and avg reaction latency in seconds
+    SCPI_ResultUInt32(context, result.numSamples);
+    SCPI_ResultFloat(context, result.costPerSample / 1000000000.0f);
+    SCPI_ResultUInt32(context, result.numTrips);
+    SCPI_ResultFloat(context, result.maxLatency / 1000000.0f);
+    SCPI_ResultFloat(context, result.avgLatency / 1000000.0f);
+
+    return SCPI_RES_OK;
+}
+
 } // namespace scpi
 } // namespace psu
 } // namespace eez
@@ -501,11 +632,51 @@ scpi_result_t scpi_cmd_simulatorPin2Q(scpi_t *context) {
     return SCPI_RES_ERR;
 }
 
+scpi_result_t scpi_cmd_simulatorPin1Pulse(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorPin2Pulse(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
 scpi_result_t scpi_cmd_simulatorDigitalDataByte(scpi_t *context) {
 	SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
 	return SCPI_RES_ERR;
 }
 
+scpi_result_t scpi_cmd_simulatorAdcRecord(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorAdcReplay(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorAdcStop(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorAdcStateQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorAdcStatisticsQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
+scpi_result_t scpi_cmd_simulatorAdcProtectionQ(scpi_t *context) {
+    SCPI_ErrorPush(context, SCPI_ERROR_UNDEFINED_HEADER);
+    return SCPI_RES_ERR;
+}
+
 } // namespace scpi
 } // namespace psu
 } // namespace eez
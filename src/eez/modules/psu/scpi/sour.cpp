@@ -22,6 +22,7 @@
 #include <eez/modules/psu/io_pins.h>
 #include <eez/modules/psu/list_program.h>
 #include <eez/modules/psu/profile.h>
+#include <eez/modules/psu/ramp.h>
 #include <eez/modules/psu/scpi/psu.h>
 #include <eez/modules/psu/trigger.h>
 
@@ -990,6 +991,62 @@ scpi_result_t scpi_cmd_sourceListCountQ(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+static scpi_choice_def_t listTimingChoice[] = {
+    { "SOFTware", list::LIST_TIMING_SOFTWARE },
+    { "HARDware", list::LIST_TIMING_HARDWARE },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+scpi_result_t scpi_cmd_sourceListTiming(scpi_t *context) {
+    Channel *channel = getPowerChannelFromCommandNumber(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    int32_t timing;
+    if (!SCPI_ParamChoice(context, listTimingChoice, &timing, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    if (!trigger::isIdle()) {
+        SCPI_ErrorPush(context, SCPI_ERROR_CANNOT_CHANGE_TRANSIENT_TRIGGER);
+        return SCPI_RES_ERR;
+    }
+
+    channel_dispatcher::setListTiming(*channel, (uint8_t)timing);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_sourceListTimingQ(scpi_t *context) {
+    Channel *channel = getPowerChannelFromCommandNumber(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    resultChoiceName(context, listTimingChoice, list::getTiming(*channel));
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_sourceListTimingErrorQ(scpi_t *context) {
+    Channel *channel = getPowerChannelFromCommandNumber(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    uint32_t numSteps;
+    uint32_t maxErrorUsec;
+    uint32_t avgErrorUsec;
+    list::getTimingStatistics(*channel, numSteps, maxErrorUsec, avgErrorUsec);
+
+    SCPI_ResultUInt32(context, numSteps);
+    SCPI_ResultFloat(context, maxErrorUsec / 1000000.0f);
+    SCPI_ResultFloat(context, avgErrorUsec / 1000000.0f);
+
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_sourceListCurrentLevel(scpi_t *context) {
     Channel *channel = getPowerChannelFromCommandNumber(context);
     if (!channel) {
@@ -1286,6 +1343,67 @@ scpi_result_t scpi_cmd_sourceVoltageRampDurationQ(scpi_t *context) {
     return get_source_value(context, UNIT_SECOND, channel->u.rampDuration, channel->params.U_RAMP_DURATION_MIN_VALUE, RAMP_DURATION_MAX_VALUE, RAMP_DURATION_DEF_VALUE_U);
 }
 
+static scpi_choice_def_t rampShapeChoice[] = {
+    { "LINear", ramp::RAMP_SHAPE_LINEAR },
+    { "EXPonential", ramp::RAMP_SHAPE_EXPONENTIAL },
+    { "SCURve", ramp::RAMP_SHAPE_S_CURVE },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+scpi_result_t scpi_cmd_sourceCurrentRampShape(scpi_t *context) {
+    Channel *channel = getPowerChannelFromCommandNumber(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    int32_t shape;
+    if (!SCPI_ParamChoice(context, rampShapeChoice, &shape, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    channel_dispatcher::setCurrentRampShape(*channel, (uint8_t)shape);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_sourceCurrentRampShapeQ(scpi_t *context) {
+    Channel *channel = getPowerChannelFromCommandNumber(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    resultChoiceName(context, rampShapeChoice, channel->i.rampShape);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_sourceVoltageRampShape(scpi_t *context) {
+    Channel *channel = getPowerChannelFromCommandNumber(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    int32_t shape;
+    if (!SCPI_ParamChoice(context, rampShapeChoice, &shape, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    channel_dispatcher::setVoltageRampShape(*channel, (uint8_t)shape);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_sourceVoltageRampShapeQ(scpi_t *context) {
+    Channel *channel = getPowerChannelFromCommandNumber(context);
+    if (!channel) {
+        return SCPI_RES_ERR;
+    }
+
+    resultChoiceName(context, rampShapeChoice, channel->u.rampShape);
+
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_sourceDigitalDataByte(scpi_t *context) {
     SlotAndSubchannelIndex slotAndSubchannelIndex;
     if (!getChannelFromCommandNumber(context, slotAndSubchannelIndex)) {
@@ -404,6 +404,31 @@ scpi_result_t scpi_cmd_systemTemperatureProtectionHighTrippedQ(scpi_t *context)
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_systemTemperatureSrateQ(scpi_t *context) {
+    int32_t sensor;
+    if (!param_temp_sensor(context, sensor)) {
+        return SCPI_RES_ERR;
+    }
+
+    SCPI_ResultFloat(context, temperature::sensors[sensor].getSampleRate());
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_systemTemperatureTimingQ(scpi_t *context) {
+    temperature::TaskStatistics statistics;
+    temperature::getTaskStatistics(statistics);
+
+    SCPI_ResultUInt32(context, statistics.periodUsec);
+    SCPI_ResultUInt32(context, statistics.numIterations);
+    SCPI_ResultUInt32(context, statistics.lastDurationUsec);
+    SCPI_ResultUInt32(context, statistics.avgDurationUsec);
+    SCPI_ResultUInt32(context, statistics.maxDurationUsec);
+    SCPI_ResultUInt32(context, statistics.maxLatenessUsec);
+
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_systemSlotCountQ(scpi_t *context) {
     SCPI_ResultInt(context, NUM_SLOTS);
 
@@ -919,6 +944,106 @@ scpi_result_t scpi_cmd_systemCommunicateUsbClassQ(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+static const int LOG_FIND_DEFAULT_COUNT = 20;
+static const int LOG_FIND_MAX_COUNT = 100;
+
+static scpi_choice_def_t eventTypeChoice[] = {
+    { "DEBug", event_queue::EVENT_TYPE_DEBUG },
+    { "INFO", event_queue::EVENT_TYPE_INFO },
+    { "WARNing", event_queue::EVENT_TYPE_WARNING },
+    { "ERRor", event_queue::EVENT_TYPE_ERROR },
+    SCPI_CHOICE_LIST_END /* termination of option list */
+};
+
+static bool paramDateTime(scpi_t *context, uint32_t &dateTime) {
+    const char *text;
+    size_t textLen;
+    if (!SCPI_ParamCharacters(context, &text, &textLen, true)) {
+        return false;
+    }
+
+    char str[32];
+    if (textLen > sizeof(str) - 1) {
+        SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+        return false;
+    }
+    memcpy(str, text, textLen);
+    str[textLen] = 0;
+
+    if (!datetime::parseDateTime(str, dateTime)) {
+        SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+        return false;
+    }
+
+    return true;
+}
+
+static void logFindCallback(void *param, uint32_t dateTime, int eventType, const char *message) {
+    scpi_t *context = (scpi_t *)param;
+
+    int year, month, day, hour, minute, second;
+    datetime::breakTime(dateTime, year, month, day, hour, minute, second);
+
+    char text[300];
+    snprintf(text, sizeof(text), "%04d-%02d-%02d %02d:%02d:%02d %s %s", year, month, day, hour, minute, second, event_queue::getEventTypeNameFromType(eventType), message);
+    text[sizeof(text) - 1] = 0;
+
+    SCPI_ResultText(context, text);
+}
+
+scpi_result_t scpi_cmd_systemLogFindQ(scpi_t *context) {
+    uint32_t fromDateTime;
+    if (!paramDateTime(context, fromDateTime)) {
+        return SCPI_RES_ERR;
+    }
+
+    uint32_t toDateTime;
+    if (!paramDateTime(context, toDateTime)) {
+        return SCPI_RES_ERR;
+    }
+
+    int32_t eventType;
+    if (!SCPI_ParamChoice(context, eventTypeChoice, &eventType, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        eventType = event_queue::EVENT_TYPE_DEBUG;
+    }
+
+    // 0 means all events, not only those related to some channel
+    int32_t channel;
+    if (!SCPI_ParamInt(context, &channel, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        channel = 0;
+    }
+    if (channel < 0 || channel > CH_NUM) {
+        SCPI_ErrorPush(context, SCPI_ERROR_CHANNEL_NOT_FOUND);
+        return SCPI_RES_ERR;
+    }
+
+    int32_t count;
+    if (!SCPI_ParamInt(context, &count, false)) {
+        if (SCPI_ParamErrorOccurred(context)) {
+            return SCPI_RES_ERR;
+        }
+        count = LOG_FIND_DEFAULT_COUNT;
+    }
+    if (count < 1 || count > LOG_FIND_MAX_COUNT) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    int err;
+    if (!event_queue::findEvents(fromDateTime, toDateTime, eventType, channel - 1, count, context, logFindCallback, &err)) {
+        SCPI_ErrorPush(context, err);
+        return SCPI_RES_ERR;
+    }
+
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_systemLocal(scpi_t *context) {
     g_rlState = RL_STATE_LOCAL;
 
@@ -1800,6 +1925,111 @@ scpi_result_t scpi_cmd_systemRestart(scpi_t *context) {
 	return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_systemCommunicateMqttBufferClear(scpi_t *context) {
+#if OPTION_ETHERNET
+    mqtt::clearOfflineBuffer();
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_systemCommunicateMqttBufferRate(scpi_t *context) {
+#if OPTION_ETHERNET
+    float rate;
+    scpi_number_t param;
+    if (!SCPI_ParamNumber(context, scpi_special_numbers_def, &param, true)) {
+        return SCPI_RES_ERR;
+    }
+
+    if (param.special) {
+        if (param.content.tag == SCPI_NUM_MIN) {
+            rate = mqtt::REPLAY_RATE_MIN;
+        } else if (param.content.tag == SCPI_NUM_MAX) {
+            rate = mqtt::REPLAY_RATE_MAX;
+        } else if (param.content.tag == SCPI_NUM_DEF) {
+            rate = mqtt::REPLAY_RATE_DEFAULT;
+        } else {
+            SCPI_ErrorPush(context, SCPI_ERROR_ILLEGAL_PARAMETER_VALUE);
+            return SCPI_RES_ERR;
+        }
+    } else {
+        if (param.unit != SCPI_UNIT_NONE) {
+            SCPI_ErrorPush(context, SCPI_ERROR_INVALID_SUFFIX);
+            return SCPI_RES_ERR;
+        }
+
+        rate = (float)param.content.value;
+    }
+
+    if (rate < mqtt::REPLAY_RATE_MIN || rate > mqtt::REPLAY_RATE_MAX) {
+        SCPI_ErrorPush(context, SCPI_ERROR_DATA_OUT_OF_RANGE);
+        return SCPI_RES_ERR;
+    }
+
+    mqtt::g_replayRate = rate;
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_systemCommunicateMqttBufferRateQ(scpi_t *context) {
+#if OPTION_ETHERNET
+    SCPI_ResultFloat(context, mqtt::g_replayRate);
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_systemCommunicateMqttBufferSpill(scpi_t *context) {
+#if OPTION_ETHERNET
+    bool enable;
+    if (!SCPI_ParamBool(context, &enable, TRUE)) {
+        return SCPI_RES_ERR;
+    }
+
+    mqtt::g_offlineSpillEnabled = enable;
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_systemCommunicateMqttBufferSpillQ(scpi_t *context) {
+#if OPTION_ETHERNET
+    SCPI_ResultBool(context, mqtt::g_offlineSpillEnabled);
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
+scpi_result_t scpi_cmd_systemCommunicateMqttBufferStatisticsQ(scpi_t *context) {
+#if OPTION_ETHERNET
+    mqtt::OfflineBufferStatistics statistics;
+    mqtt::getOfflineBufferStatistics(statistics);
+
+    SCPI_ResultUInt32(context, statistics.numBuffered);
+    SCPI_ResultUInt32(context, statistics.numSpilled);
+    SCPI_ResultUInt32(context, statistics.numDropped);
+    SCPI_ResultUInt32(context, statistics.numReplayed);
+
+    return SCPI_RES_OK;
+#else
+    SCPI_ErrorPush(context, SCPI_ERROR_HARDWARE_MISSING);
+    return SCPI_RES_ERR;
+#endif
+}
+
 scpi_result_t scpi_cmd_systemCommunicateMqttSettings(scpi_t *context) {
 #if OPTION_ETHERNET
     const char *addr;
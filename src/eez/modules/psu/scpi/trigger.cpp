@@ -20,6 +20,7 @@
 
 #include <eez/modules/psu/channel_dispatcher.h>
 #include <eez/modules/psu/io_pins.h>
+#include <eez/modules/psu/list_program.h>
 #include <eez/modules/psu/profile.h>
 #include <eez/modules/psu/scpi/psu.h>
 #include <eez/modules/psu/trigger.h>
@@ -67,6 +68,42 @@ scpi_result_t scpi_cmd_triggerSequenceDelayQ(scpi_t *context) {
     return SCPI_RES_OK;
 }
 
+scpi_result_t scpi_cmd_triggerSequenceLatencyQ(scpi_t *context) {
+    trigger::LatencyStatistics statistics;
+    trigger::getLatencyStatistics(statistics);
+
+    // number of measured triggers, last, min, max and average latency in seconds
+    SCPI_ResultUInt32(context, statistics.count);
+    SCPI_ResultFloat(context, statistics.lastUsec / 1000000.0f);
+    SCPI_ResultFloat(context, statistics.minUsec / 1000000.0f);
+    SCPI_ResultFloat(context, statistics.maxUsec / 1000000.0f);
+    SCPI_ResultFloat(context, statistics.avgUsec / 1000000.0f);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_triggerSequenceLatencyArmQ(scpi_t *context) {
+    trigger::LatencyStatistics statistics;
+    trigger::getLatencyStatistics(statistics);
+
+    uint32_t hits;
+    uint32_t misses;
+    list::getCheckLimitsCacheStatistics(hits, misses);
+
+    // last and max arm check time in seconds, number of list checks served from the cache and recalculated
+    SCPI_ResultFloat(context, statistics.checkLastUsec / 1000000.0f);
+    SCPI_ResultFloat(context, statistics.checkMaxUsec / 1000000.0f);
+    SCPI_ResultUInt32(context, hits);
+    SCPI_ResultUInt32(context, misses);
+
+    return SCPI_RES_OK;
+}
+
+scpi_result_t scpi_cmd_triggerSequenceLatencyClear(scpi_t *context) {
+    trigger::clearLatencyStatistics();
+    return SCPI_RES_OK;
+}
+
 scpi_result_t scpi_cmd_triggerSequenceSource(scpi_t *context) {
     int32_t source;
     if (!SCPI_ParamChoice(context, sourceChoice, &source, true)) {
@@ -22,9 +22,10 @@
 
 #if defined(EEZ_PLATFORM_SIMULATOR)
 #include <stdio.h>
-#include <string.h>
 #endif
 
+#include <string.h>
+
 #include <eez/system.h>
 #include <eez/tasks.h>
 
@@ -33,16 +34,67 @@
 
 UARTClass Serial;
 
+// Input ring buffer, written by the transport (USB CDC interrupt or simulator
+// console thread) and read by the low priority thread. Only one SERIAL_INPUT_AVAILABLE
+// message is pending at a time, the consumer drains everything that is available.
+static SerialInputBuffer g_inputBuffer;
+static volatile bool g_inputMessagePending;
+
 #if defined(EEZ_PLATFORM_STM32)
-uint8_t *g_buffer;
-uint32_t g_length;
-#endif
+extern USBD_HandleTypeDef hUsbDeviceFS;
 
-#if defined(EEZ_PLATFORM_SIMULATOR)
-uint8_t g_serialInputChars[LOW_PRIORITY_THREAD_QUEUE_SIZE + 1];
-int g_serialInputCharPosition = 0;
+// Next CDC packet is received only if it fits into the input buffer,
+// otherwise reception is resumed when the consumer frees enough space.
+static volatile bool g_receivePacketPending;
 #endif
 
+uint32_t SerialInputBuffer::getFree() {
+    return SIZE - 1 - (m_head - m_tail + SIZE) % SIZE;
+}
+
+uint32_t SerialInputBuffer::put(const uint8_t *buffer, uint32_t length) {
+    uint32_t head = m_head;
+
+    length = MIN(length, getFree());
+
+    uint32_t length1 = MIN(length, SIZE - head);
+    memcpy(m_buffer + head, buffer, length1);
+    memcpy(m_buffer, buffer + length1, length - length1);
+
+    m_head = (head + length) % SIZE;
+
+    return length;
+}
+
+bool SerialInputBuffer::get(uint8_t **buffer, uint32_t *length) {
+    uint32_t head = m_head;
+    uint32_t tail = m_tail;
+    if (head == tail) {
+        return false;
+    }
+
+    *buffer = m_buffer + tail;
+    *length = head > tail ? head - tail : SIZE - tail;
+
+    return true;
+}
+
+void SerialInputBuffer::release(uint32_t length) {
+    m_tail = (m_tail + length) % SIZE;
+}
+
+static uint32_t putToInputBuffer(const uint8_t *buffer, uint32_t length) {
+    length = g_inputBuffer.put(buffer, length);
+
+    if (length > 0 && !g_inputMessagePending) {
+        g_inputMessagePending = true;
+        using namespace eez;
+        sendMessageToLowPriorityThread(SERIAL_INPUT_AVAILABLE);
+    }
+
+    return length;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 #if defined(EEZ_PLATFORM_STM32)
@@ -52,46 +104,61 @@ extern "C" void notifySerialLineStateChanged(uint8_t serialLineState) {
 }
 
 extern "C" void notifySerialInput(uint8_t *buffer, uint32_t length) {
-	g_buffer = buffer;
-	g_length = length;
-	using namespace eez;
-	sendMessageToLowPriorityThread(SERIAL_INPUT_AVAILABLE);
-	return;
+    // fits because packet is received only when there is room for it
+    putToInputBuffer(buffer, length);
+
+    if (g_inputBuffer.getFree() >= CDC_DATA_FS_MAX_PACKET_SIZE) {
+        USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+    } else {
+        g_receivePacketPending = true;
+    }
 }
 #endif
 
 ////////////////////////////////////////////////////////////////////////////////
 
-#if defined(EEZ_PLATFORM_STM32)
-extern USBD_HandleTypeDef hUsbDeviceFS;
-#endif
-
 #if defined(EEZ_PLATFORM_SIMULATOR)
+void UARTClass::put(const uint8_t *buffer, uint32_t length) {
+    while (length > 0) {
+        uint32_t n = putToInputBuffer(buffer, length);
+        if (n == 0) {
+#if defined(__EMSCRIPTEN__)
+            // consumer runs in the same thread, at most 256 bytes are put per main loop
+            // iteration, so this doesn't happen unless input is not processed at all
+            break;
+#else
+            // wait for the consumer
+            osDelay(1);
+            continue;
+#endif
+        }
+        buffer += n;
+        length -= n;
+    }
+}
+
 void UARTClass::put(int ch) {
-    g_serialInputChars[g_serialInputCharPosition] = ch;
-    
-    using namespace eez;
-    sendMessageToLowPriorityThread(SERIAL_INPUT_AVAILABLE, g_serialInputCharPosition);
-    
-    g_serialInputCharPosition = (g_serialInputCharPosition + 1) % (LOW_PRIORITY_THREAD_QUEUE_SIZE + 1);
+    uint8_t buffer = (uint8_t)ch;
+    put(&buffer, 1);
 }
 #endif
 
-void UARTClass::getInputBuffer(int bufferPosition, uint8_t **buffer, uint32_t *length) {
-#if defined(EEZ_PLATFORM_STM32)
-    *buffer = g_buffer;
-    *length = g_length;
-#endif
+bool UARTClass::getInputBuffer(uint8_t **buffer, uint32_t *length) {
+    // cleared before reading head, so there is always a message
+    // for the input added after this point
+    g_inputMessagePending = false;
 
-#if defined(EEZ_PLATFORM_SIMULATOR)
-    *buffer = &g_serialInputChars[bufferPosition];
-    *length = 1;
-#endif
+    return g_inputBuffer.get(buffer, length);
 }
 
-void UARTClass::releaseInputBuffer() {
+void UARTClass::releaseInputBuffer(uint32_t length) {
+    g_inputBuffer.release(length);
+
 #if defined(EEZ_PLATFORM_STM32)
-	USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+    if (g_receivePacketPending && g_inputBuffer.getFree() >= CDC_DATA_FS_MAX_PACKET_SIZE) {
+        g_receivePacketPending = false;
+        USBD_CDC_ReceivePacket(&hUsbDeviceFS);
+    }
 #endif
 }
 
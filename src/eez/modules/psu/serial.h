@@ -20,14 +20,37 @@
 
 #include <stdint.h>
 
+// Single producer, single consumer ring buffer for the received input.
+class SerialInputBuffer {
+public:
+    static const uint32_t SIZE = 2048;
+
+    uint32_t getFree();
+
+    // Returns number of bytes put, less than length if buffer is full.
+    uint32_t put(const uint8_t *buffer, uint32_t length);
+
+    // Returns contiguous span of the received input, false if there is none.
+    bool get(uint8_t **buffer, uint32_t *length);
+    void release(uint32_t length);
+
+private:
+    uint8_t m_buffer[SIZE];
+    volatile uint32_t m_head; // write position
+    volatile uint32_t m_tail; // read position
+};
+
 class UARTClass {
 public:
 #if defined(EEZ_PLATFORM_SIMULATOR)
+    // blocks while input buffer is full
+    void put(const uint8_t *buffer, uint32_t length);
     void put(int ch);
 #endif
 
-    void getInputBuffer(int bufferPosition, uint8_t **buffer, uint32_t *length);
-    void releaseInputBuffer();
+    // Returns contiguous span of the received input, false if there is none.
+    bool getInputBuffer(uint8_t **buffer, uint32_t *length);
+    void releaseInputBuffer(uint32_t length);
 
     int write(const char *buffer, int size);
     int print(const char *data);
@@ -126,11 +126,12 @@ void onQueueMessage(uint32_t type, uint32_t param) {
     } else if (type == SERIAL_INPUT_AVAILABLE) {
         uint8_t *buffer;
         uint32_t length;
-        Serial.getInputBuffer(param, &buffer, &length);
-        if (g_testResult == TEST_OK) {
-            input(g_scpiContext, (const char *)buffer, length);
+        while (Serial.getInputBuffer(&buffer, &length)) {
+            if (g_testResult == TEST_OK) {
+                input(g_scpiContext, (const char *)buffer, length);
+            }
+            Serial.releaseInputBuffer(length);
         }
-        Serial.releaseInputBuffer();
     }
 }
 
@@ -142,6 +143,102 @@ void initScpi() {
     scpi::init(g_scpiContext, g_scpiPsuContext, &g_scpiInterface, g_scpiInputBuffer, SCPI_PARSER_INPUT_BUFFER_LENGTH, g_errorQueueData, SCPI_PARSER_ERROR_QUEUE_SIZE + 1);
 }
 
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+
+static const char BENCHMARK_SCRIPT[] =
+    "*STB?\n"
+    "SOUR1:VOLT?\n"
+    "SOUR1:CURR?\n"
+    "SOUR1:VOLT:PROT?\n"
+    "OUTP? CH1\n"
+    "SYST:ERR?\n";
+
+static const uint32_t BENCHMARK_SCRIPT_NUM_COMMANDS = 6;
+
+static uint32_t g_benchmarkNumErrors;
+
+static size_t benchmarkWrite(scpi_t *context, const char *data, size_t len) {
+    return len;
+}
+
+static scpi_result_t benchmarkFlush(scpi_t *context) {
+    return SCPI_RES_OK;
+}
+
+static int benchmarkError(scpi_t *context, int_fast16_t err) {
+    if (err != 0) {
+        g_benchmarkNumErrors++;
+    }
+    return 0;
+}
+
+static scpi_result_t benchmarkControl(scpi_t *context, scpi_ctrl_name_t ctrl, scpi_reg_val_t val) {
+    return SCPI_RES_OK;
+}
+
+static scpi_result_t benchmarkReset(scpi_t *context) {
+    return SCPI_RES_OK;
+}
+
+static scpi_interface_t g_benchmarkInterface = {
+    benchmarkError, benchmarkWrite, benchmarkControl, benchmarkFlush, benchmarkReset,
+};
+
+static SerialInputBuffer g_benchmarkInputBuffer;
+
+void runInputBenchmark(uint32_t size, InputBenchmarkResult &result) {
+    static scpi_reg_val_t scpiPsuRegs[SCPI_PSU_REG_COUNT];
+    static scpi_psu_t scpiPsuContext = { scpiPsuRegs };
+    static char scpiInputBuffer[SCPI_PARSER_INPUT_BUFFER_LENGTH];
+    static scpi_error_t errorQueueData[SCPI_PARSER_ERROR_QUEUE_SIZE + 1];
+    static scpi_t scpiContext;
+
+    scpi::init(scpiContext, scpiPsuContext, &g_benchmarkInterface, scpiInputBuffer, SCPI_PARSER_INPUT_BUFFER_LENGTH, errorQueueData, SCPI_PARSER_ERROR_QUEUE_SIZE + 1);
+
+    // whole script repeats, so the last command is not cut
+    const uint32_t scriptLength = sizeof(BENCHMARK_SCRIPT) - 1;
+    uint32_t numRepeats = MAX((size + scriptLength - 1) / scriptLength, 1);
+
+    g_benchmarkNumErrors = 0;
+
+    uint32_t numBytesPut = 0;
+    uint32_t numBytes = numRepeats * scriptLength;
+
+    uint32_t start = micros();
+
+    uint32_t numBytesConsumed = 0;
+    while (numBytesConsumed < numBytes) {
+        // producer, as the transport would do, puts until buffer is full
+        while (numBytesPut < numBytes) {
+            uint32_t scriptOffset = numBytesPut % scriptLength;
+            uint32_t n = g_benchmarkInputBuffer.put((const uint8_t *)BENCHMARK_SCRIPT + scriptOffset, scriptLength - scriptOffset);
+            if (n == 0) {
+                break;
+            }
+            numBytesPut += n;
+        }
+
+        // consumer, same as SERIAL_INPUT_AVAILABLE message handler
+        uint8_t *buffer;
+        uint32_t length;
+        while (g_benchmarkInputBuffer.get(&buffer, &length)) {
+            input(scpiContext, (const char *)buffer, length);
+            g_benchmarkInputBuffer.release(length);
+            numBytesConsumed += length;
+        }
+    }
+
+    uint32_t duration = micros() - start;
+
+    result.numBytes = numBytes;
+    result.numCommands = numRepeats * BENCHMARK_SCRIPT_NUM_COMMANDS;
+    result.numErrors = g_benchmarkNumErrors;
+    result.durationMs = duration / 1000.0f;
+    result.bytesPerSecond = duration > 0 ? numBytes * 1000000.0f / duration : 0;
+}
+
+#endif
+
 } // namespace serial
 } // namespace psu
 } // namespace eez
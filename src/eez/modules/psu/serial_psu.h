@@ -34,6 +34,20 @@ void onQueueMessage(uint32_t type, uint32_t param);
 
 bool isConnected();
 
+#if defined(DEBUG) && defined(EEZ_PLATFORM_SIMULATOR)
+struct InputBenchmarkResult {
+    uint32_t numBytes;
+    uint32_t numCommands;
+    uint32_t numErrors;
+    float durationMs;
+    float bytesPerSecond;
+};
+
+// SCPI script is pushed through its own input ring buffer into its own SCPI context,
+// so serial interface is not affected and output is discarded.
+void runInputBenchmark(uint32_t size, InputBenchmarkResult &result);
+#endif
+
 }
 }
 } // namespace eez::psu::serial
@@ -33,6 +33,11 @@
 #include <eez/modules/psu/persist_conf.h>
 #include <eez/modules/psu/temperature.h>
 #include <eez/sound.h>
+#include <eez/tasks.h>
+
+#if OPTION_FAN
+#include <eez/modules/aux_ps/fan.h>
+#endif
 
 namespace eez {
 namespace psu {
@@ -48,6 +53,23 @@ static uint32_t g_lastMeasuredTick;
 static uint32_t g_maxTempCheckStartTick;
 static float g_lastMaxChannelTemperature;
 
+void mainLoop(const void *);
+
+#if defined(EEZ_PLATFORM_STM32)
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wwrite-strings"
+#endif
+
+osThreadDef(g_temperatureTask, mainLoop, osPriorityNormal, 0, 2048);
+
+#if defined(EEZ_PLATFORM_STM32)
+#pragma GCC diagnostic pop
+#endif
+
+static uint32_t g_taskNextIterTick;
+static TaskStatistics g_taskStatistics;
+static uint64_t g_taskSumDurationUsec;
+
 void init() {
     for (int i = 0; i < temp_sensor::NUM_TEMP_SENSORS; ++i) {
         temp_sensor::sensors[i].init();
@@ -148,6 +170,68 @@ float getMaxChannelTemperature() {
 
 ////////////////////////////////////////////////////////////////////////////////
 
+void startThread() {
+    g_taskStatistics.periodUsec = TEMPERATURE_TASK_PERIOD_MS * 1000;
+    g_taskNextIterTick = micros();
+    osThreadCreate(osThread(g_temperatureTask), nullptr);
+}
+
+void oneIter();
+
+void mainLoop(const void *) {
+#ifdef __EMSCRIPTEN__
+    oneIter();
+#else
+    while (1) {
+        int32_t diff = g_taskNextIterTick - micros();
+        if (diff > 0) {
+            osDelay((diff + 999) / 1000);
+        }
+        oneIter();
+    }
+#endif
+}
+
+void oneIter() {
+    uint32_t tickCount = micros();
+
+    int32_t lateness = tickCount - g_taskNextIterTick;
+    if (lateness < 0) {
+        return;
+    }
+
+    if (lateness < (int32_t)g_taskStatistics.periodUsec) {
+        g_taskNextIterTick += g_taskStatistics.periodUsec;
+    } else {
+        // skip missed iterations instead of running them back to back
+        g_taskNextIterTick = tickCount + g_taskStatistics.periodUsec;
+    }
+
+    tick(tickCount);
+#if OPTION_FAN
+    aux_ps::fan::tick(tickCount);
+#endif
+
+    uint32_t duration = micros() - tickCount;
+
+    g_taskStatistics.numIterations++;
+    g_taskStatistics.lastDurationUsec = duration;
+    g_taskSumDurationUsec += duration;
+    g_taskStatistics.avgDurationUsec = (uint32_t)(g_taskSumDurationUsec / g_taskStatistics.numIterations);
+    if (duration > g_taskStatistics.maxDurationUsec) {
+        g_taskStatistics.maxDurationUsec = duration;
+    }
+    if ((uint32_t)lateness > g_taskStatistics.maxLatenessUsec) {
+        g_taskStatistics.maxLatenessUsec = lateness;
+    }
+}
+
+void getTaskStatistics(TaskStatistics &statistics) {
+    statistics = g_taskStatistics;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 TempSensorTemperature::TempSensorTemperature(int sensorIndex_)
     : temperature(NAN), sensorIndex(sensorIndex_) {
 }
@@ -166,6 +250,12 @@ bool TempSensorTemperature::isTestOK() {
 
 void TempSensorTemperature::tick(uint32_t tick_usec) {
     if (isInstalled() && isTestOK()) {
+        if (hasSample) {
+            sampleIntervalUsec = tick_usec - lastSampleTick;
+        }
+        hasSample = true;
+        lastSampleTick = tick_usec;
+
         measure();
         if (temp_sensor::sensors[sensorIndex].g_testResult == TEST_OK) {
             protection_check(tick_usec);
@@ -202,6 +292,13 @@ bool TempSensorTemperature::isTripped() {
     return otp_tripped;
 }
 
+float TempSensorTemperature::getSampleRate() {
+    if (!isInstalled() || !isTestOK() || sampleIntervalUsec == 0) {
+        return 0;
+    }
+    return 1000000.0f / sampleIntervalUsec;
+}
+
 void TempSensorTemperature::set_otp_reg(bool on) {
     Channel *channel = temp_sensor::sensors[sensorIndex].getChannel();
     if (channel) {
@@ -235,6 +332,12 @@ void TempSensorTemperature::protection_check(uint32_t tick_usec) {
 }
 
 void TempSensorTemperature::protection_enter(TempSensorTemperature &sensor) {
+    if (!isPsuThread()) {
+        // output disable and power down must be done from the PSU thread
+        sendMessageToPsu(PSU_MESSAGE_TEMPERATURE_PROTECTION_ENTER, sensor.sensorIndex);
+        return;
+    }
+
     Channel *channel = temp_sensor::sensors[sensor.sensorIndex].getChannel();
     if (channel) {
         if (channel->channelIndex < 2 && channel_dispatcher::getCouplingType() != channel_dispatcher::COUPLING_TYPE_NONE) {
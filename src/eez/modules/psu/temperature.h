@@ -35,10 +35,25 @@ struct ProtectionConfiguration {
     bool state;
 };
 
+/// Timing of the temperature and fan control task.
+struct TaskStatistics {
+    uint32_t periodUsec;
+    uint32_t numIterations;
+    uint32_t lastDurationUsec;
+    uint32_t avgDurationUsec;
+    uint32_t maxDurationUsec;
+    uint32_t maxLatenessUsec; // how late (at most) iteration started
+};
+
 void init();
 bool test();
 void tick(uint32_t tick_usec);
 
+/// Starts the task which samples temperature sensors and controls the fan
+/// every TEMPERATURE_TASK_PERIOD_MS, outside of the PSU thread.
+void startThread();
+void getTaskStatistics(TaskStatistics &statistics);
+
 bool isChannelSensorInstalled(Channel *channel);
 bool getChannelSensorState(Channel *channel);
 float getChannelSensorLevel(Channel *channel);
@@ -66,17 +81,23 @@ public:
 	float measure();
 	void clearProtection();
 	bool isTripped();
+	float getSampleRate();
+
+    static void protection_enter(TempSensorTemperature& sensor);
 
 private:
 	int sensorIndex;
 
+	bool hasSample;
+	uint32_t lastSampleTick;
+	uint32_t sampleIntervalUsec;
+
 	bool otp_alarmed;
 	uint32_t otp_alarmed_started_tick;
 	bool otp_tripped;
 
 	void set_otp_reg(bool on);
 	void protection_check(uint32_t tick_usec);
-    static void protection_enter(TempSensorTemperature& sensor);
 	void protection_enter();
 };
 
@@ -40,7 +40,17 @@ bool g_triggerContinuousInitializationEnabled;
 
 enum State { STATE_IDLE, STATE_INITIATED, STATE_TRIGGERED, STATE_EXECUTING };
 static State g_state;
-static uint32_t g_triggeredTime;
+static uint32_t g_triggeredTimeUsec;
+
+static bool g_measureLatency;
+static uint32_t g_latencyCount;
+static uint32_t g_latencyLastUsec;
+static uint32_t g_latencyMinUsec;
+static uint32_t g_latencyMaxUsec;
+static uint64_t g_latencySumUsec;
+
+static uint32_t g_checkLastUsec;
+static uint32_t g_checkMaxUsec;
 
 bool g_triggerInProgress[CH_MAX];
 
@@ -104,8 +114,8 @@ void setSource(Source triggerSource) {
     }
 }
 
-void check(uint32_t currentTime) {
-    if (currentTime - g_triggeredTime > g_triggerDelay * 1000L) {
+void check(uint32_t currentTimeUsec) {
+    if (currentTimeUsec - g_triggeredTimeUsec >= (uint32_t)(g_triggerDelay * 1000000L)) {
         startImmediately();
     }
 }
@@ -125,6 +135,10 @@ bool isInitiated(Source source) {
 }
 
 int generateTrigger(Source source, bool checkImmediatelly) {
+    return generateTriggerAt(source, micros(), checkImmediatelly);
+}
+
+int generateTriggerAt(Source source, uint32_t timeUsec, bool checkImmediatelly) {
     bool seqInitiated = isSeqInitiated(source);
     bool dlogInitiated = isDlogInitiated(source);
 
@@ -139,10 +153,11 @@ int generateTrigger(Source source, bool checkImmediatelly) {
     if (seqInitiated) {
         setState(STATE_TRIGGERED);
 
-        g_triggeredTime = micros() / 1000;
+        g_triggeredTimeUsec = timeUsec;
+        g_measureLatency = true;
 
         if (checkImmediatelly) {
-            check(g_triggeredTime);
+            check(micros());
         }
     }
 
@@ -217,7 +232,7 @@ void setTriggerFinished(Channel &channel) {
     }
 }
 
-int checkTrigger() {
+static int doCheckTrigger() {
     bool onlyFixed = true;
     
     bool trackingChannelsChecked = false;
@@ -292,6 +307,21 @@ int checkTrigger() {
     return 0;
 }
 
+// Measures time spent in checking if trigger can be armed,
+// this is re-arm latency in continuous initiation mode.
+int checkTrigger() {
+    uint32_t startTimeUsec = micros();
+
+    int err = doCheckTrigger();
+
+    g_checkLastUsec = micros() - startTimeUsec;
+    if (g_checkLastUsec > g_checkMaxUsec) {
+        g_checkMaxUsec = g_checkLastUsec;
+    }
+
+    return err;
+}
+
 int startImmediately() {
     int err = checkTrigger();
     if (err) {
@@ -354,6 +384,24 @@ void startImmediatelyInPsuThread() {
     }
 
     channel_dispatcher::syncOutputEnable();
+
+    if (g_measureLatency) {
+        g_measureLatency = false;
+
+        uint32_t latencyUsec = micros() - g_triggeredTimeUsec;
+        uint32_t delayUsec = (uint32_t)(g_triggerDelay * 1000000L);
+        latencyUsec = latencyUsec > delayUsec ? latencyUsec - delayUsec : 0;
+
+        if (g_latencyCount == 0 || latencyUsec < g_latencyMinUsec) {
+            g_latencyMinUsec = latencyUsec;
+        }
+        if (g_latencyCount == 0 || latencyUsec > g_latencyMaxUsec) {
+            g_latencyMaxUsec = latencyUsec;
+        }
+        g_latencyLastUsec = latencyUsec;
+        g_latencySumUsec += latencyUsec;
+        g_latencyCount++;
+    }
 }
 
 int initiate() {
@@ -403,6 +451,8 @@ void abort() {
         list::abort();
         ramp::abort();
 
+        g_measureLatency = false;
+
         bool sync = false;
         for (int i = 0; i < CH_NUM; ++i) {
             auto &channel = Channel::get(i);
@@ -421,10 +471,31 @@ void abort() {
 
 void tick(uint32_t tick_usec) {
     if (g_state == STATE_TRIGGERED) {
-        check(tick_usec / 1000);
+        check(tick_usec);
     }
 }
 
+void getLatencyStatistics(LatencyStatistics &statistics) {
+    statistics.count = g_latencyCount;
+    statistics.lastUsec = g_latencyLastUsec;
+    statistics.minUsec = g_latencyMinUsec;
+    statistics.maxUsec = g_latencyMaxUsec;
+    statistics.avgUsec = g_latencyCount > 0 ? (uint32_t)(g_latencySumUsec / g_latencyCount) : 0;
+    statistics.checkLastUsec = g_checkLastUsec;
+    statistics.checkMaxUsec = g_checkMaxUsec;
+}
+
+void clearLatencyStatistics() {
+    g_latencyCount = 0;
+    g_latencyLastUsec = 0;
+    g_latencyMinUsec = 0;
+    g_latencyMaxUsec = 0;
+    g_latencySumUsec = 0;
+    g_checkLastUsec = 0;
+    g_checkMaxUsec = 0;
+    list::clearCheckLimitsCacheStatistics();
+}
+
 } // namespace trigger
 } // namespace psu
 } // namespace eez
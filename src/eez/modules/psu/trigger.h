@@ -53,6 +53,8 @@ float getCurrent(Channel &channel);
 
 bool isInitiated(Source source);
 int generateTrigger(Source source, bool checkImmediatelly = true);
+// timeUsec is the micros() time when trigger event happened, trigger delay is counted from it
+int generateTriggerAt(Source source, uint32_t timeUsec, bool checkImmediatelly = true);
 int startImmediately();
 void startImmediatelyInPsuThread();
 int initiate();
@@ -66,6 +68,22 @@ void abort();
 
 void tick(uint32_t tick_usec);
 
+// Time from the trigger event to the output change, not counting the trigger delay.
+struct LatencyStatistics {
+    uint32_t count;
+    uint32_t lastUsec;
+    uint32_t minUsec;
+    uint32_t maxUsec;
+    uint32_t avgUsec;
+
+    // time spent in checking if trigger can be armed (on INIT and before start)
+    uint32_t checkLastUsec;
+    uint32_t checkMaxUsec;
+};
+
+void getLatencyStatistics(LatencyStatistics &statistics);
+void clearLatencyStatistics();
+
 }
 }
 } // namespace eez::psu::trigger
\ No newline at end of file
@@ -45,12 +45,15 @@ extern "C" {
 #include <eez/debug.h>
 #include <eez/mqtt.h>
 #include <eez/system.h>
+#include <eez/memory.h>
 
 #include <eez/modules/psu/psu.h>
 #include <eez/modules/psu/trigger.h>
 #include <eez/modules/psu/ethernet.h>
 #include <eez/modules/psu/channel_dispatcher.h>
+#include <eez/modules/psu/datetime.h>
 #include <eez/modules/psu/event_queue.h>
+#include <eez/modules/psu/sd_card.h>
 #include <eez/modules/psu/profile.h>
 #include <eez/modules/psu/temperature.h>
 #include <eez/modules/psu/ontime.h>
@@ -59,6 +62,8 @@ extern "C" {
 
 #include <eez/modules/mcu/battery.h>
 
+#include <eez/libs/sd_fat/sd_fat.h>
+
 #if OPTION_FAN
 #include <eez/modules/aux_ps/fan.h>
 #endif
@@ -156,6 +161,72 @@ static uint8_t g_lastChannelIndex = 0;
 static uint8_t g_lastValueIndex = 0;
 static bool g_publishing;
 
+// Publications are kept in the offline buffer while broker is not reachable and
+// replayed after reconnect to "<hostname>/replay/..." topics with "[<UTC timestamp>, <payload>]" payload.
+// When SDRAM buffer is full, the oldest records are moved to the SD card (if enabled)
+// or dropped. All the records on the SD card are older than the ones in SDRAM.
+
+static const char *OFFLINE_SPILL_FILE_PATH = "/MQTT/offline.dat";
+static const uint32_t OFFLINE_SPILL_CHUNK = 1024; // number of records moved to the SD card at once
+static const uint32_t OFFLINE_SPILL_MAX_RECORDS = 1024 * 1024;
+
+enum OfflineRecordType {
+    OFFLINE_RECORD_POW,
+    OFFLINE_RECORD_EVENT,
+    OFFLINE_RECORD_OE,
+    OFFLINE_RECORD_U_MON,
+    OFFLINE_RECORD_I_MON,
+    OFFLINE_RECORD_U_SET,
+    OFFLINE_RECORD_I_SET
+};
+
+struct OfflineRecord {
+    uint32_t timestamp; // UTC
+    uint8_t type;
+    uint8_t channelIndex;
+    int16_t eventId;
+    float value;
+};
+
+static OfflineRecord * const g_offlineRecords = (OfflineRecord *)MQTT_OFFLINE_BUFFER;
+static const uint32_t OFFLINE_BUFFER_CAPACITY = MQTT_OFFLINE_BUFFER_SIZE / sizeof(OfflineRecord);
+
+// buffer is spilled to the SD card in chunks, so there must be room for two of them
+static_assert(OFFLINE_BUFFER_CAPACITY >= 2 * OFFLINE_SPILL_CHUNK, "MQTT_OFFLINE_BUFFER_SIZE too small");
+
+static uint32_t g_offlineTail; // index of the oldest record
+static uint32_t g_offlineCount;
+
+// records on the SD card, read position and count are in records
+static uint32_t g_spillReadPosition;
+static uint32_t g_spillCount;
+
+static const uint32_t REPLAY_CACHE_SIZE = 32;
+static OfflineRecord g_replayCache[REPLAY_CACHE_SIZE];
+static uint32_t g_replayCacheIndex;
+static uint32_t g_replayCacheCount;
+
+static uint32_t g_numDropped;
+static uint32_t g_numReplayed;
+static volatile bool g_clearOfflineBufferRequested;
+
+static uint32_t g_lastReplayTick;
+
+// last buffered values, so only changes are buffered
+static bool g_offlineStateValid;
+static struct {
+    int pow;
+    uint32_t tick;
+    struct {
+        int oe;
+        float uSet;
+        float iSet;
+    } channels[CH_MAX];
+} g_offlineState;
+
+float g_replayRate = REPLAY_RATE_DEFAULT;
+bool g_offlineSpillEnabled = false;
+
 enum {
     EEZ_MQTT_ERROR_NONE,
     EEZ_MQTT_ERROR_DNS,
@@ -523,6 +594,248 @@ bool publishOnTimeCounter(int channelIndex, const char *pubTopic, uint32_t value
     return publish(topic, payload, retain);
 }
 
+////////////////////////////////////////////////////////////////////////////////
+
+static void initOfflineState() {
+    g_offlineStateValid = true;
+    g_offlineState.pow = -1;
+    g_offlineState.tick = millis();
+    for (int i = 0; i < CH_MAX; i++) {
+        g_offlineState.channels[i].oe = -1;
+        g_offlineState.channels[i].uSet = NAN;
+        g_offlineState.channels[i].iSet = NAN;
+    }
+}
+
+static void removeSpillFile() {
+    if (g_spillCount > 0) {
+        sd_card::deleteFile(OFFLINE_SPILL_FILE_PATH, nullptr);
+    }
+    g_spillReadPosition = 0;
+    g_spillCount = 0;
+    g_replayCacheIndex = 0;
+    g_replayCacheCount = 0;
+}
+
+static bool writeOfflineRecords(File &file, uint32_t index, uint32_t count) {
+    size_t size = count * sizeof(OfflineRecord);
+    return file.write(g_offlineRecords + index, size) == size;
+}
+
+// moves the oldest OFFLINE_SPILL_CHUNK records from SDRAM to the SD card
+static bool spillOfflineRecords() {
+    if (!g_offlineSpillEnabled || g_spillCount + OFFLINE_SPILL_CHUNK > OFFLINE_SPILL_MAX_RECORDS) {
+        return false;
+    }
+
+    if (!sd_card::isMounted(nullptr) || !sd_card::makeParentDir(OFFLINE_SPILL_FILE_PATH, nullptr)) {
+        return false;
+    }
+
+    File file;
+    if (g_spillCount == 0) {
+        if (!file.open(OFFLINE_SPILL_FILE_PATH, FILE_CREATE_ALWAYS | FILE_WRITE)) {
+            return false;
+        }
+    } else {
+        if (!file.open(OFFLINE_SPILL_FILE_PATH, FILE_OPEN_EXISTING | FILE_WRITE)) {
+            return false;
+        }
+        file.seek(g_spillCount * sizeof(OfflineRecord));
+    }
+
+    uint32_t count1 = MIN(OFFLINE_SPILL_CHUNK, OFFLINE_BUFFER_CAPACITY - g_offlineTail);
+    bool result = writeOfflineRecords(file, g_offlineTail, count1);
+    if (result && count1 < OFFLINE_SPILL_CHUNK) {
+        result = writeOfflineRecords(file, 0, OFFLINE_SPILL_CHUNK - count1);
+    }
+
+    file.close();
+
+    if (!result) {
+        return false;
+    }
+
+    g_offlineTail = (g_offlineTail + OFFLINE_SPILL_CHUNK) % OFFLINE_BUFFER_CAPACITY;
+    g_offlineCount -= OFFLINE_SPILL_CHUNK;
+    g_spillCount += OFFLINE_SPILL_CHUNK;
+
+    return true;
+}
+
+static void bufferOfflineRecord(uint8_t type, uint8_t channelIndex, float value, int16_t eventId = 0) {
+    if (g_offlineCount == OFFLINE_BUFFER_CAPACITY && !spillOfflineRecords()) {
+        // drop the oldest record
+        g_offlineTail = (g_offlineTail + 1) % OFFLINE_BUFFER_CAPACITY;
+        g_offlineCount--;
+        g_numDropped++;
+    }
+
+    OfflineRecord &record = g_offlineRecords[(g_offlineTail + g_offlineCount) % OFFLINE_BUFFER_CAPACITY];
+    record.timestamp = datetime::nowUtc();
+    record.type = type;
+    record.channelIndex = channelIndex;
+    record.eventId = eventId;
+    record.value = value;
+
+    g_offlineCount++;
+}
+
+static void bufferOfflineMeasurements(uint32_t tickCount) {
+    if (!g_isBooted) {
+        return;
+    }
+
+    if (!g_offlineStateValid) {
+        initOfflineState();
+    }
+
+    int powState = isPowerUp() ? 1 : 0;
+    if (powState != g_offlineState.pow) {
+        bufferOfflineRecord(OFFLINE_RECORD_POW, 0, (float)powState);
+        g_offlineState.pow = powState;
+    }
+
+    uint32_t period = (uint32_t)roundf(persist_conf::devConf.mqttPeriod * 1000);
+    if (tickCount - g_offlineState.tick < period) {
+        return;
+    }
+    g_offlineState.tick = tickCount;
+
+    for (int i = 0; i < CH_NUM; i++) {
+        Channel &channel = Channel::get(i);
+        auto &state = g_offlineState.channels[i];
+
+        int oe = channel.isOutputEnabled() ? 1 : 0;
+        if (oe != state.oe) {
+            bufferOfflineRecord(OFFLINE_RECORD_OE, i, (float)oe);
+            state.oe = oe;
+        }
+
+        float uSet = channel_dispatcher::getUSet(channel);
+        if (isNaN(state.uSet) || uSet != state.uSet) {
+            bufferOfflineRecord(OFFLINE_RECORD_U_SET, i, uSet);
+            state.uSet = uSet;
+        }
+
+        float iSet = channel_dispatcher::getISet(channel);
+        if (isNaN(state.iSet) || iSet != state.iSet) {
+            bufferOfflineRecord(OFFLINE_RECORD_I_SET, i, iSet);
+            state.iSet = iSet;
+        }
+
+        if (oe) {
+            bufferOfflineRecord(OFFLINE_RECORD_U_MON, i, channel_dispatcher::getUMonLast(channel));
+            bufferOfflineRecord(OFFLINE_RECORD_I_MON, i, channel_dispatcher::getIMonLast(channel));
+        }
+    }
+}
+
+static bool peekOfflineRecord(OfflineRecord &record) {
+    if (g_spillReadPosition < g_spillCount) {
+        if (g_replayCacheIndex == g_replayCacheCount) {
+            uint32_t count = MIN(REPLAY_CACHE_SIZE, g_spillCount - g_spillReadPosition);
+
+            File file;
+            bool result = false;
+            if (sd_card::isMounted(nullptr) && file.open(OFFLINE_SPILL_FILE_PATH, FILE_OPEN_EXISTING | FILE_READ)) {
+                result = file.seek(g_spillReadPosition * sizeof(OfflineRecord)) &&
+                    file.read(g_replayCache, count * sizeof(OfflineRecord)) == count * sizeof(OfflineRecord);
+                file.close();
+            }
+
+            if (!result) {
+                // SD card is removed or file is damaged, what is left there is lost
+                g_numDropped += g_spillCount - g_spillReadPosition;
+                removeSpillFile();
+                return peekOfflineRecord(record);
+            }
+
+            g_replayCacheIndex = 0;
+            g_replayCacheCount = count;
+        }
+
+        record = g_replayCache[g_replayCacheIndex];
+        return true;
+    }
+
+    if (g_offlineCount > 0) {
+        record = g_offlineRecords[g_offlineTail];
+        return true;
+    }
+
+    return false;
+}
+
+static void popOfflineRecord() {
+    if (g_spillReadPosition < g_spillCount) {
+        g_replayCacheIndex++;
+        if (++g_spillReadPosition == g_spillCount) {
+            removeSpillFile();
+        }
+    } else {
+        g_offlineTail = (g_offlineTail + 1) % OFFLINE_BUFFER_CAPACITY;
+        g_offlineCount--;
+    }
+
+    g_numReplayed++;
+}
+
+static bool publishOfflineRecord(const OfflineRecord &record) {
+    char hostName[ETHERNET_HOST_NAME_SIZE + 8 + 1];
+    snprintf(hostName, sizeof(hostName), "%s/replay", persist_conf::devConf.ethernetHostName);
+
+    char topic[MAX_PUB_TOPIC_LENGTH + 1];
+    char value[MAX_PAYLOAD_LENGTH + 1];
+
+    if (record.type == OFFLINE_RECORD_POW) {
+        snprintf(topic, sizeof(topic), PUB_TOPIC_SYSTEM_POW, hostName);
+        snprintf(value, sizeof(value), "%d", (int)record.value);
+    } else if (record.type == OFFLINE_RECORD_EVENT) {
+        snprintf(topic, sizeof(topic), PUB_TOPIC_SYSTEM_EVENT, hostName);
+        snprintf(value, sizeof(value), "[%d, \"%s\", \"%s\"]", (int)record.eventId, event_queue::getEventTypeName(record.eventId), event_queue::getEventMessage(record.eventId));
+    } else {
+        const char *pubTopic;
+        if (record.type == OFFLINE_RECORD_OE) {
+            pubTopic = PUB_TOPIC_DCPSUPPLY_OE;
+        } else if (record.type == OFFLINE_RECORD_U_MON) {
+            pubTopic = PUB_TOPIC_DCPSUPPLY_U_MON;
+        } else if (record.type == OFFLINE_RECORD_I_MON) {
+            pubTopic = PUB_TOPIC_DCPSUPPLY_I_MON;
+        } else if (record.type == OFFLINE_RECORD_U_SET) {
+            pubTopic = PUB_TOPIC_DCPSUPPLY_U_SET;
+        } else {
+            pubTopic = PUB_TOPIC_DCPSUPPLY_I_SET;
+        }
+        snprintf(topic, sizeof(topic), pubTopic, hostName, record.channelIndex + 1);
+
+        if (record.type == OFFLINE_RECORD_OE) {
+            snprintf(value, sizeof(value), "%d", (int)record.value);
+        } else {
+            snprintf(value, sizeof(value), "%g", record.value);
+        }
+    }
+
+    char payload[MAX_PAYLOAD_LENGTH + 16 + 1];
+    snprintf(payload, sizeof(payload), "[%lu, %s]", (unsigned long)record.timestamp, value);
+
+    return publish(topic, payload, false);
+}
+
+void getOfflineBufferStatistics(OfflineBufferStatistics &statistics) {
+    statistics.numSpilled = g_spillCount - g_spillReadPosition;
+    statistics.numBuffered = g_offlineCount + statistics.numSpilled;
+    statistics.numDropped = g_numDropped;
+    statistics.numReplayed = g_numReplayed;
+}
+
+void clearOfflineBuffer() {
+    // buffer is accessed only from the ethernet thread, it will be cleared in tick()
+    g_clearOfflineBufferRequested = true;
+}
+
+////////////////////////////////////////////////////////////////////////////////
+
 const char *getClientId() {
     static char g_clientId[50 + 1] = { 0 };
 
@@ -578,6 +891,9 @@ void setState(ConnectionState connectionState) {
 
         g_lastChannelIndex = 0;
         g_lastValueIndex = 0;
+
+        // buffer complete state on the next disconnect
+        g_offlineStateValid = false;
     }
 
     g_connectionState = connectionState;
@@ -587,6 +903,19 @@ void setState(ConnectionState connectionState) {
 void tick() {
     uint32_t tickCount = millis();
 
+    if (g_clearOfflineBufferRequested) {
+        g_clearOfflineBufferRequested = false;
+        removeSpillFile();
+        g_offlineTail = 0;
+        g_offlineCount = 0;
+        g_numDropped = 0;
+        g_numReplayed = 0;
+    }
+
+    if (persist_conf::devConf.mqttEnabled && g_connectionState != CONNECTION_STATE_CONNECTED) {
+        bufferOfflineMeasurements(tickCount);
+    }
+
     if (ethernet::g_testResult != TEST_OK) {
         if (g_connectionState != CONNECTION_STATE_IDLE && g_connectionState != CONNECTION_STATE_ETHERNET_NOT_READY) {
 			setState(CONNECTION_STATE_ETHERNET_NOT_CONNECTED);
@@ -631,6 +960,18 @@ void tick() {
             }
         }
 
+        // replay publications buffered while broker was not reachable
+        if (tickCount - g_lastReplayTick >= (uint32_t)roundf(1000.0f / g_replayRate)) {
+            OfflineRecord record;
+            if (peekOfflineRecord(record) && publishOfflineRecord(record)) {
+                popOfflineRecord();
+                g_lastReplayTick = tickCount;
+                if (g_publishing) {
+                    return;
+                }
+            }
+        }
+
         // publish battery
         if (mcu::battery::g_battery != g_battery) {
             if (publish(PUB_TOPIC_SYSTEM_BATTERY, mcu::battery::g_battery, true)) {
@@ -975,6 +1316,11 @@ void pushEvent(int16_t eventId) {
         return;
     }
 
+    if (persist_conf::devConf.mqttEnabled && g_connectionState != CONNECTION_STATE_CONNECTED) {
+        bufferOfflineRecord(OFFLINE_RECORD_EVENT, 0, 0, eventId);
+        return;
+    }
+
     g_eventQueue.buffer[g_eventQueue.head] = eventId;
 
     // advance
@@ -40,7 +40,25 @@ static const float PERIOD_MIN = 0.1f;
 static const float PERIOD_MAX = 120.0f;
 static const float PERIOD_DEFAULT = 1.0f;
 
+// messages per second replayed from the offline buffer
+static const float REPLAY_RATE_MIN = 1.0f;
+static const float REPLAY_RATE_MAX = 100.0f;
+static const float REPLAY_RATE_DEFAULT = 10.0f;
+
 extern ConnectionState g_connectionState;
+
+extern float g_replayRate;
+extern bool g_offlineSpillEnabled; // move overflow of the offline buffer to the SD card
+
+struct OfflineBufferStatistics {
+    uint32_t numBuffered; // waiting for replay, including the ones on the SD card
+    uint32_t numSpilled; // waiting for replay on the SD card
+    uint32_t numDropped;
+    uint32_t numReplayed;
+};
+
+void getOfflineBufferStatistics(OfflineBufferStatistics &statistics);
+void clearOfflineBuffer();
     
 void tick();
 void reconnect();
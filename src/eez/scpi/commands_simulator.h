@@ -33,9 +33,11 @@
     SCPI_COMMAND("CALibration[:MODE]?", scpi_cmd_calibrationModeQ) \
     SCPI_COMMAND("CALibration:SCReen:INIT", scpi_cmd_calibrationScreenInit) \
     SCPI_COMMAND("DIAGnostic[:INFOrmation]:ADC?", scpi_cmd_diagnosticInformationAdcQ) \
+    SCPI_COMMAND("DIAGnostic[:INFOrmation]:ADC:STATistics?", scpi_cmd_diagnosticInformationAdcStatisticsQ) \
     SCPI_COMMAND("DIAGnostic[:INFOrmation]:CALibration?", scpi_cmd_diagnosticInformationCalibrationQ) \
     SCPI_COMMAND("DIAGnostic[:INFOrmation]:PROTection?", scpi_cmd_diagnosticInformationProtectionQ) \
     SCPI_COMMAND("DIAGnostic[:INFOrmation]:TEST?", scpi_cmd_diagnosticInformationTestQ) \
+    SCPI_COMMAND("DIAGnostic[:INFOrmation]:TICK?", scpi_cmd_diagnosticInformationTickQ) \
     SCPI_COMMAND("DIAGnostic[:INFOrmation]:REGS?", scpi_cmd_diagnosticInformationRegsQ) \
     SCPI_COMMAND("DISPlay:BRIGhtness", scpi_cmd_displayBrightness) \
     SCPI_COMMAND("DISPlay:BRIGhtness?", scpi_cmd_displayBrightnessQ) \
@@ -47,6 +49,7 @@
     SCPI_COMMAND("DISPlay[:WINdow][:STATe]", scpi_cmd_displayWindowState) \
     SCPI_COMMAND("DISPlay[:WINdow][:STATe]?", scpi_cmd_displayWindowStateQ) \
     SCPI_COMMAND("DISPlay:DATA?", scpi_cmd_displayDataQ) \
+    SCPI_COMMAND("DISPlay:DATA:DELTa?", scpi_cmd_displayDataDeltaQ) \
     SCPI_COMMAND("DISPlay[:WINdow]:DLOG", scpi_cmd_displayWindowDlog) \
     SCPI_COMMAND("DISPlay[:WINdow]:INPut?", scpi_cmd_displayWindowInputQ) \
     SCPI_COMMAND("DISPlay[:WINdow]:SELect?", scpi_cmd_displayWindowSelectQ) \
@@ -55,6 +58,12 @@
     SCPI_COMMAND("DISPlay[:WINdow]:DIALog:DATA", scpi_cmd_displayWindowDialogData) \
     SCPI_COMMAND("DISPlay[:WINdow]:DIALog:CLOSe", scpi_cmd_displayWindowDialogClose) \
     SCPI_COMMAND("DISPlay[:WINdow]:ERRor", scpi_cmd_displayWindowError) \
+    SCPI_COMMAND("FETCh:DLOG?", scpi_cmd_fetchDlogQ) \
+    SCPI_COMMAND("FETCh:DLOG:STReam", scpi_cmd_fetchDlogStream) \
+    SCPI_COMMAND("FETCh:DLOG:STReam?", scpi_cmd_fetchDlogStreamQ) \
+    SCPI_COMMAND("FETCh:HISTory?", scpi_cmd_fetchHistoryQ) \
+    SCPI_COMMAND("FETCh:HISTory:STReam", scpi_cmd_fetchHistoryStream) \
+    SCPI_COMMAND("FETCh:HISTory:STReam?", scpi_cmd_fetchHistoryStreamQ) \
     SCPI_COMMAND("INITiate:CONTinuous", scpi_cmd_initiateContinuous) \
     SCPI_COMMAND("INITiate:CONTinuous?", scpi_cmd_initiateContinuousQ) \
     SCPI_COMMAND("INITiate:DLOG", scpi_cmd_initiateDlog) \
@@ -110,6 +119,10 @@
     SCPI_COMMAND("MMEMory:DOWNload:DATA", scpi_cmd_mmemoryDownloadData) \
     SCPI_COMMAND("MMEMory:DOWNload:FNAMe", scpi_cmd_mmemoryDownloadFname) \
     SCPI_COMMAND("MMEMory:DOWNload:SIZE", scpi_cmd_mmemoryDownloadSize) \
+    SCPI_COMMAND("MMEMory:EXPort:ABORt", scpi_cmd_mmemoryExportAbort) \
+    SCPI_COMMAND("MMEMory:EXPort:CSV", scpi_cmd_mmemoryExportCsv) \
+    SCPI_COMMAND("MMEMory:EXPort:PROGress?", scpi_cmd_mmemoryExportProgressQ) \
+    SCPI_COMMAND("MMEMory:EXPort:STATe?", scpi_cmd_mmemoryExportStateQ) \
     SCPI_COMMAND("MMEMory:INFOrmation?", scpi_cmd_mmemoryInformationQ) \
     SCPI_COMMAND("MMEMory:LOAD:LIST#", scpi_cmd_mmemoryLoadList) \
     SCPI_COMMAND("MMEMory:LOAD:PROFile", scpi_cmd_mmemoryLoadProfile) \
@@ -196,6 +209,8 @@
     SCPI_COMMAND("[SOURce#]:CURRent:PROTection:TRIPped?", scpi_cmd_sourceCurrentProtectionTrippedQ) \
     SCPI_COMMAND("[SOURce#]:CURRent:RAMP:DURation", scpi_cmd_sourceCurrentRampDuration) \
     SCPI_COMMAND("[SOURce#]:CURRent:RAMP:DURation?", scpi_cmd_sourceCurrentRampDurationQ) \
+    SCPI_COMMAND("[SOURce#]:CURRent:RAMP:SHAPe", scpi_cmd_sourceCurrentRampShape) \
+    SCPI_COMMAND("[SOURce#]:CURRent:RAMP:SHAPe?", scpi_cmd_sourceCurrentRampShapeQ) \
     SCPI_COMMAND("[SOURce#]:CURRent[:LEVel]:TRIGgered[:AMPLitude]", scpi_cmd_sourceCurrentLevelTriggeredAmplitude) \
     SCPI_COMMAND("[SOURce#]:CURRent[:LEVel]:TRIGgered[:AMPLitude]?", scpi_cmd_sourceCurrentLevelTriggeredAmplitudeQ) \
     SCPI_COMMAND("[SOURce#]:CURRent[:LEVel][:IMMediate]:STEP[:INCRement]", scpi_cmd_sourceCurrentLevelImmediateStepIncrement) \
@@ -208,6 +223,9 @@
     SCPI_COMMAND("[SOURce#]:LIST:CURRent[:LEVel]?", scpi_cmd_sourceListCurrentLevelQ) \
     SCPI_COMMAND("[SOURce#]:LIST:DWELl", scpi_cmd_sourceListDwell) \
     SCPI_COMMAND("[SOURce#]:LIST:DWELl?", scpi_cmd_sourceListDwellQ) \
+    SCPI_COMMAND("[SOURce#]:LIST:TIMing", scpi_cmd_sourceListTiming) \
+    SCPI_COMMAND("[SOURce#]:LIST:TIMing?", scpi_cmd_sourceListTimingQ) \
+    SCPI_COMMAND("[SOURce#]:LIST:TIMing:ERRor?", scpi_cmd_sourceListTimingErrorQ) \
     SCPI_COMMAND("[SOURce#]:LIST:VOLTage[:LEVel]", scpi_cmd_sourceListVoltageLevel) \
     SCPI_COMMAND("[SOURce#]:LIST:VOLTage[:LEVel]?", scpi_cmd_sourceListVoltageLevelQ) \
     SCPI_COMMAND("[SOURce#]:POWer:LIMit", scpi_cmd_sourcePowerLimit) \
@@ -236,6 +254,8 @@
     SCPI_COMMAND("[SOURce#]:VOLTage:PROTection[:LEVel]?", scpi_cmd_sourceVoltageProtectionLevelQ) \
     SCPI_COMMAND("[SOURce#]:VOLTage:RAMP:DURation", scpi_cmd_sourceVoltageRampDuration) \
     SCPI_COMMAND("[SOURce#]:VOLTage:RAMP:DURation?", scpi_cmd_sourceVoltageRampDurationQ) \
+    SCPI_COMMAND("[SOURce#]:VOLTage:RAMP:SHAPe", scpi_cmd_sourceVoltageRampShape) \
+    SCPI_COMMAND("[SOURce#]:VOLTage:RAMP:SHAPe?", scpi_cmd_sourceVoltageRampShapeQ) \
     SCPI_COMMAND("[SOURce#]:VOLTage:SENSe[:SOURce]", scpi_cmd_sourceVoltageSenseSource) \
     SCPI_COMMAND("[SOURce#]:VOLTage:SENSe[:SOURce]?", scpi_cmd_sourceVoltageSenseSourceQ) \
     SCPI_COMMAND("[SOURce#]:VOLTage[:LEVel]:TRIGgered[:AMPLitude]", scpi_cmd_sourceVoltageLevelTriggeredAmplitude) \
@@ -321,6 +341,12 @@
     SCPI_COMMAND("SYSTem:COMMunicate:ETHernet:PORT?", scpi_cmd_systemCommunicateEthernetPortQ) \
     SCPI_COMMAND("SYSTem:COMMunicate:ETHernet:SMASk", scpi_cmd_systemCommunicateEthernetSmask) \
     SCPI_COMMAND("SYSTem:COMMunicate:ETHernet:SMASk?", scpi_cmd_systemCommunicateEthernetSmaskQ) \
+    SCPI_COMMAND("SYSTem:COMMunicate:MQTT:BUFFer:CLEar", scpi_cmd_systemCommunicateMqttBufferClear) \
+    SCPI_COMMAND("SYSTem:COMMunicate:MQTT:BUFFer:RATE", scpi_cmd_systemCommunicateMqttBufferRate) \
+    SCPI_COMMAND("SYSTem:COMMunicate:MQTT:BUFFer:RATE?", scpi_cmd_systemCommunicateMqttBufferRateQ) \
+    SCPI_COMMAND("SYSTem:COMMunicate:MQTT:BUFFer:SPILl", scpi_cmd_systemCommunicateMqttBufferSpill) \
+    SCPI_COMMAND("SYSTem:COMMunicate:MQTT:BUFFer:SPILl?", scpi_cmd_systemCommunicateMqttBufferSpillQ) \
+    SCPI_COMMAND("SYSTem:COMMunicate:MQTT:BUFFer:STATistics?", scpi_cmd_systemCommunicateMqttBufferStatisticsQ) \
     SCPI_COMMAND("SYSTem:COMMunicate:MQTT:SETTings", scpi_cmd_systemCommunicateMqttSettings) \
     SCPI_COMMAND("SYSTem:COMMunicate:MQTT:STATe?", scpi_cmd_systemCommunicateMqttStateQ) \
     SCPI_COMMAND("SYSTem:COMMunicate:NTP", scpi_cmd_systemCommunicateNtp) \
@@ -364,6 +390,7 @@
     SCPI_COMMAND("SYSTem:INHibit?", scpi_cmd_systemInhibitQ) \
     SCPI_COMMAND("SYSTem:KLOCk", scpi_cmd_systemKlock) \
     SCPI_COMMAND("SYSTem:LOCal", scpi_cmd_systemLocal) \
+    SCPI_COMMAND("SYSTem:LOG:FIND?", scpi_cmd_systemLogFindQ) \
     SCPI_COMMAND("SYSTem:MEASure[:SCALar]:TEMPerature[:THERmistor][:DC]?", scpi_cmd_systemMeasureScalarTemperatureThermistorDcQ) \
     SCPI_COMMAND("SYSTem:MEASure[:SCALar][:VOLTage][:DC]?", scpi_cmd_systemMeasureScalarVoltageDcQ) \
     SCPI_COMMAND("SYSTem:PASSword:CALibration:RESet", scpi_cmd_systemPasswordCalibrationReset) \
@@ -399,6 +426,8 @@
     SCPI_COMMAND("SYSTem:TEMPerature:PROTection[:HIGH]:TRIPped?", scpi_cmd_systemTemperatureProtectionHighTrippedQ) \
     SCPI_COMMAND("SYSTem:TEMPerature:PROTection[:HIGH][:LEVel]", scpi_cmd_systemTemperatureProtectionHighLevel) \
     SCPI_COMMAND("SYSTem:TEMPerature:PROTection[:HIGH][:LEVel]?", scpi_cmd_systemTemperatureProtectionHighLevelQ) \
+    SCPI_COMMAND("SYSTem:TEMPerature:SRATe?", scpi_cmd_systemTemperatureSrateQ) \
+    SCPI_COMMAND("SYSTem:TEMPerature:TIMing?", scpi_cmd_systemTemperatureTimingQ) \
     SCPI_COMMAND("SYSTem:TIME", scpi_cmd_systemTime) \
     SCPI_COMMAND("SYSTem:TIME:DST", scpi_cmd_systemTimeDst) \
     SCPI_COMMAND("SYSTem:TIME:DST?", scpi_cmd_systemTimeDstQ) \
@@ -413,12 +442,21 @@
     SCPI_COMMAND("TRIGger[:SEQuence]:DELay?", scpi_cmd_triggerSequenceDelayQ) \
     SCPI_COMMAND("TRIGger[:SEQuence]:EXIT:CONDition", scpi_cmd_triggerSequenceExitCondition) \
     SCPI_COMMAND("TRIGger[:SEQuence]:EXIT:CONDition?", scpi_cmd_triggerSequenceExitConditionQ) \
+    SCPI_COMMAND("TRIGger[:SEQuence]:LATency:ARM?", scpi_cmd_triggerSequenceLatencyArmQ) \
+    SCPI_COMMAND("TRIGger[:SEQuence]:LATency:CLEar", scpi_cmd_triggerSequenceLatencyClear) \
+    SCPI_COMMAND("TRIGger[:SEQuence]:LATency?", scpi_cmd_triggerSequenceLatencyQ) \
     SCPI_COMMAND("TRIGger[:SEQuence]:SOURce", scpi_cmd_triggerSequenceSource) \
     SCPI_COMMAND("TRIGger[:SEQuence]:SOURce?", scpi_cmd_triggerSequenceSourceQ) \
     SCPI_COMMAND("TRIGger[:SEQuence][:IMMediate]", scpi_cmd_triggerSequenceImmediate) \
     SCPI_COMMAND("APPLy", scpi_cmd_apply) \
     SCPI_COMMAND("APPLy?", scpi_cmd_applyQ) \
     SCPI_COMMAND("DEBUg?", scpi_cmd_debugQ) \
+    SCPI_COMMAND("SIMUlator:ADC:PROTection?", scpi_cmd_simulatorAdcProtectionQ) \
+    SCPI_COMMAND("SIMUlator:ADC:RECord", scpi_cmd_simulatorAdcRecord) \
+    SCPI_COMMAND("SIMUlator:ADC:REPLay", scpi_cmd_simulatorAdcReplay) \
+    SCPI_COMMAND("SIMUlator:ADC:STATe?", scpi_cmd_simulatorAdcStateQ) \
+    SCPI_COMMAND("SIMUlator:ADC:STATistics?", scpi_cmd_simulatorAdcStatisticsQ) \
+    SCPI_COMMAND("SIMUlator:ADC:STOP", scpi_cmd_simulatorAdcStop) \
     SCPI_COMMAND("SIMUlator:EXIT", scpi_cmd_simulatorExit) \
     SCPI_COMMAND("SIMUlator:GUI", scpi_cmd_simulatorGui) \
     SCPI_COMMAND("SIMUlator:LOAD", scpi_cmd_simulatorLoad) \
@@ -426,8 +464,10 @@
     SCPI_COMMAND("SIMUlator:LOAD:STATe?", scpi_cmd_simulatorLoadStateQ) \
     SCPI_COMMAND("SIMUlator:LOAD?", scpi_cmd_simulatorLoadQ) \
     SCPI_COMMAND("SIMUlator:PIN1", scpi_cmd_simulatorPin1) \
+    SCPI_COMMAND("SIMUlator:PIN1:PULSe", scpi_cmd_simulatorPin1Pulse) \
     SCPI_COMMAND("SIMUlator:PIN1?", scpi_cmd_simulatorPin1Q) \
     SCPI_COMMAND("SIMUlator:PIN2", scpi_cmd_simulatorPin2) \
+    SCPI_COMMAND("SIMUlator:PIN2:PULSe", scpi_cmd_simulatorPin2Pulse) \
     SCPI_COMMAND("SIMUlator:PIN2?", scpi_cmd_simulatorPin2Q) \
     SCPI_COMMAND("SIMUlator:PWRGood", scpi_cmd_simulatorPwrgood) \
     SCPI_COMMAND("SIMUlator:PWRGood?", scpi_cmd_simulatorPwrgoodQ) \
@@ -455,5 +495,16 @@
     SCPI_COMMAND("DEBUg:DCM220?", scpi_cmd_debugDcm220Q) \
     SCPI_COMMAND("DEBUg:DOWNload:FIRMware", scpi_cmd_debugDownloadFirmware) \
     SCPI_COMMAND("DEBUg:EVENt", scpi_cmd_debugEvent) \
+    SCPI_COMMAND("DEBUg:DISPlay:BENChmark?", scpi_cmd_debugDisplayBenchmarkQ) \
+    SCPI_COMMAND("DEBUg:DISPlay:TEXT:CACHe?", scpi_cmd_debugDisplayTextCacheQ) \
+    SCPI_COMMAND("DEBUg:DISPlay:TEXT:CACHe:RESet", scpi_cmd_debugDisplayTextCacheReset) \
+    SCPI_COMMAND("DEBUg:DISPatcher:BENChmark?", scpi_cmd_debugDispatcherBenchmarkQ) \
+    SCPI_COMMAND("DEBUg:DLOG:EXPort:BENChmark?", scpi_cmd_debugDlogExportBenchmarkQ) \
+    SCPI_COMMAND("DEBUg:DLOG:VIEW:CACHe?", scpi_cmd_debugDlogViewCacheQ) \
+    SCPI_COMMAND("DEBUg:DLOG:VIEW:CACHe:RESet", scpi_cmd_debugDlogViewCacheReset) \
+    SCPI_COMMAND("DEBUg:FPGA:JTAG:TEST?", scpi_cmd_debugFpgaJtagTestQ) \
+    SCPI_COMMAND("DEBUg:PROFile:BENChmark?", scpi_cmd_debugProfileBenchmarkQ) \
+    SCPI_COMMAND("DEBUg:RAMP:SHAPe:TEST?", scpi_cmd_debugRampShapeTestQ) \
+    SCPI_COMMAND("DEBUg:SERial:BENChmark?", scpi_cmd_debugSerialBenchmarkQ) \
     SCPI_COMMAND("SYSTem:DATE:CLEar", scpi_cmd_systemDateClear) \
     SCPI_COMMAND("SYSTem:TIME:CLEar", scpi_cmd_systemTimeClear)
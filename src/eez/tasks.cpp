@@ -32,6 +32,7 @@
 #include <eez/modules/psu/datetime.h>
 #include <eez/modules/psu/dlog_record.h>
 #include <eez/modules/psu/dlog_view.h>
+#include <eez/modules/psu/dlog_export.h>
 #if OPTION_ETHERNET
 #include <eez/modules/psu/ethernet.h>
 #endif
@@ -44,6 +45,7 @@
 
 #include <eez/modules/psu/gui/psu.h>
 #include <eez/modules/psu/gui/file_manager.h>
+#include <eez/modules/psu/gui/thumbnail_cache.h>
 #include <eez/modules/psu/gui/page_ch_settings.h>
 #include <eez/modules/psu/gui/page_user_profiles.h>
 
@@ -213,6 +215,14 @@ void sendMessageToPsu(HighPriorityThreadMessage messageType, uint32_t messagePar
 #endif
 }
 
+bool postMessageToPsu(HighPriorityThreadMessage messageType, uint32_t messageParam) {
+    if (!g_highPriorityMessageQueueId) {
+        return false;
+    }
+
+    return osMessagePut(g_highPriorityMessageQueueId, QUEUE_MESSAGE(messageType, messageParam), 0) == osOK;
+}
+
 ////////////////////////////////////////////////////////////////////////////////
 
 void initLowPriorityMessageQueue() {
@@ -248,7 +258,8 @@ void lowPriorityThreadMainLoop(const void *) {
 void lowPriorityThreadOneIter() {
     using namespace psu;
 
-    osEvent event = osMessageGet(g_lowPriorityMessageQueueId, 25);
+    // don't wait for the message while export is in progress
+    osEvent event = osMessageGet(g_lowPriorityMessageQueueId, psu::dlog_export::isExporting() ? 0 : 25);
     if (event.status == osEventMessage) {
     	uint32_t message = event.value.v;
 
@@ -361,6 +372,10 @@ void lowPriorityThreadOneIter() {
                 g_screenshotGenerating = false;
             } else if (type == THREAD_MESSAGE_FILE_MANAGER_LOAD_DIRECTORY) {
                 file_manager::doLoadDirectory();
+            } else if (type == THREAD_MESSAGE_FILE_MANAGER_LOAD_DESCRIPTIONS) {
+                file_manager::doLoadDescriptions();
+            } else if (type == THREAD_MESSAGE_FILE_MANAGER_LOAD_THUMBNAILS) {
+                thumbnail_cache::doLoadThumbnails();
             } else if (type == THREAD_MESSAGE_FILE_MANAGER_UPLOAD_FILE) {
                 file_manager::uploadFile();
             } else if (type == THREAD_MESSAGE_FILE_MANAGER_OPEN_IMAGE_FILE) {
@@ -454,6 +469,10 @@ void lowPriorityThreadOneIter() {
 
         eez::psu::dlog_record::fileWrite();
 
+        psu::scpi::fetchStreamTick();
+
+        psu::dlog_export::tick();
+
         eez::hmi::tick(tickCount);
 
         usb::tick(tickCount);
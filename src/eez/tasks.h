@@ -42,6 +42,7 @@ enum HighPriorityThreadMessage {
     PSU_MESSAGE_SHUTDOWN,
     PSU_MESSAGE_SET_VOLTAGE,
     PSU_MESSAGE_SET_CURRENT,
+    PSU_MESSAGE_SET_VOLTAGE_AND_CURRENT,
     PSU_MESSAGE_RESET_CHANNELS_HISTORY,
     PSU_MESSAGE_CALIBRATION_START,
     PSU_MESSAGE_CALIBRATION_SELECT_CURRENT_RANGE,
@@ -57,6 +58,12 @@ enum HighPriorityThreadMessage {
     PSU_MESSAGE_REMOTE_PROGRAMMING_ENABLE,
     PSU_MESSAGE_SET_DPROG_STATE,
     PSU_MESSAGE_SAVE_SERIAL_NO,
+    PSU_MESSAGE_IO_PIN_EDGE,
+    PSU_MESSAGE_LIST_STEP,
+    PSU_MESSAGE_TEMPERATURE_PROTECTION_ENTER,
+    PSU_MESSAGE_LIMIT_MAX_CURRENT,
+    PSU_MESSAGE_FAN_TICK,
+    PSU_MESSAGE_READ_AUX_TEMPERATURE,
 
     // this must be at the end
     PSU_MESSAGE_MODULE_SPECIFIC,
@@ -88,6 +95,8 @@ enum LowPriorityThreadMessage {
     THREAD_MESSAGE_ABORT_DOWNLOADING,
     THREAD_MESSAGE_SCREENSHOT,
     THREAD_MESSAGE_FILE_MANAGER_LOAD_DIRECTORY,
+    THREAD_MESSAGE_FILE_MANAGER_LOAD_DESCRIPTIONS,
+    THREAD_MESSAGE_FILE_MANAGER_LOAD_THUMBNAILS,
     THREAD_MESSAGE_FILE_MANAGER_UPLOAD_FILE,
     THREAD_MESSAGE_FILE_MANAGER_OPEN_IMAGE_FILE,
     THREAD_MESSAGE_FILE_MANAGER_OPEN_BIT_FILE,
@@ -126,6 +135,9 @@ void startHighPriorityThread();
 
 bool isPsuThread();
 void sendMessageToPsu(HighPriorityThreadMessage messageType, uint32_t messageParam = 0, uint32_t timeoutMillisec = osWaitForever);
+// Doesn't wait and (in simulator) doesn't handle message in the calling thread, use from interrupts and timers.
+// Returns false if message queue is full.
+bool postMessageToPsu(HighPriorityThreadMessage messageType, uint32_t messageParam = 0);
 
 void initLowPriorityMessageQueue();
 void startLowPriorityThread();
@@ -99,6 +99,7 @@
     VALUE_TYPE(CALIBRATION_POINT_INFO) \
     VALUE_TYPE(ZOOM) \
     VALUE_TYPE(NUM_SELECTED) \
+    VALUE_TYPE(IMAGE) \
 
 namespace eez {
 